@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "PackedCells.h"
+
+// Sets a run of cells along one row, from (x, y) to (x + length - 1, y). Edits outside the universe are clipped.
+struct CellEdit {
+    int x;
+    int y;
+    int length;
+    CellState state;
+};
+
+// Lock-free queue of edits from one producer thread to one consumer thread, such as the GUI painting cells while the
+// universe is stepped. Neither side ever waits for the other: a full queue takes what fits and the producer keeps the rest.
+class CellEditQueue {
+
+public:
+    static constexpr std::size_t defaultCapacity = std::size_t(1) << 16;
+
+    // Rounded up to a power of two.
+    explicit CellEditQueue(std::size_t capacity = defaultCapacity);
+
+    // Producer only. Returns how many of the edits were queued, always the first ones.
+    std::size_t Push(const CellEdit* edits, std::size_t numberOfEdits);
+    // Consumer only. Appends every queued edit in the order they were pushed, returns how many.
+    std::size_t PopAll(std::vector<CellEdit>&);
+
+    bool IsEmpty() const;
+
+    CellEditQueue(const CellEditQueue&) = delete;
+    CellEditQueue& operator=(const CellEditQueue&) = delete;
+
+private:
+    std::vector<CellEdit> m_edits;
+    std::size_t m_indexMask;
+
+    // Each index is only written by its own side, and kept on its own cache line so the two sides don't contend for it.
+    alignas(64) std::atomic<std::size_t> m_head;
+    alignas(64) std::atomic<std::size_t> m_tail;
+};
+
+// Paints a line of filled circles of the radius from one cell to another, radius 0 being single cells.
+void AddBrushEdits(CellCoordinates from, CellCoordinates to, int radius, CellState, std::vector<CellEdit>&);
+// Replaces the cells of the pattern's rectangle, with its top left corner at (x, y), by the pattern.
+void AddStampEdits(const PackedCells& pattern, int x, int y, std::vector<CellEdit>&);
+
+// Reads a pattern in run length encoded format, as used by Golly and the LifeWiki, returns false if it isn't one.
+// Every state other than dead is read as active.
+bool ParseRlePattern(const std::string&, PackedCells& pattern);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <vector>
+
+#include "MemoryBudget.h"
+
+// Everything that determines a generated Elementary diagram.
+struct DiagramKey {
+    int ruleNumber;
+    int numberOfCellsPerGeneration;
+    int numberOfGenerations;
+    // The initial condition is the single active cell advanced to this generation.
+    std::uint64_t startingGeneration;
+
+    bool operator<(const DiagramKey&) const;
+    bool operator==(const DiagramKey&) const;
+};
+
+// Least recently used cache of bit-packed diagrams, kept under a memory cap.
+// Under memory pressure it gives up its least recently used diagrams, before growing or when the budget needs room.
+class DiagramCache {
+
+public:
+    DiagramCache();
+
+    std::size_t GetMemoryCap() const;
+    std::size_t GetMemoryUsage() const;
+    std::size_t GetNumberOfDiagrams() const;
+
+    // Evicts the least recently used diagrams until the cache fits.
+    void SetMemoryCap(std::size_t);
+
+    // Returns false if the diagram isn't cached, otherwise it becomes the most recently used diagram.
+    bool Find(const DiagramKey&, std::vector<std::uint64_t>& packedCells);
+    void Insert(const DiagramKey&, const std::vector<std::uint64_t>& packedCells);
+    void Clear();
+
+private:
+    struct Entry {
+        DiagramKey key;
+        std::vector<std::uint64_t> compressedCells;
+    };
+
+    static std::size_t GetEntrySize(const Entry&);
+    // Evicts until the cache holds no more than the memory limit.
+    void EvictLeastRecentlyUsed(std::size_t memoryLimit);
+
+    // Most recently used diagram first.
+    std::list<Entry> m_entries;
+    std::map<DiagramKey, std::list<Entry>::iterator> m_entryLookup;
+
+    std::size_t m_memoryCap;
+    std::size_t m_memoryUsage;
+    MemoryAccount m_memoryAccount;
+};
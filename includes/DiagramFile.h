@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ElementaryKernel.h"
+#include "MemoryBudget.h"
+#include "PackedCells.h"
+
+// An Elementary diagram kept in a memory-mapped file instead of memory, for diagrams such as 1M cells by 1M generations (125 GB).
+// Generations are computed on a background task and streamed to the file a block of rows at a time, one bit per cell.
+// Each block is split into tiles of whole rows and a range of words, optionally compressed with CompressWords,
+// and a tile index after the header locates every tile. Reading a row only touches the tiles it overlaps,
+// so a viewer pages in just the visible region, and rows can be read while later ones are still being generated.
+// Opening a file only maps it, and an unfinished diagram carries on from its last complete block. Only available on Linux.
+//
+// Rows may be read from one thread while the file generates in the background, everything else has to be called from that thread.
+class DiagramFile {
+
+public:
+    DiagramFile();
+    ~DiagramFile();
+
+    static bool IsSupported();
+
+    // Overwrites the file, the first generation is initialGeneration. Compressed diagrams store mostly empty space much smaller,
+    // but reading a row decompresses the tiles it overlaps.
+    bool Create(const std::string& path, int ruleNumber, std::uint64_t startingGeneration, const std::vector<CellState>& initialGeneration,
+        std::uint64_t numberOfGenerations, bool isCompressed);
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const;
+
+    int GetRuleNumber() const;
+    std::uint64_t GetStartingGeneration() const;
+    int GetNumberOfCellsPerGeneration() const;
+    int GetWordsPerRow() const;
+    std::uint64_t GetNumberOfGenerations() const;
+    std::uint64_t GetNumberOfCompletedGenerations() const;
+    bool IsCompressed() const;
+    // Bytes of the file holding generated tiles so far.
+    std::uint64_t GetFileSize() const;
+
+    // Computes the remaining generations on a background task. Returns false if the file is complete or can't be written.
+    bool StartGenerating();
+    void StopGenerating();
+    bool IsGenerating() const;
+    // Generated cells of the running or last task, in bytes of packed rows per second.
+    double GetGenerationRate() const;
+
+    // Copies words [firstWord, firstWord + numberOfWords) of a generation's row, returns false if it hasn't been generated.
+    bool ReadRow(std::uint64_t generation, int firstWord, int numberOfWords, std::uint64_t* words);
+
+    // Decompressed tiles are kept for reading under this cap, 64 MB by default. They're counted against the memory budget,
+    // which evicts them to make room for other accounts.
+    void SetDecompressedTileCap(std::size_t);
+
+    DiagramFile(const DiagramFile&) = delete;
+    DiagramFile& operator=(const DiagramFile&) = delete;
+
+private:
+    // Starts the file, all in host byte order.
+    struct FileHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::int32_t ruleNumber;
+        std::uint64_t startingGeneration;
+        std::uint64_t numberOfGenerations;
+        std::uint64_t completedGenerations;
+        std::uint64_t dataEnd;
+        std::int32_t numberOfCellsPerGeneration;
+        std::uint32_t rowsPerBlock;
+        std::uint32_t wordsPerTile;
+        std::uint32_t isCompressed;
+    };
+
+    struct TileIndexEntry {
+        std::uint64_t offset;
+        std::uint32_t numberOfWords;
+        std::uint32_t isCompressed;
+    };
+
+    // Derives where everything is in the file from m_header.
+    void ComputeLayout();
+    // Maps the whole file, reserving room for every tile first when it isn't complete.
+    bool MapFile(bool isWritable);
+    const TileIndexEntry& GetTileIndexEntry(std::uint64_t block, int tileColumn) const;
+    // Whether every tile of the complete blocks lies within the generated data, and uncompressed tiles are the size of their rows,
+    // so a truncated or corrupt file is refused when it's opened instead of being read past its end.
+    bool IsTileIndexValid() const;
+    // Rows of the block by words of the tile, row-major. Returns null if a compressed tile doesn't decompress to exactly that.
+    const std::uint64_t* GetTile(std::uint64_t block, int tileColumn);
+    // Evicts the least recently read tiles until no more than the memory limit are kept, except the most recent one.
+    void EvictDecompressedTiles(std::size_t memoryLimit);
+
+    void Generate(std::vector<std::uint64_t> previousRow);
+    bool WriteBlock(std::uint64_t block, const std::vector<std::uint64_t>& rows, std::vector<std::uint64_t>& storedWords);
+
+    int m_file;
+    void* m_mapping;
+    std::size_t m_mappingSize;
+    bool m_isWritable;
+
+    // Only updated by the generating task while it runs.
+    FileHeader m_header;
+    int m_wordsPerRow;
+    int m_tilesPerBlock;
+    std::uint64_t m_numberOfBlocks;
+    std::uint64_t m_indexOffset;
+    std::uint64_t m_initialRowOffset;
+    std::uint64_t m_dataOffset;
+
+    std::atomic<std::uint64_t> m_completedGenerations;
+    std::atomic<std::uint64_t> m_dataEnd;
+    std::atomic<double> m_generationRate;
+    std::atomic<bool> m_isCancelled;
+    std::future<void> m_generation;
+    // Only used by the generating task.
+    ElementaryRowStepper m_rowStepper;
+
+    // Most recently read first, only used by the reading thread.
+    std::list<std::pair<std::uint64_t, std::vector<std::uint64_t>>> m_decompressedTiles;
+    std::unordered_map<std::uint64_t, std::list<std::pair<std::uint64_t, std::vector<std::uint64_t>>>::iterator> m_decompressedTileLookup;
+    std::size_t m_decompressedTileCap;
+    std::size_t m_decompressedTileSize;
+    MemoryAccount m_memoryAccount;
+};
@@ -1,46 +1,128 @@
 #pragma once
 
+#include <atomic>
 #include <bitset>
-#include <map>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
-#include "Grid.h"
-#include "imgui.h"
+#include "DiagramCache.h"
+#include "DiagramFile.h"
+#include "ElementaryKernel.h"
+#include "MemoryBudget.h"
+#include "PackedCells.h"
 
-#include "Extensions.h"
-
-enum class CellState : bool {
-    inactive = false,
-    active = true
-};
-
-class Elementary : public Grid {
+// Elementary cellular automaton diagrams, one row of cells per generation starting from a single active cell.
+class Elementary {
 
 public:
     Elementary();
+    ~Elementary();
 
-    const std::map<ImVec2, CellState>& GetCellMap() const;
     int GetNumberOfCellsPerGeneration() const;
     int GetNumberOfGenerations() const;
-    CellState GetCellState(ImVec2) const;
+    CellState GetCellState(int position, int generation) const;
+    std::uint64_t GetStartingGeneration() const;
+    DiagramCache& GetDiagramCache();
+
+    // Wolfram rule number, i.e. m_ruleset read in reverse.
+    int GetRuleNumber() const;
+
+    // Additive rules are XOR combinations of the left, centre and right cells (e.g. 90, 150, 60, 102) and their complements.
+    bool IsAdditiveRule() const;
 
     std::bitset<8>& SetRuleset();
-    void SetNumberOfCellsPerGeneration(int);
-    void SetNumberOfGenerations(int);
-    bool SetSingleCellState(ImVec2, CellState);
+    // Both return false without changing anything if the number isn't positive, or the diagram would go over the memory budget
+    // along with the current one, which is kept until the new one is computed.
+    bool SetNumberOfCellsPerGeneration(int);
+    bool SetNumberOfGenerations(int);
+    bool SetSingleCellState(int position, int generation, CellState);
+    void SetStartingGeneration(std::uint64_t);
+
+    // Generation t of a single active cell, computed in O(width * log t) for additive rules.
+    // Other rules fall back to simulating all t generations.
+    std::vector<CellState> ComputeGeneration(std::uint64_t) const;
 
     void GenerateCells(CellState);
 
+    // Starts a diagram of the current rule and starting generation in a file, for diagrams too large for memory.
+    // Its generations are computed once the file starts generating, see DiagramFile.
+    bool CreateDiagramFile(DiagramFile&, const std::string& path, int numberOfCellsPerGeneration, std::uint64_t numberOfGenerations, bool isCompressed) const;
+
     void SetAllCellStates();
 
-    void DrawCells() override;
+    // The cells to show, one row per generation. While a preview is running these are the preview's cells,
+    // and only its first GetNumberOfComputedGenerations() rows are complete.
+    const PackedCells& GetCells() const;
+    int GetNumberOfComputedGenerations() const;
+    // The computed generations of GetCells() without copying them, one row per generation. Valid until the cells next change,
+    // see GetCellsVersion, and a running preview only ever adds rows after these.
+    PackedCellsView GetCellsView() const;
+    // Changes whenever GetCells() does, apart from a running preview completing more generations.
+    std::uint64_t GetCellsVersion() const;
 
     void GenerateElementaryAutomata();
 
+    // Call once per frame. Whenever the rule, width or number of generations changes, the diagram is regenerated on a background task,
+    // cancelling any stale one. Generations are drawn as soon as they're computed.
+    void UpdatePreview();
+    bool IsPreviewRunning() const;
+    // Fraction of the running preview's generations that have been computed.
+    float GetPreviewProgress() const;
+
+    static constexpr std::uint64_t maximumStartingGeneration = std::uint64_t(1) << 40;
+
+    Elementary(const Elementary&) = delete;
+    Elementary& operator=(const Elementary&) = delete;
+
 private:
-    std::map<ImVec2, CellState> m_cellMap;
+    std::vector<CellState> GetInitialGeneration(int numberOfCellsPerGeneration) const;
+    std::vector<CellState> ComputeGeneration(std::uint64_t, int numberOfCellsPerGeneration) const;
+    std::vector<CellState> StepGeneration(const std::vector<CellState>&) const;
+
+    // Computes every generation from firstGeneration onwards, earlier generations are left untouched.
+    void SetCellStatesFrom(int firstGeneration);
+
+    // Key of the diagram that would be generated right now.
+    DiagramKey GetCurrentKey() const;
+    // Same rule, width and initial condition, possibly a different number of generations.
+    bool IsGeneratedDiagramExtendableTo(const DiagramKey&) const;
+    void CancelPreview();
+    // The diagram and any preview being computed, whose cells are all allocated up front.
+    void UpdateMemoryUsage();
+    // Whether a diagram of these dimensions fits in the memory budget along with the current diagram.
+    bool ReserveDiagram(int numberOfCellsPerGeneration, int numberOfGenerations);
+
+    // Shared with the background task, which only writes generations at or past completedGenerations.
+    struct PreviewJob {
+        DiagramKey key;
+        PackedCells cells;
+        std::atomic<int> completedGenerations;
+        std::atomic<bool> isCancelled;
+    };
+
+    PackedCells m_cells;
     std::bitset<8> m_ruleset;
 
+    // The diagram m_cells currently holds, a rule number of -1 means the cells were edited by hand.
+    DiagramKey m_generatedKey;
+    std::uint64_t m_cellsVersion;
+
     int m_numberOfCellsPerGeneration;
     int m_numberOfGenerations;
+    std::uint64_t m_startingGeneration;
+
+    DiagramCache m_diagramCache;
+    MemoryAccount m_memoryAccount;
+
+    // Shared by every preview, declared before the previews so that it outlives them.
+    ElementaryRowStepper m_rowStepper;
+
+    std::shared_ptr<PreviewJob> m_previewJob;
+    std::future<void> m_previewFuture;
+    // Destroying a std::async future waits for its task, so cancelled tasks are kept until they've noticed.
+    std::vector<std::future<void>> m_cancelledPreviews;
 };
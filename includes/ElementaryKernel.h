@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "WorkerPool.h"
+
+// Computes the generation after previous a word at a time, with a Wolfram rule number and cells outside the row inactive.
+// Rows are packed like PackedCells rows, lastWordMask clears the padding bits of the last word.
+void StepElementaryRow(const std::uint64_t* previous, std::uint64_t* next, int wordsPerRow, std::uint64_t lastWordMask, int ruleNumber);
+
+// Steps rows too wide for one core with a pool of threads, each owning a chunk of words of every row.
+// A chunk is stepped from a copy of itself with a one word halo on either side, and since a cell only depends on cells
+// one position away per generation, the halo keeps the chunk exact for 64 generations. Threads then only wait for each other
+// once per 64 generations, when the next copies are taken, at the cost of stepping two extra words per chunk.
+// Rows narrower than a few chunks are stepped on the calling thread. Calls from several threads take turns.
+class ElementaryRowStepper {
+
+public:
+    // Zero threads is one per hardware thread.
+    explicit ElementaryRowStepper(int numberOfThreads = 0);
+    ~ElementaryRowStepper();
+
+    int GetNumberOfThreads() const;
+
+    // Computes the numberOfRows generations after previous into rows, one after the other like StepElementaryRow.
+    void StepRows(const std::uint64_t* previous, std::uint64_t* rows, int numberOfRows, int wordsPerRow, std::uint64_t lastWordMask, int ruleNumber);
+
+    ElementaryRowStepper(const ElementaryRowStepper&) = delete;
+    ElementaryRowStepper& operator=(const ElementaryRowStepper&) = delete;
+
+private:
+    // Its threads are only started once rows are wide enough for several chunks.
+    WorkerPool m_workerPool;
+    // Each chunk's copy and the generation after it.
+    std::vector<std::vector<std::uint64_t>> m_chunkRows;
+    std::mutex m_stepMutex;
+};
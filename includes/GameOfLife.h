@@ -1,13 +1,21 @@
 #pragma once
-#include "Elementary.h"
 
 #include <bitset>
-#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
-#include "Grid.h"
-#include "imgui.h"
+#include "CellEdits.h"
+#include "LargerThanLife.h"
+#include "LifeEngines.h"
+#include "LifeHistory.h"
+#include "LifeKernel.h"
+#include "MemoryBudget.h"
+#include "PackedCells.h"
+#include "SlabWorkers.h"
 
 enum class Pattern : int {
     R_Pentomino = 0,
@@ -15,31 +23,124 @@ enum class Pattern : int {
     Infinite_Growth = 2
 };
 
-class GameOfLife : public Grid {
+class GameOfLife {
 
 public:
     GameOfLife();
 
-    ImVec2 GetGameDimensions();
-    void SetGameDimensions(ImVec2);
+    int GetWidth() const;
+    int GetHeight() const;
 
-    std::map<ImVec2, CellState>& GetCellMap();
+    // Resizes the universe in place, cells inside both the old and new dimensions keep their state.
+    // Returns false without changing anything if the new dimensions aren't valid or don't fit in the memory budget.
+    bool SetGameDimensions(int width, int height);
 
-    CellState GetCellState(ImVec2);
+    // The current generation without copying it, valid until the universe next changes.
+    PackedCellsView GetCellsView() const;
+
+    CellState GetCellState(int x, int y) const;
 
     void GenerateEmptyCells();
     void GenerateRandomCells();
     void GeneratePattern(Pattern);
 
-    bool SetSingleCellState(ImVec2, CellState);
+    bool SetSingleCellState(int x, int y, CellState);
+
+    // Edits from another thread, or painted while the universe runs. They're applied together between generations,
+    // before each step and by ApplyQueuedEdits, so a generation is never edited part way through. Only one thread may push.
+    CellEditQueue& GetEditQueue();
+    // Returns false if there were no edits queued.
+    bool ApplyQueuedEdits();
 
+    // Advances the universe by the number of generations per frame, after applying any queued edits.
     void SetAllCellStates();
 
-    void DrawCells() override;
+    // Conway's Game of Life until set otherwise.
+    void SetRule(const LifeRule&);
+    const LifeRule& GetRule() const;
+
+    // Steps the universe with a Larger than Life rule instead of the Life-like one while enabled.
+    // It's always stepped in this process, so any worker processes sit idle.
+    // Both return false without changing anything if the rule's sums don't fit in the memory budget while it's stepped.
+    bool SetLargerThanLife(bool);
+    bool IsLargerThanLife() const;
+    // Bosco's rule until set otherwise.
+    bool SetLargerThanLifeRule(const LargerThanLifeRule&);
+    const LargerThanLifeRule& GetLargerThanLifeRule() const;
+
+    // Current generation, row-major with GetWordsPerRow() words per row and one bit per cell.
+    // The worker processes hold the current generation while they're running, m_cells is then only a copy made for editing.
+    const std::uint64_t* GetCurrentWords() const;
+    int GetWordsPerRow() const;
+    // Changes whenever the current generation's cells do, so a view can tell when it has to read them again.
+    std::uint64_t GetCellsVersion() const;
+
+    // Several generations per frame let universes too large for the cache be temporally blocked, see StepLifeGenerationsBlocked.
+    void SetGenerationsPerFrame(int);
+    int GetGenerationsPerFrame() const;
+
+    // Chooses how the universe is stepped in this process. It's tuned again whenever the size, rule, pattern or steps per frame change.
+    LifeEngineTuner& GetEngineTuner();
+
+    std::uint64_t GetGeneration() const;
+    void SetPaused(bool);
+    bool IsPaused() const;
 
-    void GenerateGameOfLife();
+    // While recording, every generation is kept in the history so the universe can be rewound to it.
+    // Returns false without starting to record if the history's copies of the universe don't fit in the memory budget.
+    bool SetRecordingHistory(bool);
+    bool IsRecordingHistory() const;
+    const LifeHistory& GetHistory() const;
+    void SetHistoryMemoryBudget(std::size_t);
+    // Returns false if the generation isn't in the history.
+    bool SeekGeneration(std::uint64_t);
+
+    // Splits the universe into horizontal slabs, each stepped by its own worker process. One process steps the universe in this process.
+    // The workers' shared buffers are counted against the memory budget too.
+    bool SetNumberOfWorkerProcesses(int, bool isPinnedToCpus);
+    int GetNumberOfWorkerProcesses() const;
+    int GetNumberOfWorkerRestarts() const;
+
+    GameOfLife(const GameOfLife&) = delete;
+    GameOfLife& operator=(const GameOfLife&) = delete;
 
 private:
-    std::map<ImVec2, CellState> m_cellMap;
-    ImVec2 m_gridDimensions;
+    void FetchCellsFromWorkers();
+    void PublishCellsToWorkers();
+    void ApplyEdits(const std::vector<CellEdit>&);
+    void StepGenerations(int);
+    void RecordHistory();
+    // Both generations, the edit tiles and queue, the workers' two shared buffers while they're used,
+    // and the sums of the Larger than Life rule if one is stepped.
+    std::size_t EstimateMemoryUsage(int width, int height, bool isUsingWorkers, const LargerThanLifeRule* steppedLargerThanLifeRule) const;
+    // Whether the universe can grow to that usage, along with the growth of the history's copies of the universe while recording,
+    // which the history counts itself.
+    bool ReserveMemory(std::size_t usage, int width, int height, bool isRecordingHistory);
+    const LargerThanLifeRule* GetSteppedLargerThanLifeRule() const;
+    void UpdateMemoryUsage();
+
+    PackedCells m_cells;
+    // Next generation is written here and then swapped with m_cells, so the buffer is reused between generations.
+    PackedCells m_nextCells;
+    LifeRule m_rule;
+    bool m_isLargerThanLife;
+    LargerThanLifeRule m_largerThanLifeRule;
+    int m_generationsPerFrame;
+    LifeEngineTuner m_engineTuner;
+
+    std::uint64_t m_generation;
+    std::uint64_t m_cellsVersion;
+    bool m_isPaused;
+    bool m_isRecordingHistory;
+    LifeHistory m_history;
+
+    std::unique_ptr<SlabWorkers> m_slabWorkers;
+    bool m_isPinnedToCpus;
+
+    CellEditQueue m_editQueue;
+    std::vector<CellEdit> m_queuedEdits;
+    // One flag per editTileSize square tile, set for the tiles the edits being applied touch.
+    std::vector<std::uint8_t> m_editedTiles;
+
+    MemoryAccount m_memoryAccount;
 };
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "LifeKernel.h"
+#include "MemoryBudget.h"
+#include "PackedCells.h"
+
+// Generations rule, a Life-like rule whose cells don't die straight away but decay through refractory states first.
+// State 0 is dead and state 1 alive, and only live cells count as neighbours. A dead cell is born as in the Life-like rule,
+// a live cell that doesn't survive moves to state 2, and each state after that moves to the next, with the last back to dead.
+struct GenerationsRule {
+    std::uint16_t birth;
+    std::uint16_t survival;
+    int numberOfStates;
+
+    static constexpr int maximumNumberOfStates = 16;
+
+    // B2/S/C3.
+    static GenerationsRule BriansBrain();
+    // B2/S345/C4.
+    static GenerationsRule StarWars();
+    // Reads rules in B/S/C notation such as "B2/S345/C4", returns false if the string isn't one. Two states is a Life-like rule.
+    static bool Parse(const std::string&, GenerationsRule&);
+    std::string ToString() const;
+
+    // Bits needed for every state.
+    int GetNumberOfPlanes() const;
+
+    bool operator==(const GenerationsRule&) const;
+    bool operator!=(const GenerationsRule&) const;
+};
+
+// A universe of a Generations rule. Each cell's state is split over bit planes, plane p holding bit p of every cell's state
+// packed like PackedCells, so 1 to 4 bits per cell. A generation finds the live cells, steps them with the Life-like kernel,
+// and then updates every plane with bitwise logic 64 cells at a time.
+class Generations {
+
+public:
+    Generations();
+    Generations(int width, int height);
+
+    int GetWidth() const;
+    int GetHeight() const;
+    // Resizes the universe in place, cells inside both the old and new dimensions keep their state.
+    // Returns false without changing anything if the new dimensions aren't valid or don't fit in the memory budget.
+    bool SetDimensions(int width, int height);
+
+    // Brian's Brain until set otherwise. Cells in states the new rule doesn't have become dead.
+    // Returns false if the rule isn't valid or its extra planes don't fit in the memory budget.
+    bool SetRule(const GenerationsRule&);
+    const GenerationsRule& GetRule() const;
+
+    // Cells outside the universe are dead.
+    int GetCellState(int x, int y) const;
+    bool SetCellState(int x, int y, int state);
+
+    void GenerateEmptyCells();
+    // About a quarter of the cells alive.
+    void GenerateRandomCells();
+
+    // Plane p of the current generation, see GetRule().GetNumberOfPlanes().
+    const PackedCells& GetPlane(int plane) const;
+    // Sets the cells in a state and clears the rest, cells must have the universe's dimensions.
+    void GetCellsInState(int state, PackedCells& cells) const;
+
+    void Step();
+
+    std::uint64_t GetGeneration() const;
+    // Changes whenever the cells do.
+    std::uint64_t GetCellsVersion() const;
+
+private:
+    // Every plane and the live cells before and after stepping.
+    static std::size_t EstimateMemoryUsage(int width, int height, int numberOfPlanes);
+
+    int m_width;
+    int m_height;
+    GenerationsRule m_rule;
+    std::vector<PackedCells> m_planes;
+
+    // Live cells of the current generation, and the cells the Life-like rule would make live.
+    PackedCells m_liveCells;
+    PackedCells m_nextLiveCells;
+
+    std::uint64_t m_generation;
+    std::uint64_t m_cellsVersion;
+
+    MemoryAccount m_memoryAccount;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "PackedCells.h"
+
+// Larger than Life rule, counting the active cells in the (2 * radius + 1) square around each cell. A dead cell is born when the count
+// is within the birth range and a live cell survives when it's within the survival range, both inclusive.
+struct LargerThanLifeRule {
+    int radius;
+    int birthMinimum;
+    int birthMaximum;
+    int survivalMinimum;
+    int survivalMaximum;
+    // Whether a cell counts itself.
+    bool isCentreCounted;
+
+    // Counts up to (2 * maximumRadius + 1)^2 fit in 16 bits.
+    static constexpr int maximumRadius = 127;
+
+    // Bosco's rule, R5,C0,M1,S34..58,B34..45,NM.
+    static LargerThanLifeRule Bosco();
+    // Reads rules in Golly's notation such as "R5,C0,M1,S34..58,B34..45,NM", returns false if the string isn't one.
+    // Only two states (C0 or C2) and the Moore neighbourhood (NM) are supported, C, M and N may be left out.
+    static bool Parse(const std::string&, LargerThanLifeRule&);
+    std::string ToString() const;
+
+    bool operator==(const LargerThanLifeRule&) const;
+    bool operator!=(const LargerThanLifeRule&) const;
+};
+
+// Steps cells by one generation of a Larger than Life rule into next, which has the same dimensions. Cells outside the grid are inactive.
+// Each row's counts come from sliding sums along the row, which are then slid down the columns, so a cell costs the same whatever the radius.
+// The rows are split into bands stepped on separate threads.
+void StepLargerThanLife(const PackedCells& cells, PackedCells& next, const LargerThanLifeRule&);
+// Memory the bands' sliding sums take while stepping cells of these dimensions, which grows with the radius.
+std::size_t EstimateLargerThanLifeMemoryUsage(int width, int height, const LargerThanLifeRule&);
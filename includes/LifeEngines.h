@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "LifeKernel.h"
+#include "PackedCells.h"
+
+// A way of stepping a Game of Life universe. Every engine computes exactly the same generations, cells outside the universe
+// are always inactive, and only their speed differs, which depends on the universe's size and density and on the CPU.
+class LifeEngine {
+
+public:
+    virtual ~LifeEngine() = default;
+
+    virtual const char* GetName() const = 0;
+
+    // Advances cells by a number of generations. Scratch has the same dimensions as cells, and the two may be swapped.
+    virtual void Step(PackedCells& cells, PackedCells& scratch, int generations, const LifeRule& rule) = 0;
+};
+
+// Every engine there is, the cell by cell reference first.
+std::vector<std::unique_ptr<LifeEngine>> CreateLifeEngines();
+
+// Steps with the fastest engine for the universe. Every engine is first timed on a small corner of the universe,
+// and the ones within reach of the fastest are then timed on the whole universe during the next few steps,
+// which step the universe anyway, before the fastest of those is kept.
+class LifeEngineTuner {
+
+public:
+    LifeEngineTuner();
+
+    int GetNumberOfEngines() const;
+    const char* GetEngineName(int engine) const;
+    // Cells stepped per second, from the whole universe if IsMeasuredOnWholeUniverse, zero until measured.
+    double GetThroughput(int engine) const;
+    bool IsMeasuredOnWholeUniverse(int engine) const;
+
+    // The engine that steps, whether chosen or tuned.
+    int GetSelectedEngine() const;
+    bool IsTuning() const;
+    // Always steps with this engine, -1 goes back to choosing the fastest.
+    void SetOverride(int engine);
+    int GetOverride() const;
+
+    // Times the engines again before the next step, for when the universe's size, density or rule change.
+    void Retune();
+
+    void Step(PackedCells& cells, PackedCells& scratch, int generations, const LifeRule& rule);
+
+    LifeEngineTuner(const LifeEngineTuner&) = delete;
+    LifeEngineTuner& operator=(const LifeEngineTuner&) = delete;
+
+private:
+    void TimeOnCorner(const PackedCells& cells, const LifeRule& rule);
+
+    std::vector<std::unique_ptr<LifeEngine>> m_engines;
+    std::vector<double> m_throughputs;
+    std::vector<bool> m_isMeasuredOnWholeUniverse;
+
+    // Engines still to be timed on the whole universe, the last one steps next.
+    std::vector<int> m_candidates;
+    bool m_isRetuneNeeded;
+    int m_selectedEngine;
+    int m_override;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "MemoryBudget.h"
+#include "PackedCells.h"
+
+// 64 independent Game of Life universes of the same size, bit-sliced so bit n of every word belongs to universe n.
+// A word holds one cell of every universe, so all of them are stepped at once by the same bitwise adders.
+class LifeEnsemble {
+public:
+    static constexpr int numberOfLanes = 64;
+    // A universe is stable once it repeats with a period that divides this, which covers still lifes and the common oscillators.
+    static constexpr int stabilizationPeriod = 12;
+
+    LifeEnsemble();
+    LifeEnsemble(int width, int height);
+
+    // The last generations every ensemble of these dimensions keeps.
+    static std::size_t EstimateMemoryUsage(int width, int height);
+
+    int GetWidth() const;
+    int GetHeight() const;
+    int GetGeneration() const;
+
+    CellState GetCellState(int lane, int x, int y) const;
+    bool SetCellState(int lane, int x, int y, CellState);
+
+    // Fills every universe with its own random soup, density is the chance of a cell being active in 1/256 steps.
+    void GenerateRandomSoups(std::uint64_t seed, int densityIn256ths = 128);
+
+    void Step();
+    // Steps until every universe is stable or the maximum generation is reached.
+    void StepUntilStable(int maximumGeneration);
+
+    std::array<int, numberOfLanes> GetPopulations() const;
+    // First generation each universe repeats from, -1 while it hasn't been found stable.
+    const std::array<int, numberOfLanes>& GetStabilizationGenerations() const;
+    bool IsEveryLaneStable() const;
+
+private:
+    std::uint64_t* GetGenerationWords(int generation);
+    const std::uint64_t* GetGenerationWords(int generation) const;
+
+    int m_width;
+    int m_height;
+    int m_generation;
+
+    // The last stabilizationPeriod + 1 generations, each with a border of inactive cells so stepping needs no bounds checks.
+    std::vector<std::uint64_t> m_history;
+    std::uint64_t m_stableLanes;
+    std::array<int, numberOfLanes> m_stabilizationGenerations;
+};
+
+// Lifetimes of many random soups, stepped numberOfLanes at a time on every hardware thread.
+struct SoupSweepResult {
+    // False without running any soups if the results and every thread's ensemble don't fit in the memory budget.
+    bool isRun;
+    int numberOfSoups;
+    int numberOfUnstableSoups;
+    std::vector<int> stabilizationGenerations;
+    std::vector<int> finalPopulations;
+    double seconds;
+    // Counts the results against the memory budget for as long as they're kept.
+    std::unique_ptr<MemoryAccount> memoryAccount;
+};
+
+SoupSweepResult RunSoupSweep(int width, int height, int numberOfSoups, int maximumGeneration, std::uint64_t seed, int densityIn256ths = 128);
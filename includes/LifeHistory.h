@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "MemoryBudget.h"
+#include "PackedCells.h"
+
+// Every recorded generation of a universe, so it can be rewound to any of them.
+// A compressed keyframe is kept every keyframeInterval generations, and each generation in between is kept as the compressed
+// xor of it and the generation two before, bit by bit when only a few cells changed and word by word otherwise.
+// Once over the memory budget, the oldest keyframe and its deltas are dropped. The same happens when the global memory
+// budget needs room, whatever the history's own budget.
+class LifeHistory {
+public:
+    static constexpr int keyframeInterval = 64;
+
+    LifeHistory();
+
+    // Generations have to be recorded in order, anything else starts the history over from that generation.
+    void Record(std::uint64_t generation, const std::uint64_t* words, int width, int height);
+    // Forgets every generation after this one.
+    void Truncate(std::uint64_t lastGeneration);
+    // Also frees the copies of the last two generations.
+    void Clear();
+
+    bool IsEmpty() const;
+    std::uint64_t GetFirstGeneration() const;
+    std::uint64_t GetLastGeneration() const;
+
+    // Decodes from the nearest keyframe at or before the generation, false if it isn't recorded.
+    bool Seek(std::uint64_t generation, PackedCells&) const;
+
+    std::size_t GetMemoryBudget() const;
+    // The compressed generations and the uncompressed copies of the last two, which the next delta is taken against.
+    std::size_t GetMemoryUsage() const;
+    // The copies are the size of the universe and can't be dropped, so whatever resizes the universe reserves them up front.
+    static std::size_t EstimateCopiesSize(int width, int height);
+    std::size_t GetCopiesSize() const;
+    // Drops the oldest generations until the history fits, the latest keyframe and its deltas are always kept.
+    void SetMemoryBudget(std::size_t);
+
+private:
+    // Only one of the two is used.
+    struct Delta {
+        std::vector<std::uint64_t> compressedWords;
+        std::vector<std::uint8_t> compressedBits;
+    };
+
+    struct Segment {
+        std::vector<std::uint64_t> keyframe;
+        std::vector<Delta> deltas;
+    };
+
+    static std::size_t GetSegmentSize(const Segment&);
+    // Drops segments until the history uses no more than the memory limit, or only the latest is left.
+    void DropOldestSegments(std::size_t memoryLimit);
+
+    std::deque<Segment> m_segments;
+    std::uint64_t m_firstGeneration;
+    int m_width;
+    int m_height;
+
+    // Uncompressed copies of the last two generations, which the next delta is taken against.
+    PackedCells m_lastCells;
+    PackedCells m_secondLastCells;
+
+    std::size_t m_memoryBudget;
+    std::size_t m_memoryUsage;
+    MemoryAccount m_memoryAccount;
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "PackedCells.h"
+#include "WorkerPool.h"
+
+// Life-like rule, bit n of birth and survival is set when n neighbours give birth to or keep alive a cell.
+struct LifeRule {
+    std::uint16_t birth;
+    std::uint16_t survival;
+
+    static LifeRule Conway();
+    // Reads rules in B/S notation such as "B3/S23", returns false if the string isn't one.
+    static bool Parse(const std::string&, LifeRule&);
+    std::string ToString() const;
+
+    bool operator==(const LifeRule&) const;
+    bool operator!=(const LifeRule&) const;
+};
+
+// Conway's Game of Life for 64 cells at once, each argument holds the same neighbour of all 64 cells.
+// The neighbour counts are summed with bitwise adders, so each bit is independent of the others.
+inline std::uint64_t NextLifeWord(std::uint64_t aboveLeft, std::uint64_t aboveCentre, std::uint64_t aboveRight,
+    std::uint64_t middleLeft, std::uint64_t middleCentre, std::uint64_t middleRight,
+    std::uint64_t belowLeft, std::uint64_t belowCentre, std::uint64_t belowRight)
+{
+    // Each row's neighbours summed into a two bit number.
+    const std::uint64_t aboveOnes = aboveLeft ^ aboveCentre ^ aboveRight;
+    const std::uint64_t aboveTwos = (aboveLeft & aboveCentre) | (aboveRight & (aboveLeft ^ aboveCentre));
+    const std::uint64_t belowOnes = belowLeft ^ belowCentre ^ belowRight;
+    const std::uint64_t belowTwos = (belowLeft & belowCentre) | (belowRight & (belowLeft ^ belowCentre));
+    const std::uint64_t middleOnes = middleLeft ^ middleRight;
+    const std::uint64_t middleTwos = middleLeft & middleRight;
+
+    const std::uint64_t ones = aboveOnes ^ belowOnes ^ middleOnes;
+    const std::uint64_t onesCarry = (aboveOnes & belowOnes) | (middleOnes & (aboveOnes ^ belowOnes));
+
+    // The count is 2 or 3 exactly when one of the four twos is set.
+    const std::uint64_t twosParity = aboveTwos ^ belowTwos ^ middleTwos ^ onesCarry;
+    const std::uint64_t twosPairs = (aboveTwos & belowTwos) | (aboveTwos & middleTwos) | (aboveTwos & onesCarry)
+        | (belowTwos & middleTwos) | (belowTwos & onesCarry) | (middleTwos & onesCarry);
+    const std::uint64_t twoOrThree = twosParity & ~twosPairs;
+
+    // Three neighbours gives birth or survival, two neighbours only survival.
+    return twoOrThree & (ones | middleCentre);
+}
+
+// Any Life-like rule for 64 cells at once. The neighbour count is summed into four bit planes, then each count the rule uses is matched.
+inline std::uint64_t NextLifeLikeWord(std::uint64_t aboveLeft, std::uint64_t aboveCentre, std::uint64_t aboveRight,
+    std::uint64_t middleLeft, std::uint64_t middleCentre, std::uint64_t middleRight,
+    std::uint64_t belowLeft, std::uint64_t belowCentre, std::uint64_t belowRight, const LifeRule& rule)
+{
+    const std::uint64_t aboveOnes = aboveLeft ^ aboveCentre ^ aboveRight;
+    const std::uint64_t aboveTwos = (aboveLeft & aboveCentre) | (aboveRight & (aboveLeft ^ aboveCentre));
+    const std::uint64_t belowOnes = belowLeft ^ belowCentre ^ belowRight;
+    const std::uint64_t belowTwos = (belowLeft & belowCentre) | (belowRight & (belowLeft ^ belowCentre));
+    const std::uint64_t middleOnes = middleLeft ^ middleRight;
+    const std::uint64_t middleTwos = middleLeft & middleRight;
+
+    const std::uint64_t ones = aboveOnes ^ belowOnes ^ middleOnes;
+    const std::uint64_t onesCarry = (aboveOnes & belowOnes) | (middleOnes & (aboveOnes ^ belowOnes));
+
+    // Four bits of weight two summed into the twos, fours and eights planes.
+    const std::uint64_t aboveBelowTwos = aboveTwos ^ belowTwos;
+    const std::uint64_t aboveBelowFours = aboveTwos & belowTwos;
+    const std::uint64_t middleCarryTwos = middleTwos ^ onesCarry;
+    const std::uint64_t middleCarryFours = middleTwos & onesCarry;
+    const std::uint64_t twos = aboveBelowTwos ^ middleCarryTwos;
+    const std::uint64_t twosCarry = aboveBelowTwos & middleCarryTwos;
+    const std::uint64_t fours = aboveBelowFours ^ middleCarryFours ^ twosCarry;
+    const std::uint64_t eights = (aboveBelowFours & middleCarryFours) | (twosCarry & (aboveBelowFours ^ middleCarryFours));
+
+    std::uint64_t result = 0;
+    for (int count = 0; count <= 8; ++count) {
+        const bool isBirth = (rule.birth >> count) & 1;
+        const bool isSurvival = (rule.survival >> count) & 1;
+        if (!isBirth && !isSurvival)
+            continue;
+
+        const std::uint64_t isCount = ((count & 1) ? ones : ~ones) & ((count & 2) ? twos : ~twos)
+            & ((count & 4) ? fours : ~fours) & ((count & 8) ? eights : ~eights);
+        result |= isCount & ((isBirth ? ~middleCentre : 0) | (isSurvival ? middleCentre : 0));
+    }
+
+    return result;
+}
+
+// Steps rows [firstRow, lastRow) of a row-major, one bit per cell grid by one generation of a Life-like rule, Conway's Game of Life by default.
+// Both buffers hold height rows of wordsPerRow words, cells outside the grid are always inactive.
+void StepLifeRows(const std::uint64_t* current, std::uint64_t* next, int wordsPerRow, int height, std::uint64_t lastWordMask, int firstRow, int lastRow,
+    const LifeRule& rule = LifeRule::Conway());
+
+// Advances cells by several generations with temporal blocking. The grid is cut into tiles sized for the per core cache,
+// and each tile is advanced as many generations as its ghost zones allow while it's still in cache. Scratch is the second buffer.
+// The tiles of a block of generations don't depend on each other, so they're shared out between the pool's threads if one is given.
+void StepLifeGenerationsBlocked(PackedCells& cells, PackedCells& scratch, int generations, const LifeRule& rule = LifeRule::Conway(),
+    WorkerPool* workerPool = nullptr);
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "MemoryBudget.h"
+#include "PackedCells.h"
+
+// Block rule of a Margolus neighbourhood cellular automaton, giving the new state of every 2x2 block of cells from its current state.
+// A block's state has bit 0 for its top left cell, bit 1 for top right, bit 2 for bottom left and bit 3 for bottom right.
+struct MargolusRule {
+    std::array<std::uint8_t, 16> newBlocks;
+
+    // Balls moving diagonally that bounce off each other, the billiard ball model.
+    static MargolusRule BilliardBall();
+    // Blocks without exactly two live cells are complemented, and those with three are turned around too.
+    static MargolusRule Critters();
+    // Blocks of all live or all dead cells are complemented.
+    static MargolusRule Tron();
+    // Reads rules in MCell's notation such as "MS,D0;8;4;3;2;5;9;7;1;6;10;11;12;13;14;15", the new state of each block state in order,
+    // returns false if the string isn't one. The "MS,D" can be left out and the states separated by commas instead.
+    static bool Parse(const std::string&, MargolusRule&);
+    std::string ToString() const;
+
+    // Whether every block state has a different new state, so that every generation can be stepped back to exactly.
+    bool IsReversible() const;
+    // The rule that steps blocks back again, only valid for reversible rules.
+    MargolusRule GetInverse() const;
+
+    bool operator==(const MargolusRule&) const;
+    bool operator!=(const MargolusRule&) const;
+};
+
+// A universe of a Margolus neighbourhood rule, wrapping around at the edges. Even generations update the blocks with their top
+// left cell on an even row and column, odd generations the blocks offset by one cell from them, so information crosses the blocks.
+// Cells are packed like PackedCells, and each pair of rows is updated in place a word of 32 blocks at a time from a decoding
+// of every block state, without looking up blocks one at a time. The pairs of rows are split into bands stepped on separate threads.
+class Margolus {
+
+public:
+    Margolus();
+    // Dimensions are rounded down to even ones, so every block fits whole on both partitions.
+    Margolus(int width, int height);
+
+    int GetWidth() const;
+    int GetHeight() const;
+    // Resizes the universe in place, cells inside both the old and new dimensions keep their state.
+    // Returns false without changing anything if the new dimensions aren't valid or don't fit in the memory budget.
+    bool SetDimensions(int width, int height);
+
+    // The billiard ball model until set otherwise.
+    void SetRule(const MargolusRule&);
+    const MargolusRule& GetRule() const;
+    bool IsReversible() const;
+
+    // Cells outside the universe are inactive.
+    CellState GetCellState(int x, int y) const;
+    bool SetCellState(int x, int y, CellState);
+
+    void GenerateEmptyCells();
+    // About a quarter of the cells alive.
+    void GenerateRandomCells();
+
+    const PackedCells& GetCells() const;
+
+    void Step();
+    // Undoes the last generation, even past the first one, returns false if the rule isn't reversible.
+    bool StepBack();
+
+    // Negative after stepping back past the first generation.
+    std::int64_t GetGeneration() const;
+    // Changes whenever the cells do.
+    std::uint64_t GetCellsVersion() const;
+
+private:
+    // Updates the blocks of the partition generation uses with the rule.
+    void UpdateBlocks(const MargolusRule&, std::int64_t generation);
+
+    int m_width;
+    int m_height;
+    MargolusRule m_rule;
+    MargolusRule m_inverseRule;
+    bool m_isReversible;
+    PackedCells m_cells;
+
+    std::int64_t m_generation;
+    std::uint64_t m_cellsVersion;
+
+    MemoryAccount m_memoryAccount;
+};
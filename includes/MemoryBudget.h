@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class MemoryBudget;
+
+// Memory held by one part of the program, such as a universe or a cache, counted against a budget.
+// Usage is only what the owner reports, so it's an estimate of the large buffers rather than every allocation.
+class MemoryAccount {
+
+public:
+    // Caches give a function that frees memory until they hold no more than the bytes asked for, which the budget calls
+    // to make room for other accounts. It's called on the thread that asks for room, the same thread the cache is used on.
+    explicit MemoryAccount(std::string name, std::function<void(std::size_t)> shrink = nullptr);
+    MemoryAccount(std::string name, MemoryBudget&, std::function<void(std::size_t)> shrink = nullptr);
+    ~MemoryAccount();
+
+    const std::string& GetName() const;
+    std::size_t GetUsage() const;
+    std::size_t GetPeakUsage() const;
+    bool IsShrinkable() const;
+
+    // Returns whether the account can grow to usage bytes within the budget, shrinking caches to make room if needed.
+    // Nothing is counted until SetUsage. Refusals are kept by the budget with the usage asked for, unless they're quiet,
+    // for caches that would rather drop what they hold than grow.
+    bool Reserve(std::size_t usage, bool isRefusalReported = true);
+    void SetUsage(std::size_t);
+
+    MemoryAccount(const MemoryAccount&) = delete;
+    MemoryAccount& operator=(const MemoryAccount&) = delete;
+
+private:
+    friend class MemoryBudget;
+
+    MemoryBudget& m_budget;
+    std::string m_name;
+    std::function<void(std::size_t)> m_shrink;
+    std::atomic<std::size_t> m_usage;
+    std::atomic<std::size_t> m_peakUsage;
+};
+
+// A request an account couldn't grow by.
+struct MemoryRefusal {
+    std::string accountName;
+    // What the account would have held.
+    std::size_t requestedUsage;
+    // What the account could have held, with every cache shrunk as far as it goes.
+    std::size_t availableUsage;
+};
+
+struct MemoryAccountUsage {
+    std::string name;
+    std::size_t usage;
+    std::size_t peakUsage;
+    bool isShrinkable;
+};
+
+// Limit on the memory of every account together, so that a universe or diagram too large for the machine is refused up front
+// instead of sending the process into swap. Caches shrink to make room before anything is refused.
+class MemoryBudget {
+
+public:
+    // Every account uses this budget unless given another.
+    static MemoryBudget& GetGlobal();
+
+    // Half of the physical memory, or 4 GB if that can't be found.
+    static std::size_t GetDefaultLimit();
+    // Resident memory of the whole process, 0 if it can't be found.
+    static std::size_t GetProcessResidentMemory();
+
+    explicit MemoryBudget(std::size_t limit = GetDefaultLimit());
+
+    std::size_t GetLimit() const;
+    // Shrinks caches until usage is back under a lower limit, or as far as they go.
+    void SetLimit(std::size_t);
+
+    std::size_t GetUsage() const;
+    std::size_t GetPeakUsage() const;
+    // In the order the accounts were opened.
+    std::vector<MemoryAccountUsage> GetAccountUsages() const;
+
+    // Counts every refusal, so that a new one can be noticed.
+    std::uint64_t GetNumberOfRefusals() const;
+    MemoryRefusal GetLastRefusal() const;
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+private:
+    friend class MemoryAccount;
+
+    void Open(MemoryAccount&);
+    void Close(MemoryAccount&);
+    bool Reserve(MemoryAccount&, std::size_t usage, bool isRefusalReported);
+    void AddUsage(std::size_t oldUsage, std::size_t newUsage);
+    // Shrinks caches other than the one given by up to the bytes asked for, largest first, returns how many were freed.
+    std::size_t ShrinkCaches(std::size_t bytes, const MemoryAccount* except);
+
+    mutable std::mutex m_mutex;
+    std::vector<MemoryAccount*> m_accounts;
+    std::atomic<std::size_t> m_limit;
+    std::atomic<std::size_t> m_usage;
+    std::atomic<std::size_t> m_peakUsage;
+
+    std::uint64_t m_numberOfRefusals;
+    MemoryRefusal m_lastRefusal;
+};
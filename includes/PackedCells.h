@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+enum class CellState : bool {
+    inactive = false,
+    active = true
+};
+
+// Integer position of a cell, ordered by row then column like the packed rows.
+struct CellCoordinates {
+    int x;
+    int y;
+
+    bool operator<(const CellCoordinates&) const;
+    bool operator==(const CellCoordinates&) const;
+};
+
+// Rows of cells stored one bit per cell, where bit (x % 64) of word (x / 64) is cell x.
+// Each row is padded to a whole number of words, and the padding bits are always inactive.
+class PackedCellsView;
+
+class PackedCells {
+
+public:
+    PackedCells();
+    PackedCells(int width, int height);
+
+    int GetWidth() const;
+    int GetHeight() const;
+    int GetWordsPerRow() const;
+
+    // Valid bits of the last word of every row.
+    std::uint64_t GetLastWordMask() const;
+
+    // Cells outside the grid are always inactive.
+    CellState GetCellState(int x, int y) const;
+    bool SetCellState(int x, int y, CellState);
+
+    std::uint64_t* GetRow(int y);
+    const std::uint64_t* GetRow(int y) const;
+    std::vector<std::uint64_t>& GetWords();
+    const std::vector<std::uint64_t>& GetWords() const;
+
+    void Fill(CellState);
+
+    // Every cell, without copying.
+    PackedCellsView GetView() const;
+
+    // Keeps every cell that is still inside the new dimensions in place, new cells are inactive.
+    void Resize(int width, int height);
+
+private:
+    int m_width;
+    int m_height;
+    int m_wordsPerRow;
+    std::vector<std::uint64_t> m_words;
+};
+
+// Index of the lowest active cell in a non-zero word.
+inline int CountTrailingZeros(std::uint64_t word)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+// Number of active cells in a word.
+inline int CountActiveCells(std::uint64_t word)
+{
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(word));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+// Read-only view of rows of cells packed one bit per cell, such as a PackedCells or a generation of a running simulation, without copying them.
+// It's only valid until the cells change. Row y starts stride words after row y - 1, and cell x of a row is bit (bitOffset + x)
+// counted from bit 0 of the row's first word, so views of tiles needn't start on a whole word. Cells outside the view are never reported.
+class PackedCellsView {
+
+public:
+    class LiveCellIterator;
+    struct LiveCells;
+
+    PackedCellsView();
+    PackedCellsView(const std::uint64_t* words, int width, int height, std::size_t stride, int bitOffset = 0);
+
+    int GetWidth() const;
+    int GetHeight() const;
+    std::size_t GetStride() const;
+    int GetBitOffset() const;
+
+    // Words covering row y, the first and last may also hold cells outside the view, see GetFirstWordMask and GetLastWordMask.
+    const std::uint64_t* GetRow(int y) const;
+    int GetWordsPerRow() const;
+    std::uint64_t GetFirstWordMask() const;
+    std::uint64_t GetLastWordMask() const;
+
+    // Cells outside the view are inactive.
+    CellState GetCellState(int x, int y) const;
+
+    // Cells [x, x + width) of rows [y, y + height), clipped to this view, with coordinates relative to the tile.
+    PackedCellsView GetTile(int x, int y, int width, int height) const;
+
+    std::size_t CountLiveCells() const;
+
+    // Coordinates of the active cells only, row by row, skipping empty words a word at a time.
+    LiveCells GetLiveCells() const;
+
+private:
+    const std::uint64_t* m_words;
+    int m_width;
+    int m_height;
+    std::size_t m_stride;
+    int m_bitOffset;
+    int m_wordsPerRow;
+    std::uint64_t m_firstWordMask;
+    std::uint64_t m_lastWordMask;
+};
+
+class PackedCellsView::LiveCellIterator {
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = CellCoordinates;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const CellCoordinates*;
+    using reference = const CellCoordinates&;
+
+    // The first active cell in row y or after it.
+    LiveCellIterator(const PackedCellsView& view, int y)
+        : m_view(&view)
+        , m_y(y)
+        , m_word(0)
+        , m_bits(0)
+        , m_cell { 0, y }
+    {
+        if (m_y >= m_view->m_height || m_view->m_wordsPerRow == 0) {
+            m_y = m_view->m_height;
+            return;
+        }
+
+        LoadWord();
+        FindActiveCell();
+    }
+
+    reference operator*() const
+    {
+        return m_cell;
+    }
+
+    pointer operator->() const
+    {
+        return &m_cell;
+    }
+
+    LiveCellIterator& operator++()
+    {
+        m_bits &= m_bits - 1;
+        FindActiveCell();
+        return *this;
+    }
+
+    LiveCellIterator operator++(int)
+    {
+        LiveCellIterator previous = *this;
+        ++*this;
+        return previous;
+    }
+
+    bool operator==(const LiveCellIterator& other) const
+    {
+        return m_y == other.m_y && m_word == other.m_word && m_bits == other.m_bits;
+    }
+
+    bool operator!=(const LiveCellIterator& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    void LoadWord()
+    {
+        m_bits = m_view->GetRow(m_y)[m_word];
+        if (m_word == 0)
+            m_bits &= m_view->m_firstWordMask;
+        if (m_word == m_view->m_wordsPerRow - 1)
+            m_bits &= m_view->m_lastWordMask;
+    }
+
+    // Stays on the current cell if it's active, the end is past the last row with no bits left.
+    void FindActiveCell()
+    {
+        while (m_bits == 0) {
+            if (++m_word == m_view->m_wordsPerRow) {
+                m_word = 0;
+                if (++m_y == m_view->m_height)
+                    return;
+            }
+            LoadWord();
+        }
+
+        m_cell = CellCoordinates { m_word * 64 + CountTrailingZeros(m_bits) - m_view->m_bitOffset, m_y };
+    }
+
+    const PackedCellsView* m_view;
+    int m_y;
+    int m_word;
+    std::uint64_t m_bits;
+    CellCoordinates m_cell;
+};
+
+// Holds a copy of the view, so that it can be iterated over straight from a temporary view.
+struct PackedCellsView::LiveCells {
+    PackedCellsView view;
+
+    LiveCellIterator begin() const
+    {
+        return LiveCellIterator(view, 0);
+    }
+
+    LiveCellIterator end() const
+    {
+        return LiveCellIterator(view, view.GetHeight());
+    }
+};
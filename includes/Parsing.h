@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Reads a whole number of up to 6 digits from position onwards and moves position past it, returns false if there isn't one.
+bool ParseNumber(const std::string& text, std::size_t& position, int& number);
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "LifeKernel.h"
+#include "MemoryBudget.h"
+#include "PackedCells.h"
+
+struct PatternSearchSettings {
+    // The box every candidate's initial cells are in, up to 8 by 8.
+    int boxWidth;
+    int boxHeight;
+    // Every configuration of the box in order, for boxes of up to 40 cells, otherwise random configurations.
+    bool isExhaustive;
+    std::uint64_t numberOfRandomCandidates;
+    std::uint64_t seed;
+    // Candidates repeat within this many generations, 1 to 16.
+    int maximumPeriod;
+    // Candidates have settleGenerations + maximumPeriod generations to settle into repeating, unless they reach the edge
+    // of the field first, maximumFieldReach cells beyond the box.
+    int settleGenerations;
+    // Rules that give birth to cells without neighbours, B0, can't be searched.
+    LifeRule rule;
+
+    static constexpr int maximumBoxSize = 8;
+    static constexpr int maximumExhaustiveCells = 40;
+    static constexpr int maximumPeriodLimit = 16;
+    static constexpr int maximumSettleGenerations = 1024;
+    static constexpr int maximumFieldReach = 64;
+};
+
+enum class PatternKind : int {
+    stillLife = 0,
+    oscillator = 1,
+    spaceship = 2
+};
+
+// A pattern found by the search. Patterns are the same when one is a phase of the other, rotated or reflected.
+struct FoundPattern {
+    // The phase it was first found in, cropped to its live cells.
+    PackedCells cells;
+    PatternKind kind;
+    int period;
+    // Distance moved every period.
+    int dx;
+    int dy;
+    int population;
+    // How many candidates settled into it.
+    std::uint64_t numberOfOccurrences;
+    std::uint64_t firstCandidate;
+};
+
+// Searches a box's configurations for still lifes, oscillators and spaceships in the background.
+// Candidates are stepped numberOfLanes at a time, bit-sliced like LifeEnsemble, and only within the bounds of their active cells,
+// in a field reaching as far beyond the box as light can within maximumFieldReach. The last generation is then compared with each
+// of the earlier ones moved as far as each lane's bounds did in between. Lanes that reach the edge of the field are compared there
+// and then dropped, so spaceships are still found, but patterns that only settle after spreading that far aren't.
+// Candidates are handed out in chunks of numberOfLanes, and every hardware thread works through its own range of chunks,
+// stealing half of the largest remaining range once it's done.
+class PatternSearch {
+
+public:
+    static constexpr int numberOfLanes = 64;
+
+    PatternSearch();
+    ~PatternSearch();
+
+    // Stops any search already running and starts a new one. Returns false if the settings can't be searched,
+    // or if every worker's field doesn't fit in the memory budget.
+    bool Start(const PatternSearchSettings&);
+    void Stop();
+    bool IsRunning() const;
+
+    const PatternSearchSettings& GetSettings() const;
+    std::uint64_t GetNumberOfCandidates() const;
+    std::uint64_t GetNumberOfTestedCandidates() const;
+    double GetSeconds() const;
+
+    // Every distinct pattern found so far, in the order they were found.
+    std::vector<FoundPattern> GetResults() const;
+    std::size_t GetNumberOfResults() const;
+
+    PatternSearch(const PatternSearch&) = delete;
+    PatternSearch& operator=(const PatternSearch&) = delete;
+
+private:
+    // Chunks [next, end) still to be searched by one worker.
+    struct WorkRange {
+        std::mutex mutex;
+        std::uint64_t next;
+        std::uint64_t end;
+    };
+
+    // A worker's last maximumPeriod + 1 generations, see PatternSearch.cpp.
+    struct Field;
+
+    bool TakeChunk(int worker, std::uint64_t& chunk);
+    void RunWorker(int worker);
+    void SearchChunk(std::uint64_t chunk, Field&);
+    // Records the lanes that repeat in the generation with the earlier ones, returns them.
+    std::uint64_t RecordRepeatingLanes(Field&, int generation, std::uint64_t lanes, std::uint64_t firstCandidate);
+    void RecordPattern(const PackedCells& cells, int period, int dx, int dy, std::uint64_t candidate);
+
+    PatternSearchSettings m_settings;
+    std::uint64_t m_numberOfCandidates;
+    std::uint64_t m_numberOfChunks;
+
+    // Candidates are stepped to the last generation in a field with a margin around the box, keeping the last maximumPeriod + 1
+    // generations. Each has a border of inactive cells beyond the field's width and height so stepping needs no bounds checks.
+    int m_lastGeneration;
+    int m_margin;
+    int m_fieldWidth;
+    int m_fieldHeight;
+    int m_stride;
+    std::size_t m_generationSize;
+
+    std::vector<std::unique_ptr<WorkRange>> m_workRanges;
+    std::vector<std::future<void>> m_workers;
+    std::atomic<bool> m_isStopping;
+    std::atomic<int> m_numberOfRunningWorkers;
+    std::atomic<std::uint64_t> m_numberOfTestedCandidates;
+    std::chrono::steady_clock::time_point m_startTime;
+    std::atomic<double> m_seconds;
+
+    mutable std::mutex m_resultsMutex;
+    std::vector<FoundPattern> m_results;
+    // Canonical form of each result, and the results with each canonical form's hash.
+    std::vector<std::vector<std::uint64_t>> m_canonicalForms;
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> m_resultsByHash;
+
+    // The workers' fields while they run.
+    MemoryAccount m_memoryAccount;
+};
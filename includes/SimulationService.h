@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "GameOfLife.h"
+#include "MemoryBudget.h"
+#include "PackedCells.h"
+
+// Serves a Game of Life universe on a Unix domain socket, so dashboards and scripts can watch and drive it without the GUI.
+// Clients send text commands, one per line:
+//   SIZE <width> <height>
+//   LOAD <empty|random|r-pentomino|glider-gun|infinite-growth>
+//   RULE <B3/S23>
+//   PAINT <x> <y> <length> <0|1>           sets a run of cells along a row, applied before the next generation
+//   STEP <generations>
+//   RUN, PAUSE                              steps continuously, or stops
+//   SUBSCRIBE <x> <y> <width> <height>      a frame of this viewport follows every generation
+//   SNAPSHOT                                a keyframe of the viewport, or of the whole universe when not subscribed
+//   QUIT
+//
+// Every message sent back is a 32 bit type and a 32 bit payload size followed by the payload, all in host byte order.
+// Replies (type 1) are the text "OK" or "ERROR <reason>". Commands for the universe are answered once they're queued for it,
+// except SIZE, which is answered once the universe has been resized or the memory budget has refused it, and SUBSCRIBE and SNAPSHOT,
+// which are answered once the generation their keyframe is built from has been published. A client's later commands wait until then.
+// Frames (type 2) are the generation (64 bits), a keyframe flag, the viewport's x, y, width and height and the number of tiles
+// (32 bits each), followed by each tile's column, row and number of compressed words (32 bits each) and the words, see CompressWords.
+// Tiles are 64 by 64 cells of the viewport with one word per row. Only tiles that changed are sent, holding the xor with the tile
+// as it was last sent, except in keyframes which hold every tile with an active cell as it is.
+//
+// Stepping runs on its own thread and never waits on a client. While any client is subscribed each generation is published as a copy
+// that never changes, so frames are built from it without holding up stepping. The copies count against the memory budget, and
+// a generation that doesn't fit isn't published. Each client has a bounded queue of outgoing bytes. While it's full the client's
+// frames are skipped, so its next frame holds every change since the last one it was sent, and nothing more is read from the client.
+class SimulationService {
+
+public:
+    SimulationService();
+    ~SimulationService();
+
+    static bool IsSupported();
+
+    // Serves clients until Stop is called, returns false if the socket can't be created.
+    bool Run(const std::string& socketPath);
+    // Safe to call from any thread and from signal handlers.
+    void Stop();
+
+    SimulationService(const SimulationService&) = delete;
+    SimulationService& operator=(const SimulationService&) = delete;
+
+private:
+    struct Client {
+        std::uint64_t id;
+        int socket;
+        std::string input;
+        // Set while the stepping thread has the reply to a command, nothing more is read from the client until it arrives.
+        bool isAwaitingReply;
+        // A keyframe follows the awaited reply if it's "OK".
+        bool isKeyframeRequested;
+        std::vector<std::uint8_t> output;
+        std::size_t outputOffset;
+
+        bool isSubscribed;
+        int viewportX;
+        int viewportY;
+        int viewportWidth;
+        int viewportHeight;
+        // The viewport as the client last saw it, frames hold the xor with this.
+        PackedCells sentCells;
+        std::uint64_t sentVersion;
+    };
+
+    struct PublishedGeneration {
+        PackedCells cells;
+        std::uint64_t generation;
+        std::uint64_t version;
+    };
+
+    static constexpr std::size_t maximumQueuedBytes = 4 * 1024 * 1024;
+
+    void RunStepping();
+    // Returns false without publishing if the copy doesn't fit in the memory budget.
+    bool PublishGeneration();
+    // The published generations the stepping thread holds.
+    void UpdateMemoryUsage();
+    std::shared_ptr<const PublishedGeneration> GetLatestGeneration();
+    void QueueCommand(std::function<void()>);
+    // Called by the stepping thread to answer a command it has run.
+    void QueueReply(std::uint64_t clientId, std::string reply);
+
+    // Handles every complete line of input unless a reply is awaited, returns false once the client has asked to quit or misbehaves.
+    bool HandleInput(Client&);
+    // Returns false once the client has asked to quit.
+    bool HandleCommand(Client&, const std::string& line);
+    // Has the stepping thread publish the current generation, which the keyframe is built from once it has replied.
+    void RequestKeyframe(Client&);
+    // Commands aren't handled and frames aren't built while a client has this much output queued.
+    static bool IsOutputFull(const Client&);
+    void AppendReply(Client&, const std::string& reply);
+    void AppendFrame(Client&, const PublishedGeneration&, bool isKeyframe);
+    // Returns false if the client has gone.
+    bool WriteOutput(Client&);
+
+    // Only touched by the stepping thread, apart from the commands queued to it and the edits pushed to its edit queue.
+    GameOfLife m_gameOfLife;
+    std::uint64_t m_pendingGenerations;
+    bool m_isRunning;
+
+    std::mutex m_commandMutex;
+    std::condition_variable m_commandCondition;
+    std::vector<std::function<void()>> m_commands;
+    bool m_isSteppingStopped;
+    // Set while a command to apply painted edits is queued, so painting never queues more than one.
+    std::atomic<bool> m_isApplyingEditsQueued;
+
+    // The latest generation, published by the stepping thread for the clients.
+    std::mutex m_generationMutex;
+    std::shared_ptr<const PublishedGeneration> m_latestGeneration;
+    // Only touched by the stepping thread. The last generation it published, and the one before, reused once no client holds it.
+    std::shared_ptr<PublishedGeneration> m_publishedGeneration;
+    std::shared_ptr<PublishedGeneration> m_spareGeneration;
+    // Generations are only published every step while a client is subscribed.
+    std::atomic<int> m_numberOfSubscribers;
+    MemoryAccount m_memoryAccount;
+
+    // Replies from the stepping thread, by client id.
+    std::mutex m_replyMutex;
+    std::vector<std::pair<std::uint64_t, std::string>> m_replies;
+
+    std::list<Client> m_clients;
+    std::uint64_t m_nextClientId;
+    int m_listenSocket;
+    int m_wakeEvent;
+    std::atomic<bool> m_isStopping;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "LifeKernel.h"
+#include "PackedCells.h"
+
+// Steps a Game of Life universe with several local worker processes, each owning one horizontal slab of rows.
+// The universe lives in POSIX shared memory with two buffers, so halo rows are read straight from the neighbouring slabs,
+// and every generation is synchronised with one pair of eventfds per worker. Only available on Linux.
+class SlabWorkers {
+
+public:
+    SlabWorkers();
+    ~SlabWorkers();
+
+    static bool IsSupported();
+
+    // Creates the shared universe and forks one worker per slab. Pinning gives each worker its own contiguous block of CPUs.
+    bool Start(int width, int height, int numberOfWorkers, bool isPinnedToCpus);
+    void Stop();
+
+    bool IsRunning() const;
+    int GetNumberOfWorkers() const;
+    int GetNumberOfRestarts() const;
+    int GetWordsPerRow() const;
+
+    // Read-only view of the current generation, row-major with GetWordsPerRow() words per row.
+    const std::uint64_t* GetCurrentCells() const;
+
+    void UploadCells(const PackedCells&);
+    void DownloadCells(PackedCells&) const;
+    // Copies only rows [firstRow, lastRow), for cells already of the universe's dimensions.
+    void UploadRows(const PackedCells&, int firstRow, int lastRow);
+    void DownloadRows(PackedCells&, int firstRow, int lastRow) const;
+
+    // Conway's Game of Life until set otherwise.
+    void SetRule(const LifeRule&);
+
+    // Steps every slab one generation. A worker that dies is restarted from its slab of the current generation and redoes the step.
+    // Returns false if a worker couldn't be restarted or started on the step. Every worker is then killed, but the current
+    // generation is left as it was for downloading, and nothing more is stepped until the workers are started over.
+    bool Step();
+
+    SlabWorkers(const SlabWorkers&) = delete;
+    SlabWorkers& operator=(const SlabWorkers&) = delete;
+
+private:
+    struct Worker {
+        int processId;
+        int startEvent;
+        int doneEvent;
+        int firstRow;
+        int lastRow;
+        std::vector<int> cpus;
+    };
+
+    // Kills every worker process, keeping the shared universe and the eventfds.
+    void KillWorkers();
+    bool StartWorker(Worker&);
+
+    int m_width;
+    int m_height;
+    int m_wordsPerRow;
+    int m_numberOfRestarts;
+
+    int m_sharedMemory;
+    std::size_t m_headerSize;
+    std::size_t m_bufferSize;
+    void* m_header;
+    // This process only ever maps the cells read-only, except for the moment of an upload.
+    const void* m_readOnlyCells;
+
+    std::vector<Worker> m_workers;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Run-length encoding for bit-packed cells, which are mostly empty space.
+// Non-zero words are stored as they are, and each run of zero words as a zero followed by the run length.
+std::vector<std::uint64_t> CompressWords(const std::uint64_t* words, std::size_t numberOfWords);
+std::vector<std::uint64_t> DecompressWords(const std::vector<std::uint64_t>& compressedWords);
+// Decompresses into numberOfWords words, returns false if the compressed words don't hold exactly that many,
+// so words read back from a file can't overrun it.
+bool DecompressWords(const std::uint64_t* compressedWords, std::size_t numberOfCompressedWords, std::uint64_t* words, std::size_t numberOfWords);
+
+// The difference between two generations, compressed without being written out first.
+std::vector<std::uint64_t> CompressXorWords(const std::uint64_t* words, const std::uint64_t* otherWords, std::size_t numberOfWords);
+// Xors compressed words into words, the runs of zero words are skipped over.
+void XorDecompressedWords(const std::vector<std::uint64_t>& compressedWords, std::uint64_t* words);
+
+// Sparse differences are better stored bit by bit, as the gap between each set bit of the xor and the one before it,
+// in a variable length integer of 7 bits per byte. Returns false without finishing if that takes more than maximumSize bytes.
+bool CompressXorBits(const std::uint64_t* words, const std::uint64_t* otherWords, std::size_t numberOfWords, std::size_t maximumSize, std::vector<std::uint8_t>& compressedBits);
+void XorDecompressedBits(const std::vector<std::uint8_t>& compressedBits, std::uint64_t* words);
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Threads kept waiting to run the chunks of a task together, for work split so finely that starting a thread for every chunk
+// would cost more than the chunk. The threads are started on first use, so pools that only ever run one chunk never start any.
+// Calls from several threads take turns.
+class WorkerPool {
+
+public:
+    // Zero threads is one per hardware thread.
+    explicit WorkerPool(int numberOfThreads = 0);
+    ~WorkerPool();
+
+    int GetNumberOfThreads() const;
+
+    // Runs task(chunk) for every chunk, at most one per thread, the first on the calling thread. Returns once they've all finished.
+    void RunChunks(int numberOfChunks, const std::function<void(int)>& task);
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+private:
+    // Round is the last one started before the worker, which it skips.
+    void RunWorker(int chunk, std::uint64_t round);
+
+    int m_numberOfThreads;
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_runMutex;
+    std::mutex m_mutex;
+    std::condition_variable m_roundStarted;
+    std::condition_variable m_roundFinished;
+    const std::function<void(int)>* m_task;
+    int m_numberOfChunks;
+    int m_remainingChunks;
+    std::uint64_t m_round;
+    bool m_isStopping;
+};
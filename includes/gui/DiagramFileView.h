@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "DiagramFile.h"
+#include "Grid.h"
+
+// Draws the generated part of an Elementary diagram file on a grid, reading only the rows and words that are visible.
+class DiagramFileView : public Grid {
+
+public:
+    explicit DiagramFileView(DiagramFile&);
+
+    void DrawCells() override;
+
+    // Scrolls the cell at this position and generation to the top left corner of the canvas.
+    void ScrollTo(int position, int generation);
+
+private:
+    DiagramFile& m_diagramFile;
+    std::vector<std::uint64_t> m_rowWords;
+
+    // A diagram's rows only depend on its rule, width and starting generation, so the cells only change when those do
+    // or more generations complete.
+    int m_drawnRuleNumber;
+    int m_drawnNumberOfCellsPerGeneration;
+    std::uint64_t m_drawnStartingGeneration;
+    std::uint64_t m_cellsVersion;
+};
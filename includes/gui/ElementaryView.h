@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Elementary.h"
+#include "Grid.h"
+
+// Draws an elementary cellular automaton's diagram on a grid, one row per generation.
+class ElementaryView : public Grid {
+
+public:
+    explicit ElementaryView(const Elementary&);
+
+    void DrawCells() override;
+
+private:
+    const Elementary& m_elementary;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "GameOfLife.h"
+#include "Grid.h"
+
+// Draws a Game of Life universe's current generation on a grid.
+class GameOfLifeView : public Grid {
+
+public:
+    explicit GameOfLifeView(const GameOfLife&);
+
+    void DrawCells() override;
+
+private:
+    const GameOfLife& m_gameOfLife;
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Generations.h"
+#include "Grid.h"
+
+// Draws a Generations universe's current generation on a grid. Live cells are drawn in the main cell colour,
+// and each state after that in a darker shade of it as the cells decay.
+class GenerationsView : public Grid {
+
+public:
+    explicit GenerationsView(const Generations&);
+
+    void DrawCells() override;
+
+private:
+    const Generations& m_generations;
+
+    // The cells in each state from 1 on, found again only when the cells change.
+    std::vector<PackedCells> m_cellsInState;
+    std::uint64_t m_cellsInStateVersion;
+};
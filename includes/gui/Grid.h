@@ -0,0 +1,109 @@
+#pragma once
+
+#include "PackedCells.h"
+#include "imgui.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Grid
+{
+public:
+
+	std::vector <ImVec2> m_cells_to_draw;
+	
+	Grid();
+
+	void EnableGrid(bool);
+	
+	ImVec2 GetMinimumCanvasPosition() const;
+	ImVec2 GetMaximumCanvasPosition() const;
+	ImVec2 GetCanvasSize() const;
+
+	ImColor GetCellMainCellColour();
+
+	int GetGridSteps() const;
+	void SetGridSteps(int);
+
+	void SetMainCellColour(ImColor);
+
+	// While painting, the left mouse button paints cells and the right one erases them, and the middle one pans instead.
+	void EnablePainting(bool);
+	// The cells the mouse crossed this frame with a button held, from the cell under it last frame to the one under it now.
+	// Returns false when nothing is being painted. The first frame of a stroke has from equal to to and is_stroke_start set.
+	bool GetPaintStroke(CellCoordinates& from, CellCoordinates& to, bool& is_erasing, bool& is_stroke_start) const;
+
+	void DrawGrid();
+	virtual void DrawCells();
+
+	// Draws the active cells inside the canvas from rows [0, numberOfRows) of a row-major, one bit per cell buffer.
+	// The rectangles drawn are kept, and the cells are only read again once cellsVersion, the zoom, the scroll or the canvas change.
+	void DrawPackedCells(const std::uint64_t* words, int wordsPerRow, int numberOfRows, std::uint64_t cellsVersion);
+	// Same again for rows that aren't in one buffer, getRowWords(y, firstWord, lastWord) returns words [firstWord, lastWord) of row y,
+	// or nullptr to skip the row. Only visible rows are asked for.
+	void DrawPackedRows(const std::function<const std::uint64_t*(int, int, int)>& getRowWords, int wordsPerRow, int numberOfRows, std::uint64_t cellsVersion);
+	// Draws several one bit per cell buffers of the same dimensions on top of each other, each in its own colour, such as the cells in each state
+	// of a multi-state rule. The colours are kept with the rectangles, so they may only change along with cellsVersion or the main cell colour.
+	void DrawPackedLayers(const std::vector<const std::uint64_t*>& layers, const std::vector<ImU32>& colours, int wordsPerRow, int numberOfRows, std::uint64_t cellsVersion);
+
+	// Following the Rule of 5. 
+	// No use for the special member functions, so they are simply deleted.
+	Grid(const Grid&) = delete;
+	Grid(Grid&&) = delete;
+	Grid& operator=(const Grid&) = delete;
+	Grid& operator=(Grid&&) = delete;
+
+	virtual ~Grid() = default;
+
+private:
+
+	// Everything the kept rectangles were drawn from.
+	struct CellCacheKey {
+		std::uint64_t cells_version;
+		int words_per_row;
+		int number_of_rows;
+		int grid_steps;
+		ImVec2 canvas_position;
+		ImVec2 scrolling;
+		float canvas_width;
+		float canvas_height;
+		ImU32 colour;
+
+		bool operator==(const CellCacheKey&) const;
+	};
+
+	// Whether the kept rectangles can be drawn again, otherwise they're cleared ready for AddPackedRows.
+	bool IsCellCacheValid(int wordsPerRow, int numberOfRows, std::uint64_t cellsVersion);
+	// Keeps a rectangle for every run of active cells inside the canvas.
+	void AddPackedRows(const std::function<const std::uint64_t*(int, int, int)>& getRowWords, int wordsPerRow, int numberOfRows, ImU32 colour);
+	// Copies the kept rectangles' vertices straight into the draw list.
+	void DrawCachedCells(ImDrawList*) const;
+
+	bool m_enable_grid;
+	ImVec2 m_canvas_size;
+	ImVec2 m_min_canvas_position;
+	ImVec2 m_max_canvas_position;
+	
+	ImVec2 m_grid_scrolling;
+	int m_grid_steps;
+
+	ImColor m_cell_colour_main;
+
+	bool m_enable_painting;
+	bool m_is_painting;
+	bool m_is_erasing;
+	bool m_is_stroke_start;
+	CellCoordinates m_paint_from;
+	CellCoordinates m_paint_to;
+
+	// Four vertices per rectangle, in the order ImDrawList::PrimRect writes them.
+	std::vector<ImDrawVert> m_cached_cell_vertices;
+	CellCacheKey m_cell_cache_key;
+	bool m_is_cell_cache_valid;
+
+	friend class DiagramFileView;
+	friend class ElementaryView;
+	friend class GameOfLifeView;
+	friend class GenerationsView;
+	friend class MargolusView;
+};
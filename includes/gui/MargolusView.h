@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Grid.h"
+#include "Margolus.h"
+
+// Draws a Margolus universe's current generation on a grid, live cells in the main cell colour.
+class MargolusView : public Grid {
+
+public:
+    explicit MargolusView(const Margolus&);
+
+    void DrawCells() override;
+
+private:
+    const Margolus& m_margolus;
+};
@@ -0,0 +1,194 @@
+#include "CellEdits.h"
+#include "Parsing.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+// Larger patterns are refused rather than allocated.
+constexpr int maximumPatternSize = 1 << 16;
+
+// Reads the value of "name = value" from an RLE header line such as "x = 3, y = 3, rule = B3/S23".
+bool ParseHeaderValue(const std::string& line, char name, int& value)
+{
+    for (std::size_t position = 0; position < line.size(); ++position) {
+        if (line[position] != name || (position > 0 && line[position - 1] != ' ' && line[position - 1] != ','))
+            continue;
+
+        std::size_t valuePosition = line.find_first_not_of(' ', position + 1);
+        if (valuePosition == std::string::npos || line[valuePosition] != '=')
+            continue;
+
+        valuePosition = line.find_first_not_of(' ', valuePosition + 1);
+        return valuePosition != std::string::npos && ParseNumber(line, valuePosition, value);
+    }
+
+    return false;
+}
+}
+
+CellEditQueue::CellEditQueue(std::size_t capacity)
+    : m_edits()
+    , m_indexMask(0)
+    , m_head(0)
+    , m_tail(0)
+{
+    std::size_t roundedCapacity = 1;
+    while (roundedCapacity < capacity) {
+        roundedCapacity *= 2;
+    }
+
+    m_edits.resize(roundedCapacity);
+    m_indexMask = roundedCapacity - 1;
+}
+
+// The indices only ever increase and wrap with the mask. Publishing the tail with release and reading it with acquire
+// makes the edits written before it visible to the consumer, and the head does the same for the slots the consumer is done with.
+std::size_t CellEditQueue::Push(const CellEdit* edits, std::size_t numberOfEdits)
+{
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    const std::size_t head = m_head.load(std::memory_order_acquire);
+    const std::size_t numberToPush = std::min(numberOfEdits, m_edits.size() - (tail - head));
+
+    for (std::size_t edit = 0; edit < numberToPush; ++edit) {
+        m_edits[(tail + edit) & m_indexMask] = edits[edit];
+    }
+
+    m_tail.store(tail + numberToPush, std::memory_order_release);
+    return numberToPush;
+}
+
+std::size_t CellEditQueue::PopAll(std::vector<CellEdit>& edits)
+{
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    const std::size_t tail = m_tail.load(std::memory_order_acquire);
+
+    for (std::size_t edit = head; edit != tail; ++edit) {
+        edits.push_back(m_edits[edit & m_indexMask]);
+    }
+
+    m_head.store(tail, std::memory_order_release);
+    return tail - head;
+}
+
+bool CellEditQueue::IsEmpty() const
+{
+    return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+}
+
+void AddBrushEdits(CellCoordinates from, CellCoordinates to, int radius, CellState state, std::vector<CellEdit>& edits)
+{
+    radius = std::max(radius, 0);
+
+    // Half of each row of the circle, so every cell within the radius of its centre is painted.
+    std::vector<int> halfWidths(radius + 1);
+    for (int dy = 0; dy <= radius; ++dy) {
+        int halfWidth = radius;
+        while (halfWidth * halfWidth + dy * dy > radius * radius) {
+            --halfWidth;
+        }
+        halfWidths[dy] = halfWidth;
+    }
+
+    // One circle per cell along the line, so fast strokes don't leave gaps.
+    const int steps = std::max(std::abs(to.x - from.x), std::abs(to.y - from.y));
+    for (int step = 0; step <= steps; ++step) {
+        const int x = (steps == 0) ? from.x : from.x + ((to.x - from.x) * step + (to.x >= from.x ? steps / 2 : -steps / 2)) / steps;
+        const int y = (steps == 0) ? from.y : from.y + ((to.y - from.y) * step + (to.y >= from.y ? steps / 2 : -steps / 2)) / steps;
+        for (int dy = -radius; dy <= radius; ++dy) {
+            const int halfWidth = halfWidths[std::abs(dy)];
+            edits.push_back(CellEdit { x - halfWidth, y + dy, 2 * halfWidth + 1, state });
+        }
+    }
+}
+
+void AddStampEdits(const PackedCells& pattern, int x, int y, std::vector<CellEdit>& edits)
+{
+    for (int row = 0; row < pattern.GetHeight(); ++row) {
+        edits.push_back(CellEdit { x, y + row, pattern.GetWidth(), CellState::inactive });
+
+        int column = 0;
+        while (column < pattern.GetWidth()) {
+            if (pattern.GetCellState(column, row) == CellState::inactive) {
+                ++column;
+                continue;
+            }
+
+            const int runStart = column;
+            while (column < pattern.GetWidth() && pattern.GetCellState(column, row) == CellState::active) {
+                ++column;
+            }
+            edits.push_back(CellEdit { x + runStart, y + row, column - runStart, CellState::active });
+        }
+    }
+}
+
+bool ParseRlePattern(const std::string& text, PackedCells& pattern)
+{
+    // Comment lines start with '#', and the first other line is the header.
+    std::size_t position = 0;
+    std::string header;
+    while (position < text.size()) {
+        const std::size_t lineEnd = std::min(text.find('\n', position), text.size());
+        const std::string line = text.substr(position, lineEnd - position);
+        position = lineEnd + 1;
+        if (!line.empty() && line[0] != '#' && line.find_first_not_of(" \r\t") != std::string::npos) {
+            header = line;
+            break;
+        }
+    }
+
+    int width = 0;
+    int height = 0;
+    if (!ParseHeaderValue(header, 'x', width) || !ParseHeaderValue(header, 'y', height) || width > maximumPatternSize || height > maximumPatternSize)
+        return false;
+
+    PackedCells parsedPattern(width, height);
+    int x = 0;
+    int y = 0;
+    while (position < text.size()) {
+        const char character = text[position];
+        if (character == '!') {
+            pattern = std::move(parsedPattern);
+            return true;
+        }
+
+        if (character == ' ' || character == '\t' || character == '\r' || character == '\n') {
+            ++position;
+            continue;
+        }
+
+        int count = 1;
+        if (character >= '0' && character <= '9')
+            ParseNumber(text, position, count);
+        else
+            ++position;
+
+        if (position >= text.size())
+            return false;
+
+        const char tag = (character >= '0' && character <= '9') ? text[position++] : character;
+        if (tag == '$') {
+            x = 0;
+            y += count;
+        } else if (tag == 'b' || tag == '.') {
+            x += count;
+        } else if ((tag >= 'a' && tag <= 'z') || (tag >= 'A' && tag <= 'X')) {
+            // Multi-state patterns prefix states above 24 with a lower case letter, which isn't a cell by itself.
+            if (tag >= 'p' && tag <= 'y' && tag != 'o' && position < text.size() && text[position] >= 'A' && text[position] <= 'X')
+                ++position;
+            if (x + count > width || y >= height)
+                return false;
+            for (int cell = 0; cell < count; ++cell) {
+                parsedPattern.SetCellState(x + cell, y, CellState::active);
+            }
+            x += count;
+        } else {
+            return false;
+        }
+    }
+
+    // Patterns should end with '!', but the cells read are still kept.
+    pattern = std::move(parsedPattern);
+    return true;
+}
@@ -0,0 +1,116 @@
+#include "DiagramCache.h"
+#include "WordCompression.h"
+
+#include <tuple>
+#include <utility>
+
+bool DiagramKey::operator<(const DiagramKey& other) const
+{
+    return std::tie(ruleNumber, numberOfCellsPerGeneration, numberOfGenerations, startingGeneration)
+        < std::tie(other.ruleNumber, other.numberOfCellsPerGeneration, other.numberOfGenerations, other.startingGeneration);
+}
+
+bool DiagramKey::operator==(const DiagramKey& other) const
+{
+    return std::tie(ruleNumber, numberOfCellsPerGeneration, numberOfGenerations, startingGeneration)
+        == std::tie(other.ruleNumber, other.numberOfCellsPerGeneration, other.numberOfGenerations, other.startingGeneration);
+}
+
+// Default cap is 64 MB.
+DiagramCache::DiagramCache()
+    : m_entries()
+    , m_entryLookup()
+    , m_memoryCap(64 * 1024 * 1024)
+    , m_memoryUsage(0)
+    , m_memoryAccount("Elementary diagram cache", [this](std::size_t memoryLimit) { EvictLeastRecentlyUsed(memoryLimit); }) {}
+
+std::size_t DiagramCache::GetMemoryCap() const
+{
+    return m_memoryCap;
+}
+
+std::size_t DiagramCache::GetMemoryUsage() const
+{
+    return m_memoryUsage;
+}
+
+std::size_t DiagramCache::GetNumberOfDiagrams() const
+{
+    return m_entries.size();
+}
+
+void DiagramCache::SetMemoryCap(std::size_t memoryCap)
+{
+    m_memoryCap = memoryCap;
+    EvictLeastRecentlyUsed(m_memoryCap);
+}
+
+bool DiagramCache::Find(const DiagramKey& key, std::vector<std::uint64_t>& packedCells)
+{
+    const auto lookup = m_entryLookup.find(key);
+    if (lookup == m_entryLookup.end())
+        return false;
+
+    // Splicing keeps the iterator in m_entryLookup valid.
+    m_entries.splice(m_entries.begin(), m_entries, lookup->second);
+    packedCells = DecompressWords(lookup->second->compressedCells);
+
+    return true;
+}
+
+void DiagramCache::Insert(const DiagramKey& key, const std::vector<std::uint64_t>& packedCells)
+{
+    const auto lookup = m_entryLookup.find(key);
+    if (lookup != m_entryLookup.end()) {
+        m_memoryUsage -= GetEntrySize(*lookup->second);
+        m_entries.erase(lookup->second);
+        m_entryLookup.erase(lookup);
+        m_memoryAccount.SetUsage(m_memoryUsage);
+    }
+
+    Entry entry { key, CompressWords(packedCells.data(), packedCells.size()) };
+    const std::size_t entrySize = GetEntrySize(entry);
+
+    // A diagram larger than the whole cache would only evict everything else.
+    if (entrySize > m_memoryCap)
+        return;
+
+    // Over the memory budget, older diagrams make way for it, and it's left out if there still isn't room.
+    while (!m_memoryAccount.Reserve(m_memoryUsage + entrySize, false)) {
+        if (m_entries.empty())
+            return;
+        EvictLeastRecentlyUsed(m_memoryUsage - GetEntrySize(m_entries.back()));
+    }
+
+    m_entries.push_front(std::move(entry));
+    m_entryLookup[key] = m_entries.begin();
+    m_memoryUsage += entrySize;
+
+    EvictLeastRecentlyUsed(m_memoryCap);
+    m_memoryAccount.SetUsage(m_memoryUsage);
+}
+
+void DiagramCache::Clear()
+{
+    m_entries.clear();
+    m_entryLookup.clear();
+    m_memoryUsage = 0;
+    m_memoryAccount.SetUsage(0);
+}
+
+std::size_t DiagramCache::GetEntrySize(const Entry& entry)
+{
+    return sizeof(Entry) + entry.compressedCells.capacity() * sizeof(std::uint64_t);
+}
+
+void DiagramCache::EvictLeastRecentlyUsed(std::size_t memoryLimit)
+{
+    while (m_memoryUsage > memoryLimit && !m_entries.empty()) {
+        const Entry& leastRecentlyUsed = m_entries.back();
+        m_memoryUsage -= GetEntrySize(leastRecentlyUsed);
+        m_entryLookup.erase(leastRecentlyUsed.key);
+        m_entries.pop_back();
+    }
+
+    m_memoryAccount.SetUsage(m_memoryUsage);
+}
@@ -0,0 +1,713 @@
+#include "DiagramFile.h"
+
+#include <algorithm>
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ElementaryKernel.h"
+#include "WordCompression.h"
+
+namespace {
+constexpr char fileMagic[8] = { 'E', 'C', 'A', 'D', 'I', 'A', 'G', 'R' };
+constexpr std::uint32_t fileVersion = 1;
+constexpr std::uint64_t pageSize = 4096;
+
+// Uncompressed blocks are whole rows and large enough to write at full speed, and for rows millions of cells wide
+// to still be stepped many generations at a time by ElementaryRowStepper. Compressed tiles are narrow,
+// so a viewer only decompresses a little more than it shows.
+constexpr std::size_t uncompressedBlockSize = 8 * 1024 * 1024;
+constexpr std::size_t compressedTileSize = 64 * 1024;
+constexpr int compressedTileWords = 64;
+constexpr std::uint32_t maximumRowsPerBlock = 65536;
+
+std::uint64_t RoundUpToPage(std::uint64_t size)
+{
+    return (size + pageSize - 1) / pageSize * pageSize;
+}
+
+bool WriteAll(int file, const void* data, std::size_t size, std::uint64_t offset)
+{
+    const auto* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t written = pwrite(file, bytes, size, static_cast<off_t>(offset));
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return false;
+
+        bytes += written;
+        size -= static_cast<std::size_t>(written);
+        offset += static_cast<std::uint64_t>(written);
+    }
+
+    return true;
+}
+}
+
+DiagramFile::DiagramFile()
+    : m_file(-1)
+    , m_mapping(nullptr)
+    , m_mappingSize(0)
+    , m_isWritable(false)
+    , m_header()
+    , m_wordsPerRow(0)
+    , m_tilesPerBlock(0)
+    , m_numberOfBlocks(0)
+    , m_indexOffset(0)
+    , m_initialRowOffset(0)
+    , m_dataOffset(0)
+    , m_completedGenerations(0)
+    , m_dataEnd(0)
+    , m_generationRate(0.0)
+    , m_isCancelled(false)
+    , m_generation()
+    , m_rowStepper()
+    , m_decompressedTiles()
+    , m_decompressedTileLookup()
+    , m_decompressedTileCap(64 * 1024 * 1024)
+    , m_decompressedTileSize(0)
+    , m_memoryAccount("Diagram file tiles", [this](std::size_t memoryLimit) { EvictDecompressedTiles(memoryLimit); })
+{
+}
+
+DiagramFile::~DiagramFile()
+{
+    Close();
+}
+
+bool DiagramFile::IsSupported()
+{
+    return true;
+}
+
+bool DiagramFile::Create(const std::string& path, int ruleNumber, std::uint64_t startingGeneration, const std::vector<CellState>& initialGeneration,
+    std::uint64_t numberOfGenerations, bool isCompressed)
+{
+    Close();
+
+    if (ruleNumber < 0 || ruleNumber > 255 || initialGeneration.empty() || initialGeneration.size() > static_cast<std::size_t>(std::numeric_limits<int>::max()) || numberOfGenerations == 0)
+        return false;
+
+    const int width = static_cast<int>(initialGeneration.size());
+    const int wordsPerRow = (width - 1) / 64 + 1;
+    const int wordsPerTile = isCompressed ? std::min(wordsPerRow, compressedTileWords) : wordsPerRow;
+    const std::size_t tileRowSize = static_cast<std::size_t>(wordsPerTile) * sizeof(std::uint64_t);
+    const std::size_t rowsPerBlock = (isCompressed ? compressedTileSize : uncompressedBlockSize) / tileRowSize;
+
+    std::memcpy(m_header.magic, fileMagic, sizeof(fileMagic));
+    m_header.version = fileVersion;
+    m_header.ruleNumber = ruleNumber;
+    m_header.startingGeneration = startingGeneration;
+    m_header.numberOfGenerations = numberOfGenerations;
+    m_header.completedGenerations = 0;
+    m_header.numberOfCellsPerGeneration = width;
+    m_header.rowsPerBlock = static_cast<std::uint32_t>(std::clamp<std::size_t>(rowsPerBlock, 1, maximumRowsPerBlock));
+    m_header.wordsPerTile = static_cast<std::uint32_t>(wordsPerTile);
+    m_header.isCompressed = isCompressed ? 1 : 0;
+    ComputeLayout();
+    m_header.dataEnd = m_dataOffset;
+
+    if (numberOfGenerations > (std::numeric_limits<std::uint64_t>::max() - m_dataOffset) / (static_cast<std::uint64_t>(m_wordsPerRow) * sizeof(std::uint64_t)))
+        return false;
+
+    m_file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_file < 0)
+        return false;
+
+    PackedCells initialRow(width, 1);
+    for (int position = 0; position < width; ++position) {
+        initialRow.SetCellState(position, 0, initialGeneration[position]);
+    }
+
+    if (!WriteAll(m_file, &m_header, sizeof(m_header), 0)
+        || !WriteAll(m_file, initialRow.GetRow(0), m_wordsPerRow * sizeof(std::uint64_t), m_initialRowOffset)
+        || !MapFile(true)) {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+bool DiagramFile::Open(const std::string& path)
+{
+    Close();
+
+    // Finished diagrams on read-only storage can still be viewed.
+    bool isWritable = true;
+    m_file = open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (m_file < 0) {
+        isWritable = false;
+        m_file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (m_file < 0)
+            return false;
+    }
+
+    const ssize_t headerSize = pread(m_file, &m_header, sizeof(m_header), 0);
+    const bool isHeaderValid = (headerSize == static_cast<ssize_t>(sizeof(m_header)))
+        && (std::memcmp(m_header.magic, fileMagic, sizeof(fileMagic)) == 0)
+        && (m_header.version == fileVersion)
+        && (m_header.ruleNumber >= 0 && m_header.ruleNumber <= 255)
+        && (m_header.numberOfCellsPerGeneration > 0)
+        && (m_header.numberOfGenerations > 0)
+        && (m_header.completedGenerations <= m_header.numberOfGenerations)
+        && (m_header.rowsPerBlock > 0 && m_header.rowsPerBlock <= maximumRowsPerBlock)
+        && (m_header.wordsPerTile > 0);
+    if (!isHeaderValid) {
+        Close();
+        return false;
+    }
+
+    ComputeLayout();
+
+    // Only whole blocks are ever recorded as complete.
+    const bool isLayoutValid = (static_cast<int>(m_header.wordsPerTile) <= m_wordsPerRow)
+        && (m_header.completedGenerations == m_header.numberOfGenerations || m_header.completedGenerations % m_header.rowsPerBlock == 0)
+        && (m_header.numberOfGenerations <= (std::numeric_limits<std::uint64_t>::max() - m_dataOffset) / (static_cast<std::uint64_t>(m_wordsPerRow) * sizeof(std::uint64_t)))
+        && (m_header.dataEnd >= m_dataOffset);
+    if (!isLayoutValid || !MapFile(isWritable) || !IsTileIndexValid()) {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void DiagramFile::Close()
+{
+    StopGenerating();
+
+    if (m_mapping != nullptr)
+        munmap(m_mapping, m_mappingSize);
+    if (m_file >= 0)
+        close(m_file);
+
+    m_file = -1;
+    m_mapping = nullptr;
+    m_mappingSize = 0;
+    m_isWritable = false;
+    m_header = FileHeader();
+    m_completedGenerations = 0;
+    m_dataEnd = 0;
+    m_generationRate = 0.0;
+    m_decompressedTiles.clear();
+    m_decompressedTileLookup.clear();
+    m_decompressedTileSize = 0;
+    m_memoryAccount.SetUsage(0);
+}
+
+bool DiagramFile::IsOpen() const
+{
+    return m_mapping != nullptr;
+}
+
+void DiagramFile::ComputeLayout()
+{
+    m_wordsPerRow = (m_header.numberOfCellsPerGeneration - 1) / 64 + 1;
+    m_tilesPerBlock = static_cast<int>((m_wordsPerRow + m_header.wordsPerTile - 1) / m_header.wordsPerTile);
+    m_numberOfBlocks = (m_header.numberOfGenerations + m_header.rowsPerBlock - 1) / m_header.rowsPerBlock;
+
+    // The header has a page of its own, then come the tile index and the first generation, then the tiles a block at a time.
+    m_indexOffset = pageSize;
+    m_initialRowOffset = m_indexOffset + m_numberOfBlocks * m_tilesPerBlock * sizeof(TileIndexEntry);
+    m_dataOffset = RoundUpToPage(m_initialRowOffset + m_wordsPerRow * sizeof(std::uint64_t));
+}
+
+bool DiagramFile::MapFile(bool isWritable)
+{
+    struct stat fileStatus;
+    if (fstat(m_file, &fileStatus) != 0)
+        return false;
+
+    // Stored tiles are never larger than the packed rows, so room for all of them is reserved up front, as a sparse file,
+    // and the mapping never has to move while tiles are added.
+    std::uint64_t fileSize = static_cast<std::uint64_t>(fileStatus.st_size);
+    const std::uint64_t reservedSize = m_dataOffset + m_header.numberOfGenerations * m_wordsPerRow * sizeof(std::uint64_t);
+    if (isWritable && m_header.completedGenerations < m_header.numberOfGenerations && fileSize < reservedSize) {
+        if (ftruncate(m_file, static_cast<off_t>(reservedSize)) != 0)
+            return false;
+        fileSize = reservedSize;
+    }
+    if (fileSize < m_header.dataEnd)
+        return false;
+
+    void* mapping = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, m_file, 0);
+    if (mapping == MAP_FAILED)
+        return false;
+
+    // Rows are read a visible region at a time, reading ahead of that would page in cells that are never drawn.
+    if (!m_header.isCompressed)
+        madvise(mapping, fileSize, MADV_RANDOM);
+
+    m_mapping = mapping;
+    m_mappingSize = fileSize;
+    m_isWritable = isWritable;
+    m_completedGenerations = m_header.completedGenerations;
+    m_dataEnd = m_header.dataEnd;
+
+    return true;
+}
+
+int DiagramFile::GetRuleNumber() const
+{
+    return m_header.ruleNumber;
+}
+
+std::uint64_t DiagramFile::GetStartingGeneration() const
+{
+    return m_header.startingGeneration;
+}
+
+int DiagramFile::GetNumberOfCellsPerGeneration() const
+{
+    return m_header.numberOfCellsPerGeneration;
+}
+
+int DiagramFile::GetWordsPerRow() const
+{
+    return m_wordsPerRow;
+}
+
+std::uint64_t DiagramFile::GetNumberOfGenerations() const
+{
+    return m_header.numberOfGenerations;
+}
+
+std::uint64_t DiagramFile::GetNumberOfCompletedGenerations() const
+{
+    return m_completedGenerations.load(std::memory_order_acquire);
+}
+
+bool DiagramFile::IsCompressed() const
+{
+    return m_header.isCompressed != 0;
+}
+
+std::uint64_t DiagramFile::GetFileSize() const
+{
+    return m_dataEnd.load(std::memory_order_relaxed);
+}
+
+bool DiagramFile::StartGenerating()
+{
+    const std::uint64_t completedGenerations = GetNumberOfCompletedGenerations();
+    if (!IsOpen() || !m_isWritable || IsGenerating() || completedGenerations == m_header.numberOfGenerations)
+        return false;
+
+    // Carrying on from an unfinished diagram starts from its last generation.
+    std::vector<std::uint64_t> previousRow(m_wordsPerRow);
+    if (completedGenerations > 0 && !ReadRow(completedGenerations - 1, 0, m_wordsPerRow, previousRow.data()))
+        return false;
+
+    m_isCancelled = false;
+    m_generation = std::async(std::launch::async, &DiagramFile::Generate, this, std::move(previousRow));
+
+    return true;
+}
+
+void DiagramFile::StopGenerating()
+{
+    if (!m_generation.valid())
+        return;
+
+    m_isCancelled = true;
+    m_generation.get();
+}
+
+bool DiagramFile::IsGenerating() const
+{
+    return m_generation.valid() && m_generation.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+double DiagramFile::GetGenerationRate() const
+{
+    return m_generationRate.load(std::memory_order_relaxed);
+}
+
+bool DiagramFile::ReadRow(std::uint64_t generation, int firstWord, int numberOfWords, std::uint64_t* words)
+{
+    if (generation >= GetNumberOfCompletedGenerations() || firstWord < 0 || numberOfWords < 0 || firstWord + numberOfWords > m_wordsPerRow)
+        return false;
+
+    const std::uint64_t block = generation / m_header.rowsPerBlock;
+    const std::size_t rowInBlock = generation % m_header.rowsPerBlock;
+    const int wordsPerTile = static_cast<int>(m_header.wordsPerTile);
+
+    for (int word = firstWord; word < firstWord + numberOfWords;) {
+        const int tileColumn = word / wordsPerTile;
+        const int tileFirstWord = tileColumn * wordsPerTile;
+        const int tileWords = std::min(wordsPerTile, m_wordsPerRow - tileFirstWord);
+        const int wordsToCopy = std::min(firstWord + numberOfWords, tileFirstWord + tileWords) - word;
+
+        const std::uint64_t* tile = GetTile(block, tileColumn);
+        if (tile == nullptr)
+            return false;
+
+        const std::uint64_t* tileRow = tile + rowInBlock * tileWords;
+        std::copy_n(tileRow + (word - tileFirstWord), wordsToCopy, words + (word - firstWord));
+        word += wordsToCopy;
+    }
+
+    return true;
+}
+
+void DiagramFile::SetDecompressedTileCap(std::size_t cap)
+{
+    m_decompressedTileCap = cap;
+    EvictDecompressedTiles(m_decompressedTileCap);
+}
+
+const DiagramFile::TileIndexEntry& DiagramFile::GetTileIndexEntry(std::uint64_t block, int tileColumn) const
+{
+    const auto* index = reinterpret_cast<const TileIndexEntry*>(static_cast<const char*>(m_mapping) + m_indexOffset);
+    return index[block * m_tilesPerBlock + tileColumn];
+}
+
+bool DiagramFile::IsTileIndexValid() const
+{
+    const std::uint64_t numberOfCompletedBlocks = (m_header.completedGenerations + m_header.rowsPerBlock - 1) / m_header.rowsPerBlock;
+    for (std::uint64_t block = 0; block < numberOfCompletedBlocks; ++block) {
+        const std::uint64_t rowsInBlock = std::min<std::uint64_t>(m_header.rowsPerBlock, m_header.numberOfGenerations - block * m_header.rowsPerBlock);
+
+        for (int tileColumn = 0; tileColumn < m_tilesPerBlock; ++tileColumn) {
+            const TileIndexEntry& entry = GetTileIndexEntry(block, tileColumn);
+            const int tileWords = std::min(static_cast<int>(m_header.wordsPerTile), m_wordsPerRow - tileColumn * static_cast<int>(m_header.wordsPerTile));
+            const std::uint64_t storedSize = static_cast<std::uint64_t>(entry.numberOfWords) * sizeof(std::uint64_t);
+
+            // MapFile already checked that the generated data is within the mapping.
+            const bool isEntryValid = (entry.offset >= m_dataOffset && entry.offset % sizeof(std::uint64_t) == 0)
+                && (entry.offset <= m_header.dataEnd && storedSize <= m_header.dataEnd - entry.offset)
+                && (entry.isCompressed == 1 || (entry.isCompressed == 0 && entry.numberOfWords == rowsInBlock * tileWords));
+            if (!isEntryValid)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+const std::uint64_t* DiagramFile::GetTile(std::uint64_t block, int tileColumn)
+{
+    const TileIndexEntry& entry = GetTileIndexEntry(block, tileColumn);
+    const auto* storedWords = reinterpret_cast<const std::uint64_t*>(static_cast<const char*>(m_mapping) + entry.offset);
+    if (!entry.isCompressed)
+        return storedWords;
+
+    const std::uint64_t key = block * m_tilesPerBlock + tileColumn;
+    const auto cachedTile = m_decompressedTileLookup.find(key);
+    if (cachedTile != m_decompressedTileLookup.end()) {
+        m_decompressedTiles.splice(m_decompressedTiles.begin(), m_decompressedTiles, cachedTile->second);
+        return cachedTile->second->second.data();
+    }
+
+    const std::uint64_t rowsInBlock = std::min<std::uint64_t>(m_header.rowsPerBlock, m_header.numberOfGenerations - block * m_header.rowsPerBlock);
+    const int tileWords = std::min(static_cast<int>(m_header.wordsPerTile), m_wordsPerRow - tileColumn * static_cast<int>(m_header.wordsPerTile));
+    std::vector<std::uint64_t> words(rowsInBlock * tileWords);
+    if (!DecompressWords(storedWords, entry.numberOfWords, words.data(), words.size()))
+        return nullptr;
+
+    // Older tiles make room in the budget first, but the tile just read stays cached even when it doesn't fit the cap or the budget on its own.
+    const std::size_t tileSize = words.size() * sizeof(std::uint64_t);
+    while (!m_decompressedTiles.empty() && !m_memoryAccount.Reserve(m_decompressedTileSize + tileSize, false)) {
+        m_decompressedTileSize -= m_decompressedTiles.back().second.size() * sizeof(std::uint64_t);
+        m_decompressedTileLookup.erase(m_decompressedTiles.back().first);
+        m_decompressedTiles.pop_back();
+    }
+
+    m_decompressedTileSize += tileSize;
+    m_decompressedTiles.emplace_front(key, std::move(words));
+    m_decompressedTileLookup[key] = m_decompressedTiles.begin();
+    EvictDecompressedTiles(m_decompressedTileCap);
+
+    return m_decompressedTiles.front().second.data();
+}
+
+void DiagramFile::EvictDecompressedTiles(std::size_t memoryLimit)
+{
+    while (m_decompressedTileSize > memoryLimit && m_decompressedTiles.size() > 1) {
+        m_decompressedTileSize -= m_decompressedTiles.back().second.size() * sizeof(std::uint64_t);
+        m_decompressedTileLookup.erase(m_decompressedTiles.back().first);
+        m_decompressedTiles.pop_back();
+    }
+
+    m_memoryAccount.SetUsage(m_decompressedTileSize);
+}
+
+// Each block is computed while the one before it is being written, so a fast enough disk is the only limit.
+void DiagramFile::Generate(std::vector<std::uint64_t> previousRow)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    const std::uint64_t firstCompletedGeneration = GetNumberOfCompletedGenerations();
+    const std::uint64_t rowsPerBlock = m_header.rowsPerBlock;
+    const std::size_t wordsPerRow = m_wordsPerRow;
+    const int lastWordBits = m_header.numberOfCellsPerGeneration % 64;
+    const std::uint64_t lastWordMask = (lastWordBits == 0) ? ~std::uint64_t(0) : (std::uint64_t(1) << lastWordBits) - 1;
+    const auto* initialRow = reinterpret_cast<const std::uint64_t*>(static_cast<const char*>(m_mapping) + m_initialRowOffset);
+
+    std::vector<std::uint64_t> blockRows[2];
+    std::vector<std::uint64_t> storedWords[2];
+    std::future<bool> pendingWrite;
+    int current = 0;
+
+    for (std::uint64_t block = firstCompletedGeneration / rowsPerBlock; block < m_numberOfBlocks; ++block) {
+        if (m_isCancelled.load(std::memory_order_relaxed))
+            break;
+
+        const std::uint64_t firstGeneration = block * rowsPerBlock;
+        const std::uint64_t numberOfRows = std::min(rowsPerBlock, m_header.numberOfGenerations - firstGeneration);
+        std::vector<std::uint64_t>& rows = blockRows[current];
+        rows.resize(numberOfRows * wordsPerRow);
+
+        if (firstGeneration == 0) {
+            std::copy_n(initialRow, wordsPerRow, rows.data());
+            m_rowStepper.StepRows(rows.data(), rows.data() + wordsPerRow, static_cast<int>(numberOfRows - 1), m_wordsPerRow, lastWordMask, m_header.ruleNumber);
+        } else {
+            m_rowStepper.StepRows(previousRow.data(), rows.data(), static_cast<int>(numberOfRows), m_wordsPerRow, lastWordMask, m_header.ruleNumber);
+        }
+        std::copy_n(rows.data() + (numberOfRows - 1) * wordsPerRow, wordsPerRow, previousRow.data());
+
+        if (pendingWrite.valid() && !pendingWrite.get())
+            return;
+        pendingWrite = std::async(std::launch::async, [this, block, &rows, &stored = storedWords[current]]() { return WriteBlock(block, rows, stored); });
+        current ^= 1;
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+        const std::uint64_t generatedRows = GetNumberOfCompletedGenerations() - firstCompletedGeneration;
+        if (elapsed.count() > 0.0)
+            m_generationRate = generatedRows * wordsPerRow * sizeof(std::uint64_t) / elapsed.count();
+    }
+
+    const bool isWritten = !pendingWrite.valid() || pendingWrite.get();
+
+    // The reserved space past the last tile is given back once the diagram is finished.
+    if (isWritten && GetNumberOfCompletedGenerations() == m_header.numberOfGenerations) {
+        if (ftruncate(m_file, static_cast<off_t>(m_header.dataEnd)) == 0)
+            fdatasync(m_file);
+    }
+}
+
+bool DiagramFile::WriteBlock(std::uint64_t block, const std::vector<std::uint64_t>& rows, std::vector<std::uint64_t>& storedWords)
+{
+    const std::uint64_t blockOffset = m_header.dataEnd;
+    const std::size_t wordsPerRow = m_wordsPerRow;
+    const std::size_t numberOfRows = rows.size() / wordsPerRow;
+    std::vector<TileIndexEntry> entries(m_tilesPerBlock);
+
+    // Uncompressed blocks are a single tile of whole rows, which is just the rows as they are.
+    const std::uint64_t* blockWords = rows.data();
+    std::size_t blockSize = rows.size();
+    if (!m_header.isCompressed) {
+        entries[0] = TileIndexEntry { blockOffset, static_cast<std::uint32_t>(rows.size()), 0 };
+    } else {
+        storedWords.clear();
+        std::vector<std::uint64_t> tile;
+        for (int tileColumn = 0; tileColumn < m_tilesPerBlock; ++tileColumn) {
+            const std::size_t tileFirstWord = static_cast<std::size_t>(tileColumn) * m_header.wordsPerTile;
+            const std::size_t tileWords = std::min<std::size_t>(m_header.wordsPerTile, wordsPerRow - tileFirstWord);
+
+            tile.resize(numberOfRows * tileWords);
+            for (std::size_t row = 0; row < numberOfRows; ++row) {
+                std::copy_n(rows.data() + row * wordsPerRow + tileFirstWord, tileWords, tile.data() + row * tileWords);
+            }
+
+            // Tiles that don't shrink are stored as they are, so no tile is ever larger than its rows.
+            const auto compressedTile = CompressWords(tile.data(), tile.size());
+            const bool isCompressed = compressedTile.size() < tile.size();
+            const auto& tileToStore = isCompressed ? compressedTile : tile;
+
+            entries[tileColumn] = TileIndexEntry { blockOffset + storedWords.size() * sizeof(std::uint64_t), static_cast<std::uint32_t>(tileToStore.size()), isCompressed ? 1u : 0u };
+            storedWords.insert(storedWords.end(), tileToStore.begin(), tileToStore.end());
+        }
+
+        blockWords = storedWords.data();
+        blockSize = storedWords.size();
+    }
+
+    const std::size_t blockBytes = blockSize * sizeof(std::uint64_t);
+    if (!WriteAll(m_file, blockWords, blockBytes, blockOffset)
+        || !WriteAll(m_file, entries.data(), entries.size() * sizeof(TileIndexEntry), m_indexOffset + block * m_tilesPerBlock * sizeof(TileIndexEntry)))
+        return false;
+
+    // The tiles have to be in the file before the header says they're complete.
+    m_header.completedGenerations = std::min<std::uint64_t>((block + 1) * m_header.rowsPerBlock, m_header.numberOfGenerations);
+    m_header.dataEnd = blockOffset + blockBytes;
+    if (!WriteAll(m_file, &m_header, sizeof(m_header), 0))
+        return false;
+
+    // Writing back every block as soon as it's written, and waiting for the block before it, keeps dirty pages from piling up,
+    // and dropping the written pages keeps a diagram larger than memory from pushing everything else out of the page cache.
+    sync_file_range(m_file, static_cast<off64_t>(blockOffset), static_cast<off64_t>(blockBytes), SYNC_FILE_RANGE_WRITE);
+    if (blockOffset > m_dataOffset) {
+        const std::uint64_t previousBlockOffset = GetTileIndexEntry(block - 1, 0).offset;
+        const std::uint64_t previousBlockBytes = blockOffset - previousBlockOffset;
+        sync_file_range(m_file, static_cast<off64_t>(previousBlockOffset), static_cast<off64_t>(previousBlockBytes),
+            SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        posix_fadvise(m_file, static_cast<off_t>(previousBlockOffset), static_cast<off_t>(previousBlockBytes), POSIX_FADV_DONTNEED);
+    }
+
+    m_dataEnd.store(m_header.dataEnd, std::memory_order_relaxed);
+    m_completedGenerations.store(m_header.completedGenerations, std::memory_order_release);
+
+    return true;
+}
+
+#else
+
+// Memory-mapped files and sync_file_range are only used on Linux, elsewhere diagrams always stay in memory.
+DiagramFile::DiagramFile()
+    : m_file(-1)
+    , m_mapping(nullptr)
+    , m_mappingSize(0)
+    , m_isWritable(false)
+    , m_header()
+    , m_wordsPerRow(0)
+    , m_tilesPerBlock(0)
+    , m_numberOfBlocks(0)
+    , m_indexOffset(0)
+    , m_initialRowOffset(0)
+    , m_dataOffset(0)
+    , m_completedGenerations(0)
+    , m_dataEnd(0)
+    , m_generationRate(0.0)
+    , m_isCancelled(false)
+    , m_generation()
+    , m_rowStepper()
+    , m_decompressedTiles()
+    , m_decompressedTileLookup()
+    , m_decompressedTileCap(0)
+    , m_decompressedTileSize(0)
+    , m_memoryAccount("Diagram file tiles")
+{
+}
+
+DiagramFile::~DiagramFile() = default;
+
+bool DiagramFile::IsSupported()
+{
+    return false;
+}
+
+bool DiagramFile::Create(const std::string&, int, std::uint64_t, const std::vector<CellState>&, std::uint64_t, bool)
+{
+    return false;
+}
+
+bool DiagramFile::Open(const std::string&)
+{
+    return false;
+}
+
+void DiagramFile::Close() { }
+
+bool DiagramFile::IsOpen() const
+{
+    return false;
+}
+
+void DiagramFile::ComputeLayout() { }
+
+bool DiagramFile::MapFile(bool)
+{
+    return false;
+}
+
+int DiagramFile::GetRuleNumber() const
+{
+    return 0;
+}
+
+std::uint64_t DiagramFile::GetStartingGeneration() const
+{
+    return 0;
+}
+
+int DiagramFile::GetNumberOfCellsPerGeneration() const
+{
+    return 0;
+}
+
+int DiagramFile::GetWordsPerRow() const
+{
+    return 0;
+}
+
+std::uint64_t DiagramFile::GetNumberOfGenerations() const
+{
+    return 0;
+}
+
+std::uint64_t DiagramFile::GetNumberOfCompletedGenerations() const
+{
+    return 0;
+}
+
+bool DiagramFile::IsCompressed() const
+{
+    return false;
+}
+
+std::uint64_t DiagramFile::GetFileSize() const
+{
+    return 0;
+}
+
+bool DiagramFile::StartGenerating()
+{
+    return false;
+}
+
+void DiagramFile::StopGenerating() { }
+
+bool DiagramFile::IsGenerating() const
+{
+    return false;
+}
+
+double DiagramFile::GetGenerationRate() const
+{
+    return 0.0;
+}
+
+bool DiagramFile::ReadRow(std::uint64_t, int, int, std::uint64_t*)
+{
+    return false;
+}
+
+void DiagramFile::SetDecompressedTileCap(std::size_t) { }
+
+const DiagramFile::TileIndexEntry& DiagramFile::GetTileIndexEntry(std::uint64_t, int) const
+{
+    static const TileIndexEntry emptyEntry {};
+    return emptyEntry;
+}
+
+bool DiagramFile::IsTileIndexValid() const
+{
+    return false;
+}
+
+const std::uint64_t* DiagramFile::GetTile(std::uint64_t, int)
+{
+    return nullptr;
+}
+
+void DiagramFile::EvictDecompressedTiles(std::size_t) { }
+
+void DiagramFile::Generate(std::vector<std::uint64_t>) { }
+
+bool DiagramFile::WriteBlock(std::uint64_t, const std::vector<std::uint64_t>&, std::vector<std::uint64_t>&)
+{
+    return false;
+}
+
+#endif
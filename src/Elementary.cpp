@@ -1,15 +1,70 @@
 #include "Elementary.h"
+#include "ElementaryKernel.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+// Generations a preview computes between checking whether it's been cancelled and publishing its progress.
+constexpr int previewGenerationsPerBatch = 64;
+
+std::size_t GetDiagramSize(int numberOfCellsPerGeneration, int numberOfGenerations)
+{
+    return static_cast<std::size_t>((numberOfCellsPerGeneration + 63) / 64) * numberOfGenerations * sizeof(std::uint64_t);
+}
+
+// An additive rule computes: new cell = constant ^ (left & l) ^ (centre & c) ^ (right & r).
+struct AdditiveCoefficients {
+    bool isAdditive = true;
+    bool constant = false;
+    bool left = false;
+    bool centre = false;
+    bool right = false;
+};
+
+AdditiveCoefficients GetAdditiveCoefficients(int ruleNumber)
+{
+    const auto ruleOutput = [&](int neighbourhood) { return ((ruleNumber >> neighbourhood) & 1) != 0; };
+
+    AdditiveCoefficients coefficients;
+    coefficients.constant = ruleOutput(0b000);
+    coefficients.left = ruleOutput(0b100) != coefficients.constant;
+    coefficients.centre = ruleOutput(0b010) != coefficients.constant;
+    coefficients.right = ruleOutput(0b001) != coefficients.constant;
+
+    for (int neighbourhood = 0; neighbourhood < 8; ++neighbourhood) {
+        bool expected = coefficients.constant;
+        expected ^= coefficients.left && (neighbourhood & 0b100);
+        expected ^= coefficients.centre && (neighbourhood & 0b010);
+        expected ^= coefficients.right && (neighbourhood & 0b001);
+
+        if (ruleOutput(neighbourhood) != expected)
+            coefficients.isAdditive = false;
+    }
+
+    return coefficients;
+}
+}
 
 // Default ruleset is rule 90. (https://mathworld.wolfram.com/ElementaryCellularAutomaton.html)
 Elementary::Elementary()
-    : m_cellMap()
+    : m_cells()
     , m_ruleset("01011010")
+    , m_generatedKey { -1, 0, 0, 0 }
+    , m_cellsVersion(0)
     , m_numberOfCellsPerGeneration(200)
-    , m_numberOfGenerations(500) {}
+    , m_numberOfGenerations(500)
+    , m_startingGeneration(0)
+    , m_diagramCache()
+    , m_memoryAccount("Elementary diagram")
+    , m_rowStepper()
+    , m_previewJob()
+    , m_previewFuture()
+    , m_cancelledPreviews() {}
 
-const std::map<ImVec2, CellState>& Elementary::GetCellMap() const
+Elementary::~Elementary()
 {
-    return m_cellMap;
+    CancelPreview();
 }
 
 int Elementary::GetNumberOfCellsPerGeneration() const
@@ -21,16 +76,36 @@ int Elementary::GetNumberOfGenerations() const
     return m_numberOfGenerations;
 }
 
-CellState Elementary::GetCellState(ImVec2 cell) const
+CellState Elementary::GetCellState(int position, int generation) const
 {
-    if (m_cellMap.find(cell) != m_cellMap.end()) {
-        auto state = m_cellMap.at(cell);
-        return state;
-    }
+    return m_cells.GetCellState(position, generation);
+}
+
+std::uint64_t Elementary::GetStartingGeneration() const
+{
+    return m_startingGeneration;
+}
 
-    else {
-        return CellState::inactive;
+DiagramCache& Elementary::GetDiagramCache()
+{
+    return m_diagramCache;
+}
+
+int Elementary::GetRuleNumber() const
+{
+    // Position 0 of m_ruleset is the rule for neighbourhood "111", position 7 is the rule for "000".
+    int ruleNumber = 0;
+    for (int position = 0; position < 8; ++position) {
+        if (m_ruleset.test(position))
+            ruleNumber |= 1 << (7 - position);
     }
+
+    return ruleNumber;
+}
+
+bool Elementary::IsAdditiveRule() const
+{
+    return GetAdditiveCoefficients(GetRuleNumber()).isAdditive;
 }
 
 std::bitset<8>& Elementary::SetRuleset()
@@ -38,152 +113,366 @@ std::bitset<8>& Elementary::SetRuleset()
     return m_ruleset;
 }
 
-void Elementary::SetNumberOfCellsPerGeneration(int input)
+bool Elementary::SetNumberOfCellsPerGeneration(int input)
 {
-    if (input > 0)
-        m_numberOfCellsPerGeneration = input;
+    if (input <= 0 || (input != m_numberOfCellsPerGeneration && !ReserveDiagram(input, m_numberOfGenerations)))
+        return false;
+
+    m_numberOfCellsPerGeneration = input;
+    return true;
 }
 
-void Elementary::SetNumberOfGenerations(int input)
+bool Elementary::SetNumberOfGenerations(int input)
 {
-    if (input > 0)
-        m_numberOfGenerations = input;
+    if (input <= 0 || (input != m_numberOfGenerations && !ReserveDiagram(m_numberOfCellsPerGeneration, input)))
+        return false;
+
+    m_numberOfGenerations = input;
+    return true;
 }
 
-bool Elementary::SetSingleCellState(ImVec2 cell, CellState state)
+bool Elementary::SetSingleCellState(int position, int generation, CellState state)
 {
-    if (m_cellMap.find(cell) != m_cellMap.end()) {
-        m_cellMap[cell] = state;
-        return true;
-    } else {
-        return false;
+    m_generatedKey.ruleNumber = -1;
+    ++m_cellsVersion;
+    return m_cells.SetCellState(position, generation, state);
+}
+
+void Elementary::SetStartingGeneration(std::uint64_t generation)
+{
+    m_startingGeneration = std::min(generation, maximumStartingGeneration);
+}
+
+std::vector<CellState> Elementary::GetInitialGeneration(int numberOfCellsPerGeneration) const
+{
+    std::vector<CellState> generation(numberOfCellsPerGeneration, CellState::inactive);
+    generation[numberOfCellsPerGeneration / 2] = CellState::active;
+
+    return generation;
+}
+
+// Brute-force reference step, cells outside the generation are inactive just like in SetAllCellStates().
+std::vector<CellState> Elementary::StepGeneration(const std::vector<CellState>& generation) const
+{
+    const int width = static_cast<int>(generation.size());
+    const auto isActive = [&](int position) {
+        return position >= 0 && position < width && generation[position] == CellState::active;
+    };
+
+    std::vector<CellState> nextGeneration(width);
+    for (int position = 0; position < width; ++position) {
+        const int neighbourhood = (isActive(position - 1) << 2) | (isActive(position) << 1) | isActive(position + 1);
+        nextGeneration[position] = static_cast<CellState>(m_ruleset.test(7 - neighbourhood));
     }
+
+    return nextGeneration;
 }
 
-void Elementary::GenerateCells(CellState state = CellState::inactive)
+std::vector<CellState> Elementary::ComputeGeneration(std::uint64_t generation) const
 {
-    m_cellMap.clear();
+    return ComputeGeneration(generation, m_numberOfCellsPerGeneration);
+}
 
-    for (int generation = 0; generation < m_numberOfGenerations; ++generation) {
-        for (int position = 0; position < m_numberOfCellsPerGeneration; ++position) {
-            ImVec2 cell = ImVec2(static_cast<float>(position), static_cast<float>(generation));
-            m_cellMap.insert(std::make_pair(cell, state));
+std::vector<CellState> Elementary::ComputeGeneration(std::uint64_t generation, int numberOfCellsPerGeneration) const
+{
+    const auto coefficients = GetAdditiveCoefficients(GetRuleNumber());
+
+    if (!coefficients.isAdditive) {
+        auto cells = GetInitialGeneration(numberOfCellsPerGeneration);
+        for (std::uint64_t step = 0; step < generation; ++step) {
+            cells = StepGeneration(cells);
+        }
+
+        return cells;
+    }
+
+    // Over GF(2), applying an additive rule 2^k times is the same rule with the neighbours 2^k cells away (Lucas's theorem),
+    // so generation t is reached by applying one such step per set bit of t.
+    // Symmetric rules are mirrored about the always inactive cells at -1 and width, which gives a periodic row of length 2 * (width + 1)
+    // that evolves exactly like the bounded one. One-sided rules never read past the edge opposite to the side they depend on.
+    const std::int64_t width = numberOfCellsPerGeneration;
+    const std::int64_t period = 2 * (width + 1);
+    const bool isMirrored = (coefficients.left == coefficients.right);
+
+    const auto cellAt = [&](const std::vector<std::uint8_t>& cells, std::int64_t position) -> std::uint8_t {
+        if (isMirrored) {
+            const std::int64_t index = (((position + 1) % period) + period) % period;
+            if (index == 0 || index == width + 1)
+                return 0;
+
+            return (index <= width) ? cells[index - 1] : cells[period - index - 1];
+        }
+
+        return (position >= 0 && position < width) ? cells[position] : 0;
+    };
+
+    // Applies the linear part of the rule 'distance' generations at once, where distance is a power of two.
+    const auto applyLinearPart = [&](const std::vector<std::uint8_t>& cells, std::int64_t distance) {
+        std::vector<std::uint8_t> result(cells.size());
+        for (std::int64_t position = 0; position < width; ++position) {
+            std::uint8_t value = 0;
+            if (coefficients.left)
+                value ^= cellAt(cells, position - distance);
+            if (coefficients.centre)
+                value ^= cells[position];
+            if (coefficients.right)
+                value ^= cellAt(cells, position + distance);
+            result[position] = value;
+        }
+
+        return result;
+    };
+
+    std::vector<std::uint8_t> cells(width, 0);
+    cells[width / 2] = 1;
+
+    // Complemented rules also add the sum of L^i(1) over the skipped generations, which doubles alongside the distance.
+    std::vector<std::uint8_t> constantPart(width, coefficients.constant ? 1 : 0);
+
+    for (std::int64_t distance = 1; generation != 0; generation >>= 1, distance <<= 1) {
+        if (generation & 1) {
+            cells = applyLinearPart(cells, distance);
+            for (std::int64_t position = 0; position < width; ++position) {
+                cells[position] ^= constantPart[position];
+            }
+        }
+
+        if (coefficients.constant && generation > 1) {
+            const auto shiftedConstantPart = applyLinearPart(constantPart, distance);
+            for (std::int64_t position = 0; position < width; ++position) {
+                constantPart[position] ^= shiftedConstantPart[position];
+            }
         }
     }
+
+    std::vector<CellState> result(width);
+    for (std::int64_t position = 0; position < width; ++position) {
+        result[position] = static_cast<CellState>(cells[position] != 0);
+    }
+
+    return result;
+}
+
+void Elementary::GenerateCells(CellState state = CellState::inactive)
+{
+    m_cells = PackedCells(m_numberOfCellsPerGeneration, m_numberOfGenerations);
+    m_cells.Fill(state);
+    m_generatedKey.ruleNumber = -1;
+    ++m_cellsVersion;
 }
 
 void Elementary::SetAllCellStates()
 {
-    for (auto& [cell, state] : m_cellMap) {
-        // Excludes cells(x, 0) as this is the initial generation that contains a single active cell.
-        if (cell.y != 0) {
-            std::bitset<3> previousCells("000");
-
-            // Note that bitset reads from right to left, so 0 position is the furthest right bit.
-            ImVec2 prev_cell_0 = ImVec2(cell.x + 1, cell.y - 1);
-            ImVec2 prev_cell_1 = ImVec2(cell.x, cell.y - 1);
-            ImVec2 prev_cell_2 = ImVec2(cell.x - 1, cell.y - 1);
-
-            // Checks previous neighbour cells' states, which determines the current cell's state based on the rule bitset (m_ruleset).
-            const CellState defaultState = CellState::inactive;
-            const CellState& state_0 = (m_cellMap.find(prev_cell_0) != m_cellMap.end()) ? m_cellMap.at(prev_cell_0) : defaultState;
-            const CellState& state_1 = (m_cellMap.find(prev_cell_1) != m_cellMap.end()) ? m_cellMap.at(prev_cell_1) : defaultState;
-            const CellState& state_2 = (m_cellMap.find(prev_cell_2) != m_cellMap.end()) ? m_cellMap.at(prev_cell_2) : defaultState;
-
-            if (state_0 == CellState::active)
-                previousCells[0].flip();
-            if (state_1 == CellState::active)
-                previousCells[1].flip();
-            if (state_2 == CellState::active)
-                previousCells[2].flip();
-
-            // For comparison using a switch statement.
-            auto neighbourCellsState = previousCells.to_string();
-
-            // This is the table that specifies a cell's state given its previous state, and the states of the cells to the left & right.
-            const std::string rulePosition_0 = "111";
-            const std::string rulePosition_1 = "110";
-            const std::string rulePosition_2 = "101";
-            const std::string rulePosition_3 = "100";
-            const std::string rulePosition_4 = "011";
-            const std::string rulePosition_5 = "010";
-            const std::string rulePosition_6 = "001";
-            const std::string rulePosition_7 = "000";
-
-            // Can't switch on a string, so they're mapped to ints instead.
-            const std::map<std::string, int> ruleMap = {
-                { rulePosition_0, 0 },
-                { rulePosition_1, 1 },
-                { rulePosition_2, 2 },
-                { rulePosition_3, 3 },
-                { rulePosition_4, 4 },
-                { rulePosition_5, 5 },
-                { rulePosition_6, 6 },
-                { rulePosition_7, 7 }
-            };
-
-            switch (ruleMap.at(neighbourCellsState)) {
-            case 0: {
-                state = static_cast<CellState>(m_ruleset.test(0));
-                break;
-            }
-            case 1: {
-                state = static_cast<CellState>(m_ruleset.test(1));
-                break;
-            }
-            case 2: {
-                state = static_cast<CellState>(m_ruleset.test(2));
-                break;
-            }
-            case 3: {
-                state = static_cast<CellState>(m_ruleset.test(3));
-                break;
-            }
-            case 4: {
-                state = static_cast<CellState>(m_ruleset.test(4));
-                break;
-            }
-            case 5: {
-                state = static_cast<CellState>(m_ruleset.test(5));
-                break;
-            }
-            case 6: {
-                state = static_cast<CellState>(m_ruleset.test(6));
-                break;
-            }
-            case 7: {
-                state = static_cast<CellState>(m_ruleset.test(7));
-                break;
-            }
-            }
+    // Excludes generation 0 as this is the initial generation.
+    SetCellStatesFrom(1);
+}
+
+void Elementary::SetCellStatesFrom(int firstGeneration)
+{
+    firstGeneration = std::max(firstGeneration, 1);
+    if (firstGeneration >= m_cells.GetHeight())
+        return;
+
+    ++m_cellsVersion;
+    m_rowStepper.StepRows(m_cells.GetRow(firstGeneration - 1), m_cells.GetRow(firstGeneration), m_cells.GetHeight() - firstGeneration,
+        m_cells.GetWordsPerRow(), m_cells.GetLastWordMask(), GetRuleNumber());
+}
+
+bool Elementary::CreateDiagramFile(DiagramFile& diagramFile, const std::string& path, int numberOfCellsPerGeneration, std::uint64_t numberOfGenerations, bool isCompressed) const
+{
+    if (numberOfCellsPerGeneration <= 0)
+        return false;
+
+    const std::uint64_t startingGeneration = GetCurrentKey().startingGeneration;
+    return diagramFile.Create(path, GetRuleNumber(), startingGeneration, ComputeGeneration(startingGeneration, numberOfCellsPerGeneration), numberOfGenerations, isCompressed);
+}
+
+std::uint64_t Elementary::GetCellsVersion() const
+{
+    return m_cellsVersion;
+}
+
+const PackedCells& Elementary::GetCells() const
+{
+    return m_previewJob ? m_previewJob->cells : m_cells;
+}
+
+PackedCellsView Elementary::GetCellsView() const
+{
+    const PackedCells& cells = GetCells();
+    return cells.GetView().GetTile(0, 0, cells.GetWidth(), GetNumberOfComputedGenerations());
+}
+
+int Elementary::GetNumberOfComputedGenerations() const
+{
+    // A running preview has only finished some of its generations so far.
+    return m_previewJob ? m_previewJob->completedGenerations.load(std::memory_order_acquire) : m_cells.GetHeight();
+}
+
+DiagramKey Elementary::GetCurrentKey() const
+{
+    // Jumping ahead is only instant for additive rules, every other rule starts from the single active cell.
+    const std::uint64_t startingGeneration = IsAdditiveRule() ? m_startingGeneration : 0;
+
+    return DiagramKey { GetRuleNumber(), m_numberOfCellsPerGeneration, m_numberOfGenerations, startingGeneration };
+}
+
+bool Elementary::IsGeneratedDiagramExtendableTo(const DiagramKey& key) const
+{
+    return (key.ruleNumber == m_generatedKey.ruleNumber)
+        && (key.numberOfCellsPerGeneration == m_generatedKey.numberOfCellsPerGeneration)
+        && (key.startingGeneration == m_generatedKey.startingGeneration);
+}
+
+void Elementary::GenerateElementaryAutomata()
+{
+    CancelPreview();
+
+    const DiagramKey key = GetCurrentKey();
+    const bool isExtendable = IsGeneratedDiagramExtendableTo(key);
+
+    if (isExtendable && key.numberOfGenerations == m_generatedKey.numberOfGenerations)
+        return;
+
+    std::vector<std::uint64_t> packedCells;
+    if (m_diagramCache.Find(key, packedCells)) {
+        m_cells = PackedCells(m_numberOfCellsPerGeneration, m_numberOfGenerations);
+        m_cells.GetWords() = std::move(packedCells);
+        ++m_cellsVersion;
+    } else if (isExtendable) {
+        // Only the number of generations changed, so existing generations are kept and only new ones are computed.
+        const int generatedGenerations = m_cells.GetHeight();
+        m_cells.Resize(m_numberOfCellsPerGeneration, m_numberOfGenerations);
+        SetCellStatesFrom(generatedGenerations);
+        m_diagramCache.Insert(key, m_cells.GetWords());
+    } else {
+        GenerateCells();
+
+        const auto initialGeneration = ComputeGeneration(key.startingGeneration);
+        for (int position = 0; position < m_numberOfCellsPerGeneration; ++position) {
+            m_cells.SetCellState(position, 0, initialGeneration[position]);
         }
+
+        SetAllCellStates();
+        m_diagramCache.Insert(key, m_cells.GetWords());
     }
+
+    m_generatedKey = key;
+    UpdateMemoryUsage();
 }
 
-void Elementary::DrawCells()
+void Elementary::UpdatePreview()
 {
-    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    // A finished preview becomes the current diagram.
+    if (m_previewJob && m_previewFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        m_previewFuture.get();
+        m_cells = std::move(m_previewJob->cells);
+        m_generatedKey = m_previewJob->key;
+        m_diagramCache.Insert(m_generatedKey, m_cells.GetWords());
+        m_previewJob.reset();
+        ++m_cellsVersion;
+    }
+    UpdateMemoryUsage();
+
+    m_cancelledPreviews.erase(std::remove_if(m_cancelledPreviews.begin(), m_cancelledPreviews.end(),
+                                  [](const std::future<void>& preview) { return preview.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }),
+        m_cancelledPreviews.end());
+
+    const DiagramKey key = GetCurrentKey();
+    const DiagramKey& latestKey = m_previewJob ? m_previewJob->key : m_generatedKey;
+    if (key == latestKey)
+        return;
+
+    // The rule or size changed again, so whatever is running is stale.
+    CancelPreview();
+    ++m_cellsVersion;
+
+    std::vector<std::uint64_t> packedCells;
+    if (m_diagramCache.Find(key, packedCells)) {
+        m_cells = PackedCells(key.numberOfCellsPerGeneration, key.numberOfGenerations);
+        m_cells.GetWords() = std::move(packedCells);
+        m_generatedKey = key;
+        return;
+    }
+
+    const bool isExtendable = IsGeneratedDiagramExtendableTo(key);
+    if (isExtendable && key.numberOfGenerations <= m_cells.GetHeight()) {
+        m_cells.Resize(key.numberOfCellsPerGeneration, key.numberOfGenerations);
+        m_generatedKey = key;
+        return;
+    }
 
-    draw_list->PushClipRect(m_min_canvas_position, m_max_canvas_position, true);
+    auto job = std::make_shared<PreviewJob>();
+    job->key = key;
+    job->isCancelled = false;
 
-    const ImVec2 origin = ImVec2(m_min_canvas_position.x + m_grid_scrolling.x, m_min_canvas_position.y + m_grid_scrolling.y);
-    draw_list->AddRect(origin, ImVec2(origin.x + (m_numberOfCellsPerGeneration * m_grid_steps), origin.y + (m_numberOfGenerations * m_grid_steps)), m_cell_colour_main);
+    // Existing generations are copied over so that only the new ones are computed.
+    int firstGeneration = 1;
+    if (isExtendable) {
+        firstGeneration = m_cells.GetHeight();
+        job->cells = m_cells;
+        job->cells.Resize(key.numberOfCellsPerGeneration, key.numberOfGenerations);
+    } else {
+        job->cells = PackedCells(key.numberOfCellsPerGeneration, key.numberOfGenerations);
 
-    for (const auto& [cell, state] : m_cellMap) {
-        if (state == CellState::active) {
-            const ImVec2 cell_pos_i = ImVec2(origin.x + (cell.x * m_grid_steps), origin.y + (cell.y * m_grid_steps));
-            const ImVec2 cell_pos_f = ImVec2(cell_pos_i.x + m_grid_steps, cell_pos_i.y + m_grid_steps);
-            draw_list->AddRectFilled(cell_pos_i, cell_pos_f, m_cell_colour_main);
+        const auto initialGeneration = ComputeGeneration(key.startingGeneration);
+        for (int position = 0; position < key.numberOfCellsPerGeneration; ++position) {
+            job->cells.SetCellState(position, 0, initialGeneration[position]);
         }
     }
+    job->completedGenerations = firstGeneration;
+
+    // Generations depend on the one above them, so they are computed from the top and appear in the order they are drawn.
+    m_previewJob = job;
+    m_previewFuture = std::async(std::launch::async, [job, firstGeneration, &rowStepper = m_rowStepper]() {
+        PackedCells& cells = job->cells;
+        for (int generation = firstGeneration; generation < cells.GetHeight(); generation += previewGenerationsPerBatch) {
+            if (job->isCancelled.load(std::memory_order_relaxed))
+                return;
 
-    draw_list->PopClipRect();
+            const int numberOfGenerations = std::min(previewGenerationsPerBatch, cells.GetHeight() - generation);
+            rowStepper.StepRows(cells.GetRow(generation - 1), cells.GetRow(generation), numberOfGenerations, cells.GetWordsPerRow(), cells.GetLastWordMask(), job->key.ruleNumber);
+            job->completedGenerations.store(generation + numberOfGenerations, std::memory_order_release);
+        }
+    });
+    UpdateMemoryUsage();
 }
 
-void Elementary::GenerateElementaryAutomata()
+bool Elementary::IsPreviewRunning() const
+{
+    return m_previewJob != nullptr;
+}
+
+float Elementary::GetPreviewProgress() const
 {
-    GenerateCells();
-    const float startPoint = static_cast<float>(m_numberOfCellsPerGeneration) / 2.0f;
-    SetSingleCellState(ImVec2(startPoint, 0), CellState::active);
-    SetAllCellStates();
+    if (!m_previewJob || m_previewJob->key.numberOfGenerations == 0)
+        return 1.0f;
+
+    return static_cast<float>(m_previewJob->completedGenerations.load(std::memory_order_relaxed)) / m_previewJob->key.numberOfGenerations;
+}
+
+void Elementary::UpdateMemoryUsage()
+{
+    const std::size_t previewSize = m_previewJob ? m_previewJob->cells.GetWords().capacity() * sizeof(std::uint64_t) : 0;
+    m_memoryAccount.SetUsage(m_cells.GetWords().capacity() * sizeof(std::uint64_t) + previewSize);
+}
+
+bool Elementary::ReserveDiagram(int numberOfCellsPerGeneration, int numberOfGenerations)
+{
+    // Smaller diagrams are always allowed, so that a diagram can still be made to fit a budget that was lowered under it.
+    const std::size_t currentSize = GetDiagramSize(m_cells.GetWidth(), m_cells.GetHeight());
+    const std::size_t diagramSize = GetDiagramSize(numberOfCellsPerGeneration, numberOfGenerations);
+
+    return diagramSize <= currentSize || m_memoryAccount.Reserve(currentSize + diagramSize);
+}
+
+void Elementary::CancelPreview()
+{
+    if (!m_previewJob)
+        return;
+
+    m_previewJob->isCancelled = true;
+    m_cancelledPreviews.push_back(std::move(m_previewFuture));
+    m_previewJob.reset();
+    ++m_cellsVersion;
 }
@@ -0,0 +1,108 @@
+#include "ElementaryKernel.h"
+
+#include <algorithm>
+
+namespace {
+// A one word halo keeps a chunk exact for this many generations.
+constexpr int generationsPerCopy = 64;
+// Narrower chunks would spend more time waiting and copying than stepping.
+constexpr int minimumWordsPerChunk = 256;
+}
+
+// The rule is split on the left and centre cells into four functions of the right cell, each of which is
+// its value for an inactive right cell xor'ed with the difference where the right cell is active.
+// Those are then selected between by the centre and left cells, so every word takes the same dozen or so operations whatever the rule.
+void StepElementaryRow(const std::uint64_t* previous, std::uint64_t* next, int wordsPerRow, std::uint64_t lastWordMask, int ruleNumber)
+{
+    const auto ruleMask = [ruleNumber](int neighbourhood) { return ((ruleNumber >> neighbourhood) & 1) ? ~std::uint64_t(0) : 0; };
+    const std::uint64_t inactiveInactive = ruleMask(0b000);
+    const std::uint64_t inactiveActive = ruleMask(0b010);
+    const std::uint64_t activeInactive = ruleMask(0b100);
+    const std::uint64_t activeActive = ruleMask(0b110);
+    const std::uint64_t inactiveInactiveDifference = inactiveInactive ^ ruleMask(0b001);
+    const std::uint64_t inactiveActiveDifference = inactiveActive ^ ruleMask(0b011);
+    const std::uint64_t activeInactiveDifference = activeInactive ^ ruleMask(0b101);
+    const std::uint64_t activeActiveDifference = activeActive ^ ruleMask(0b111);
+
+    const auto nextWord = [&](std::uint64_t left, std::uint64_t centre, std::uint64_t right) {
+        const std::uint64_t leftInactiveCentreInactive = inactiveInactive ^ (inactiveInactiveDifference & right);
+        const std::uint64_t leftInactiveCentreActive = inactiveActive ^ (inactiveActiveDifference & right);
+        const std::uint64_t leftActiveCentreInactive = activeInactive ^ (activeInactiveDifference & right);
+        const std::uint64_t leftActiveCentreActive = activeActive ^ (activeActiveDifference & right);
+
+        const std::uint64_t leftInactive = leftInactiveCentreInactive ^ ((leftInactiveCentreInactive ^ leftInactiveCentreActive) & centre);
+        const std::uint64_t leftActive = leftActiveCentreInactive ^ ((leftActiveCentreInactive ^ leftActiveCentreActive) & centre);
+
+        return leftInactive ^ ((leftInactive ^ leftActive) & left);
+    };
+
+    // Cells outside the row are inactive, so the first and last words are stepped apart from the rest.
+    if (wordsPerRow == 1) {
+        next[0] = nextWord(previous[0] << 1, previous[0], previous[0] >> 1) & lastWordMask;
+        return;
+    }
+
+    next[0] = nextWord(previous[0] << 1, previous[0], (previous[0] >> 1) | (previous[1] << 63));
+    for (int word = 1; word + 1 < wordsPerRow; ++word) {
+        next[word] = nextWord((previous[word] << 1) | (previous[word - 1] >> 63), previous[word], (previous[word] >> 1) | (previous[word + 1] << 63));
+    }
+
+    const int lastWord = wordsPerRow - 1;
+    next[lastWord] = nextWord((previous[lastWord] << 1) | (previous[lastWord - 1] >> 63), previous[lastWord], previous[lastWord] >> 1) & lastWordMask;
+}
+
+ElementaryRowStepper::ElementaryRowStepper(int numberOfThreads)
+    : m_workerPool(numberOfThreads)
+    , m_chunkRows()
+    , m_stepMutex()
+{
+}
+
+ElementaryRowStepper::~ElementaryRowStepper() = default;
+
+int ElementaryRowStepper::GetNumberOfThreads() const
+{
+    return m_workerPool.GetNumberOfThreads();
+}
+
+void ElementaryRowStepper::StepRows(const std::uint64_t* previous, std::uint64_t* rows, int numberOfRows, int wordsPerRow, std::uint64_t lastWordMask, int ruleNumber)
+{
+    std::lock_guard<std::mutex> stepLock(m_stepMutex);
+
+    const std::size_t rowStride = wordsPerRow;
+    const int numberOfChunks = std::min(m_workerPool.GetNumberOfThreads(), wordsPerRow / minimumWordsPerChunk);
+    if (numberOfChunks <= 1) {
+        for (int row = 0; row < numberOfRows; ++row) {
+            StepElementaryRow((row == 0) ? previous : rows + (row - 1) * rowStride, rows + row * rowStride, wordsPerRow, lastWordMask, ruleNumber);
+        }
+        return;
+    }
+
+    m_chunkRows.resize(numberOfChunks);
+    for (int firstRow = 0; firstRow < numberOfRows; firstRow += generationsPerCopy) {
+        const std::uint64_t* source = (firstRow == 0) ? previous : rows + (firstRow - 1) * rowStride;
+        const int numberOfChunkRows = std::min(generationsPerCopy, numberOfRows - firstRow);
+
+        m_workerPool.RunChunks(numberOfChunks, [&](int chunk) {
+            const int firstWord = static_cast<int>(static_cast<std::int64_t>(wordsPerRow) * chunk / numberOfChunks);
+            const int lastWord = static_cast<int>(static_cast<std::int64_t>(wordsPerRow) * (chunk + 1) / numberOfChunks);
+            // The halo is cut off at the ends of the row, where cells outside are inactive anyway.
+            const int copyFirstWord = std::max(0, firstWord - 1);
+            const int copyLastWord = std::min(wordsPerRow, lastWord + 1);
+            const int copyWords = copyLastWord - copyFirstWord;
+            const std::uint64_t copyLastWordMask = (copyLastWord == wordsPerRow) ? lastWordMask : ~std::uint64_t(0);
+
+            std::vector<std::uint64_t>& chunkRows = m_chunkRows[chunk];
+            chunkRows.resize(2 * static_cast<std::size_t>(copyWords));
+            std::uint64_t* current = chunkRows.data();
+            std::uint64_t* next = current + copyWords;
+            std::copy_n(source + copyFirstWord, copyWords, current);
+
+            for (int row = firstRow; row < firstRow + numberOfChunkRows; ++row) {
+                StepElementaryRow(current, next, copyWords, copyLastWordMask, ruleNumber);
+                std::copy_n(next + (firstWord - copyFirstWord), lastWord - firstWord, rows + row * rowStride + firstWord);
+                std::swap(current, next);
+            }
+        });
+    }
+}
@@ -1,62 +1,110 @@
 #include "GameOfLife.h"
+#include "LifeKernel.h"
 
-#include <chrono>
-#include <cmath>
+#include <algorithm>
 #include <future>
 #include <thread>
 
+namespace {
+// Edits are tracked in tiles of this many cells square, one word wide.
+constexpr int editTileSize = 64;
+}
+
 GameOfLife::GameOfLife()
-    : m_cellMap()
-    , m_gridDimensions(150.0f, 150.0f) {}
+    : m_cells(150, 150)
+    , m_nextCells(150, 150)
+    , m_rule(LifeRule::Conway())
+    , m_isLargerThanLife(false)
+    , m_largerThanLifeRule(LargerThanLifeRule::Bosco())
+    , m_generationsPerFrame(1)
+    , m_engineTuner()
+    , m_generation(0)
+    , m_cellsVersion(0)
+    , m_isPaused(false)
+    , m_isRecordingHistory(true)
+    , m_history()
+    , m_slabWorkers()
+    , m_isPinnedToCpus(false)
+    , m_editQueue()
+    , m_queuedEdits()
+    , m_editedTiles()
+    , m_memoryAccount("Game of Life")
+{
+    UpdateMemoryUsage();
+    RecordHistory();
+}
 
-ImVec2 GameOfLife::GetGameDimensions()
+int GameOfLife::GetWidth() const
 {
-    return m_gridDimensions;
+    return m_cells.GetWidth();
 }
 
-void GameOfLife::SetGameDimensions(ImVec2 dimensions)
+int GameOfLife::GetHeight() const
 {
-    if (dimensions.x > 0 && dimensions.y > 0) {
-        m_gridDimensions.x = std::trunc(dimensions.x);
-        m_gridDimensions.y = std::trunc(dimensions.y);
+    return m_cells.GetHeight();
+}
+
+bool GameOfLife::SetGameDimensions(int width, int height)
+{
+    if (width > 0 && height > 0) {
+        if (width == m_cells.GetWidth() && height == m_cells.GetHeight())
+            return true;
+
+        if (!ReserveMemory(EstimateMemoryUsage(width, height, m_slabWorkers != nullptr, GetSteppedLargerThanLifeRule()), width, height, m_isRecordingHistory))
+            return false;
+
+        m_engineTuner.Retune();
+        FetchCellsFromWorkers();
+        m_cells.Resize(width, height);
+
+        // The shared universe has a fixed size, so the workers start over with the resized one.
+        // If they can't, the universe carries on being stepped in this process from m_cells.
+        if (m_slabWorkers) {
+            if (m_slabWorkers->Start(m_cells.GetWidth(), m_cells.GetHeight(), m_slabWorkers->GetNumberOfWorkers(), m_isPinnedToCpus)) {
+                m_slabWorkers->SetRule(m_rule);
+                PublishCellsToWorkers();
+            } else {
+                m_slabWorkers.reset();
+            }
+        }
+
+        UpdateMemoryUsage();
+        RecordHistory();
+        return true;
     }
+
+    return false;
 }
 
-std::map<ImVec2, CellState>& GameOfLife::GetCellMap()
+PackedCellsView GameOfLife::GetCellsView() const
 {
-    return m_cellMap;
+    return PackedCellsView(GetCurrentWords(), m_cells.GetWidth(), m_cells.GetHeight(), m_cells.GetWordsPerRow());
 }
 
 void GameOfLife::GenerateEmptyCells()
 {
-    m_cellMap.clear();
-    for (int x = 0; x < m_gridDimensions.x; ++x) {
-        for (int y = 0; y < m_gridDimensions.y; ++y) {
-            ImVec2 cell = ImVec2(x, y);
-            CellState state = CellState::inactive;
-            m_cellMap.insert(std::make_pair(cell, state));
-        }
-    }
+    m_cells = PackedCells(m_cells.GetWidth(), m_cells.GetHeight());
+    m_generation = 0;
+    m_engineTuner.Retune();
+    PublishCellsToWorkers();
+    RecordHistory();
 }
 
 void GameOfLife::GenerateRandomCells()
 {
-    m_cellMap.clear();
+    GenerateEmptyCells();
     // Time returns # of seconds since Jan 1st, 1970, making rand() seem truly random unless called within the same second.
     std::srand(static_cast<int>(time(0)));
 
-    for (int x = 0; x < m_gridDimensions.x; ++x) {
-        for (int y = 0; y < m_gridDimensions.y; ++y) {
-            ImVec2 cell = ImVec2(x, y);
-            CellState state;
-
+    for (int x = 0; x < m_cells.GetWidth(); ++x) {
+        for (int y = 0; y < m_cells.GetHeight(); ++y) {
             if (rand() % 2)
-                state = CellState::active;
-            else
-                state = CellState::inactive;
-            m_cellMap.insert(std::make_pair(cell, state));
+                m_cells.SetCellState(x, y, CellState::active);
         }
     }
+
+    PublishCellsToWorkers();
+    RecordHistory();
 }
 
 void GameOfLife::GeneratePattern(Pattern pattern)
@@ -67,13 +115,13 @@ void GameOfLife::GeneratePattern(Pattern pattern)
     const auto StringPatternToCells = [&](const std::string& inputString) {
         int gridRow = 0;
         int gridColumn = 0;
-        std::vector<ImVec2> cellsToWrite;
-        ImVec2 startPoint = ImVec2(m_gridDimensions.x / 3, m_gridDimensions.y / 2);
+        std::vector<CellCoordinates> cellsToWrite;
+        const CellCoordinates startPoint = { m_cells.GetWidth() / 3, m_cells.GetHeight() / 2 };
         for (const auto& stringCell : inputString) {
             ++gridRow;
 
             if (stringCell == '#') {
-                cellsToWrite.push_back(ImVec2(startPoint.x + gridRow, startPoint.y + gridColumn));
+                cellsToWrite.push_back(CellCoordinates { startPoint.x + gridRow, startPoint.y + gridColumn });
             } else if (stringCell == '\n') {
                 gridRow = 0;
                 ++gridColumn;
@@ -83,15 +131,9 @@ void GameOfLife::GeneratePattern(Pattern pattern)
         return cellsToWrite;
     };
 
-    auto cellTester = [&](const std::vector<ImVec2>& inputVector) {
-        for (auto& [cell, state] : m_cellMap) {
-            for (auto& testCell : inputVector) {
-                if (m_cellMap.find(testCell) != m_cellMap.end()) {
-                    // Sigh need to overload "==" for ImVec2... or switch to std::pair.
-                    if (cell.x == testCell.x && cell.y == testCell.y)
-                        state = CellState::active;
-                }
-            }
+    auto cellTester = [&](const std::vector<CellCoordinates>& inputVector) {
+        for (const auto& testCell : inputVector) {
+            m_cells.SetCellState(testCell.x, testCell.y, CellState::active);
         }
     };
 
@@ -131,125 +173,401 @@ void GameOfLife::GeneratePattern(Pattern pattern)
         break;
     }
     }
+
+    PublishCellsToWorkers();
+    RecordHistory();
 }
 
-bool GameOfLife::SetSingleCellState(ImVec2 cell, CellState state)
+bool GameOfLife::SetSingleCellState(int x, int y, CellState state)
 {
-    if (m_cellMap.find(cell) != m_cellMap.end()) {
-        m_cellMap[cell] = state;
-        return true;
-    } else {
+    if (x < 0 || y < 0 || x >= m_cells.GetWidth() || y >= m_cells.GetHeight())
         return false;
+
+    ApplyEdits({ CellEdit { x, y, 1, state } });
+    return true;
+}
+
+CellEditQueue& GameOfLife::GetEditQueue()
+{
+    return m_editQueue;
+}
+
+bool GameOfLife::ApplyQueuedEdits()
+{
+    m_queuedEdits.clear();
+    if (m_editQueue.PopAll(m_queuedEdits) == 0)
+        return false;
+
+    ApplyEdits(m_queuedEdits);
+    return true;
+}
+
+// Only the edited tiles' rows are copied from and back to the worker processes, rather than the whole universe.
+void GameOfLife::ApplyEdits(const std::vector<CellEdit>& edits)
+{
+    const int width = m_cells.GetWidth();
+    const int height = m_cells.GetHeight();
+    const int tilesPerRow = m_cells.GetWordsPerRow();
+    const int tileRows = (height + editTileSize - 1) / editTileSize;
+    m_editedTiles.assign(static_cast<std::size_t>(tilesPerRow) * tileRows, 0);
+
+    const auto clip = [&](const CellEdit& edit, int& firstX, int& lastX) {
+        firstX = std::max(edit.x, 0);
+        lastX = static_cast<int>(std::min<long long>(static_cast<long long>(edit.x) + edit.length, width));
+        return edit.y >= 0 && edit.y < height && firstX < lastX;
+    };
+
+    bool isAnyTileEdited = false;
+    for (const auto& edit : edits) {
+        int firstX = 0;
+        int lastX = 0;
+        if (!clip(edit, firstX, lastX))
+            continue;
+
+        for (int tile = firstX / 64; tile <= (lastX - 1) / 64; ++tile) {
+            m_editedTiles[static_cast<std::size_t>(edit.y / editTileSize) * tilesPerRow + tile] = 1;
+        }
+        isAnyTileEdited = true;
+    }
+
+    if (!isAnyTileEdited)
+        return;
+
+    // Bands of consecutive tile rows with an edited tile.
+    std::vector<std::pair<int, int>> editedRows;
+    for (int tileRow = 0; tileRow < tileRows; ++tileRow) {
+        const auto rowTiles = m_editedTiles.begin() + static_cast<std::ptrdiff_t>(tileRow) * tilesPerRow;
+        if (std::find(rowTiles, rowTiles + tilesPerRow, 1) == rowTiles + tilesPerRow)
+            continue;
+
+        const int firstRow = tileRow * editTileSize;
+        const int lastRow = std::min(height, firstRow + editTileSize);
+        if (!editedRows.empty() && editedRows.back().second == firstRow)
+            editedRows.back().second = lastRow;
+        else
+            editedRows.emplace_back(firstRow, lastRow);
+    }
+
+    if (m_slabWorkers) {
+        for (const auto& rows : editedRows)
+            m_slabWorkers->DownloadRows(m_cells, rows.first, rows.second);
     }
+
+    for (const auto& edit : edits) {
+        int firstX = 0;
+        int lastX = 0;
+        if (!clip(edit, firstX, lastX))
+            continue;
+
+        std::uint64_t* row = m_cells.GetRow(edit.y);
+        for (int word = firstX / 64; word <= (lastX - 1) / 64; ++word) {
+            const int firstBit = std::max(firstX - word * 64, 0);
+            const int lastBit = std::min(lastX - word * 64, 64);
+            const std::uint64_t mask = (lastBit == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << lastBit) - 1) & (~std::uint64_t(0) << firstBit);
+            if (edit.state == CellState::active)
+                row[word] |= mask;
+            else
+                row[word] &= ~mask;
+        }
+    }
+
+    if (m_slabWorkers) {
+        for (const auto& rows : editedRows)
+            m_slabWorkers->UploadRows(m_cells, rows.first, rows.second);
+    }
+
+    RecordHistory();
 }
 
-CellState GameOfLife::GetCellState(ImVec2 cell)
+CellState GameOfLife::GetCellState(int x, int y) const
 {
-    if (m_cellMap.find(cell) != m_cellMap.end()) {
-        const auto state = m_cellMap.at(cell);
-        return state;
-    } else {
+    if (x < 0 || y < 0 || x >= m_cells.GetWidth() || y >= m_cells.GetHeight())
         return CellState::inactive;
-    }
+
+    return static_cast<CellState>((GetCurrentWords()[static_cast<std::size_t>(y) * m_cells.GetWordsPerRow() + x / 64] >> (x % 64)) & 1);
 }
+
 void GameOfLife::SetAllCellStates()
 {
-    // Buffer as I can't read and write to the cellMap at the same time, as the cells written to affect the next cells.
-    std::map<ImVec2, CellState> cellMapBuffer;
-
-    // Can't pass by reference for the above reason. Expensive copy!
-    for (auto [cell, state] : m_cellMap) {
-        //Cell positions relative to the current cell (C).
-        /*
-		0 1 2
-		3 C 4
-		5 6 7
-		*/
-        ImVec2 prev_cell_0 = ImVec2(cell.x - 1, cell.y - 1);
-        ImVec2 prev_cell_1 = ImVec2(cell.x + 0, cell.y - 1);
-        ImVec2 prev_cell_2 = ImVec2(cell.x + 1, cell.y - 1);
-        ImVec2 prev_cell_3 = ImVec2(cell.x - 1, cell.y + 0);
-        ImVec2 prev_cell_4 = ImVec2(cell.x + 1, cell.y + 0);
-        ImVec2 prev_cell_5 = ImVec2(cell.x - 1, cell.y + 1);
-        ImVec2 prev_cell_6 = ImVec2(cell.x + 0, cell.y + 1);
-        ImVec2 prev_cell_7 = ImVec2(cell.x + 1, cell.y + 1);
-
-        // Checks previous neighbour cells' states
-        CellState defaultState = CellState::inactive;
-        CellState& state_0 = (m_cellMap.find(prev_cell_0) != m_cellMap.end()) ? m_cellMap.at(prev_cell_0) : defaultState;
-        CellState& state_1 = (m_cellMap.find(prev_cell_1) != m_cellMap.end()) ? m_cellMap.at(prev_cell_1) : defaultState;
-        CellState& state_2 = (m_cellMap.find(prev_cell_2) != m_cellMap.end()) ? m_cellMap.at(prev_cell_2) : defaultState;
-        CellState& state_3 = (m_cellMap.find(prev_cell_3) != m_cellMap.end()) ? m_cellMap.at(prev_cell_3) : defaultState;
-        CellState& state_4 = (m_cellMap.find(prev_cell_4) != m_cellMap.end()) ? m_cellMap.at(prev_cell_4) : defaultState;
-        CellState& state_5 = (m_cellMap.find(prev_cell_5) != m_cellMap.end()) ? m_cellMap.at(prev_cell_5) : defaultState;
-        CellState& state_6 = (m_cellMap.find(prev_cell_6) != m_cellMap.end()) ? m_cellMap.at(prev_cell_6) : defaultState;
-        CellState& state_7 = (m_cellMap.find(prev_cell_7) != m_cellMap.end()) ? m_cellMap.at(prev_cell_7) : defaultState;
-
-        int numberOfActiveNeighbours = 0;
-        if (state_0 == CellState::active)
-            ++numberOfActiveNeighbours;
-        if (state_1 == CellState::active)
-            ++numberOfActiveNeighbours;
-        if (state_2 == CellState::active)
-            ++numberOfActiveNeighbours;
-        if (state_3 == CellState::active)
-            ++numberOfActiveNeighbours;
-        if (state_4 == CellState::active)
-            ++numberOfActiveNeighbours;
-        if (state_5 == CellState::active)
-            ++numberOfActiveNeighbours;
-        if (state_6 == CellState::active)
-            ++numberOfActiveNeighbours;
-        if (state_7 == CellState::active)
-            ++numberOfActiveNeighbours;
-
-        switch (state) {
-        case (CellState::active): {
-            if (numberOfActiveNeighbours < 2) // Cell dies by underpopulation.
-                state = CellState::inactive;
-            else if (numberOfActiveNeighbours == 2 || numberOfActiveNeighbours == 3) // Cell is happy and lives on :)
-                state = CellState::active;
-            else if (numberOfActiveNeighbours > 3) // Cell dies by overpopulation.
-                state = CellState::inactive;
-            break;
-        }
-        case (CellState::inactive): {
-            if (numberOfActiveNeighbours == 3) // Cells reproduce to create a live cell.
-                state = CellState::active;
-            break;
-        }
+    ApplyQueuedEdits();
+
+    // Every generation has to be recorded, so recording steps them one at a time.
+    const int generationsPerStep = m_isRecordingHistory ? 1 : m_generationsPerFrame;
+    for (int generation = 0; generation < m_generationsPerFrame; generation += generationsPerStep) {
+        StepGenerations(generationsPerStep);
+        m_generation += generationsPerStep;
+        RecordHistory();
+    }
+}
+
+void GameOfLife::StepGenerations(int generations)
+{
+    if (m_isLargerThanLife) {
+        FetchCellsFromWorkers();
+        if (m_nextCells.GetWidth() != m_cells.GetWidth() || m_nextCells.GetHeight() != m_cells.GetHeight())
+            m_nextCells = PackedCells(m_cells.GetWidth(), m_cells.GetHeight());
+
+        for (int generation = 0; generation < generations; ++generation) {
+            StepLargerThanLife(m_cells, m_nextCells, m_largerThanLifeRule);
+            std::swap(m_cells, m_nextCells);
         }
 
-        cellMapBuffer.insert(std::make_pair(cell, state));
+        PublishCellsToWorkers();
+        return;
+    }
+
+    if (m_slabWorkers) {
+        int generation = 0;
+        while (generation < generations && m_slabWorkers->Step())
+            ++generation;
+        if (generation == generations)
+            return;
+
+        // A worker couldn't be restarted, so the rest of the generations and every one after them are stepped in this process.
+        FetchCellsFromWorkers();
+        m_slabWorkers.reset();
+        UpdateMemoryUsage();
+        generations -= generation;
     }
 
-    m_cellMap = cellMapBuffer;
+    // Can't read and write the same cells at once, as the cells written to affect the next cells.
+    if (m_nextCells.GetWidth() != m_cells.GetWidth() || m_nextCells.GetHeight() != m_cells.GetHeight())
+        m_nextCells = PackedCells(m_cells.GetWidth(), m_cells.GetHeight());
+
+    m_engineTuner.Step(m_cells, m_nextCells, generations, m_rule);
+}
+
+void GameOfLife::SetRule(const LifeRule& rule)
+{
+    if (rule != m_rule)
+        m_engineTuner.Retune();
+
+    m_rule = rule;
+    if (m_slabWorkers)
+        m_slabWorkers->SetRule(rule);
 }
 
-void GameOfLife::DrawCells()
+const LifeRule& GameOfLife::GetRule() const
 {
-    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    return m_rule;
+}
 
-    const ImVec2 origin = ImVec2(m_min_canvas_position.x + m_grid_scrolling.x, m_min_canvas_position.y + m_grid_scrolling.y);
+bool GameOfLife::SetLargerThanLife(bool isLargerThanLife)
+{
+    if (isLargerThanLife == m_isLargerThanLife)
+        return true;
 
-    draw_list->PushClipRect(m_min_canvas_position, m_max_canvas_position, true);
-    draw_list->AddRect(origin, ImVec2(origin.x + (m_gridDimensions.x * m_grid_steps), origin.y + (m_gridDimensions.y * m_grid_steps)), IM_COL32(200, 200, 200, 255));
+    if (isLargerThanLife && !ReserveMemory(EstimateMemoryUsage(m_cells.GetWidth(), m_cells.GetHeight(), m_slabWorkers != nullptr, &m_largerThanLifeRule), m_cells.GetWidth(), m_cells.GetHeight(), m_isRecordingHistory))
+        return false;
 
-    for (const auto& [cell, state] : m_cellMap) {
-        if (state == CellState::active) {
-            const ImVec2 cell_pos_i = ImVec2(origin.x + (cell.x * m_grid_steps), origin.y + (cell.y * m_grid_steps));
-            const ImVec2 cell_pos_f = ImVec2(cell_pos_i.x + m_grid_steps, cell_pos_i.y + m_grid_steps);
+    m_isLargerThanLife = isLargerThanLife;
+    UpdateMemoryUsage();
+    return true;
+}
 
-            draw_list->AddRectFilled(cell_pos_i, cell_pos_f, m_cell_colour_main);
-        }
+bool GameOfLife::IsLargerThanLife() const
+{
+    return m_isLargerThanLife;
+}
+
+bool GameOfLife::SetLargerThanLifeRule(const LargerThanLifeRule& rule)
+{
+    if (m_isLargerThanLife && !ReserveMemory(EstimateMemoryUsage(m_cells.GetWidth(), m_cells.GetHeight(), m_slabWorkers != nullptr, &rule), m_cells.GetWidth(), m_cells.GetHeight(), m_isRecordingHistory))
+        return false;
+
+    m_largerThanLifeRule = rule;
+    UpdateMemoryUsage();
+    return true;
+}
+
+const LargerThanLifeRule& GameOfLife::GetLargerThanLifeRule() const
+{
+    return m_largerThanLifeRule;
+}
+
+int GameOfLife::GetWordsPerRow() const
+{
+    return m_cells.GetWordsPerRow();
+}
+
+std::uint64_t GameOfLife::GetCellsVersion() const
+{
+    return m_cellsVersion;
+}
+
+void GameOfLife::SetGenerationsPerFrame(int generationsPerFrame)
+{
+    generationsPerFrame = std::max(1, generationsPerFrame);
+    if (generationsPerFrame != m_generationsPerFrame)
+        m_engineTuner.Retune();
+
+    m_generationsPerFrame = generationsPerFrame;
+}
+
+int GameOfLife::GetGenerationsPerFrame() const
+{
+    return m_generationsPerFrame;
+}
+
+LifeEngineTuner& GameOfLife::GetEngineTuner()
+{
+    return m_engineTuner;
+}
+
+std::uint64_t GameOfLife::GetGeneration() const
+{
+    return m_generation;
+}
+
+void GameOfLife::SetPaused(bool isPaused)
+{
+    m_isPaused = isPaused;
+}
+
+bool GameOfLife::IsPaused() const
+{
+    return m_isPaused;
+}
+
+bool GameOfLife::SetRecordingHistory(bool isRecordingHistory)
+{
+    if (isRecordingHistory == m_isRecordingHistory)
+        return true;
+
+    if (isRecordingHistory && !ReserveMemory(EstimateMemoryUsage(m_cells.GetWidth(), m_cells.GetHeight(), m_slabWorkers != nullptr, GetSteppedLargerThanLifeRule()), m_cells.GetWidth(), m_cells.GetHeight(), true))
+        return false;
+
+    m_isRecordingHistory = isRecordingHistory;
+    m_engineTuner.Retune();
+    m_history.Clear();
+    RecordHistory();
+    return true;
+}
+
+bool GameOfLife::IsRecordingHistory() const
+{
+    return m_isRecordingHistory;
+}
+
+const LifeHistory& GameOfLife::GetHistory() const
+{
+    return m_history;
+}
+
+void GameOfLife::SetHistoryMemoryBudget(std::size_t memoryBudget)
+{
+    m_history.SetMemoryBudget(memoryBudget);
+}
+
+bool GameOfLife::SeekGeneration(std::uint64_t generation)
+{
+    // Later generations are kept until the universe is stepped or edited from here, so the timeline can be scrubbed both ways.
+    if (!m_history.Seek(generation, m_cells))
+        return false;
+
+    m_generation = generation;
+    ++m_cellsVersion;
+    PublishCellsToWorkers();
+    return true;
+}
+
+// Called after every change to the cells, whether or not they're recorded.
+void GameOfLife::RecordHistory()
+{
+    ++m_cellsVersion;
+    if (!m_isRecordingHistory)
+        return;
+
+    // Anything recorded after this generation belongs to a timeline that has just been replaced.
+    if (m_generation == 0)
+        m_history.Clear();
+    else
+        m_history.Truncate(m_generation - 1);
+
+    m_history.Record(m_generation, GetCurrentWords(), m_cells.GetWidth(), m_cells.GetHeight());
+}
+
+bool GameOfLife::SetNumberOfWorkerProcesses(int numberOfWorkers, bool isPinnedToCpus)
+{
+    if (numberOfWorkers == GetNumberOfWorkerProcesses() && isPinnedToCpus == m_isPinnedToCpus)
+        return true;
+
+    FetchCellsFromWorkers();
+    m_slabWorkers.reset();
+    m_isPinnedToCpus = isPinnedToCpus;
+
+    UpdateMemoryUsage();
+
+    if (numberOfWorkers <= 1 || !SlabWorkers::IsSupported())
+        return numberOfWorkers <= 1;
+
+    if (!ReserveMemory(EstimateMemoryUsage(m_cells.GetWidth(), m_cells.GetHeight(), true, GetSteppedLargerThanLifeRule()), m_cells.GetWidth(), m_cells.GetHeight(), m_isRecordingHistory))
+        return false;
+
+    m_slabWorkers = std::make_unique<SlabWorkers>();
+    if (!m_slabWorkers->Start(m_cells.GetWidth(), m_cells.GetHeight(), numberOfWorkers, isPinnedToCpus)) {
+        m_slabWorkers.reset();
+        return false;
     }
 
-    draw_list->PopClipRect();
+    m_slabWorkers->SetRule(m_rule);
+
+    PublishCellsToWorkers();
+    UpdateMemoryUsage();
+    return true;
+}
+
+int GameOfLife::GetNumberOfWorkerProcesses() const
+{
+    return m_slabWorkers ? m_slabWorkers->GetNumberOfWorkers() : 1;
+}
+
+int GameOfLife::GetNumberOfWorkerRestarts() const
+{
+    return m_slabWorkers ? m_slabWorkers->GetNumberOfRestarts() : 0;
+}
+
+const std::uint64_t* GameOfLife::GetCurrentWords() const
+{
+    return m_slabWorkers ? m_slabWorkers->GetCurrentCells() : m_cells.GetWords().data();
+}
+
+std::size_t GameOfLife::EstimateMemoryUsage(int width, int height, bool isUsingWorkers, const LargerThanLifeRule* steppedLargerThanLifeRule) const
+{
+    const std::size_t cellsSize = static_cast<std::size_t>((width + 63) / 64) * height * sizeof(std::uint64_t);
+    const std::size_t editTilesSize = static_cast<std::size_t>((width + editTileSize - 1) / editTileSize) * ((height + editTileSize - 1) / editTileSize);
+    const std::size_t largerThanLifeSize = steppedLargerThanLifeRule ? EstimateLargerThanLifeMemoryUsage(width, height, *steppedLargerThanLifeRule) : 0;
+
+    return (isUsingWorkers ? 4 : 2) * cellsSize + editTilesSize + CellEditQueue::defaultCapacity * sizeof(CellEdit) + largerThanLifeSize;
+}
+
+bool GameOfLife::ReserveMemory(std::size_t usage, int width, int height, bool isRecordingHistory)
+{
+    // The history lets go of its old copies before making the new ones, so only the difference has to fit.
+    const std::size_t copiesSize = isRecordingHistory ? LifeHistory::EstimateCopiesSize(width, height) : 0;
+    const std::size_t historyGrowth = copiesSize - std::min(copiesSize, m_history.GetCopiesSize());
+
+    return m_memoryAccount.Reserve(usage + historyGrowth);
 }
 
-void GameOfLife::GenerateGameOfLife()
+const LargerThanLifeRule* GameOfLife::GetSteppedLargerThanLifeRule() const
 {
-    SetAllCellStates();
-    DrawGrid();
-    DrawCells();
-}
\ No newline at end of file
+    return m_isLargerThanLife ? &m_largerThanLifeRule : nullptr;
+}
+
+void GameOfLife::UpdateMemoryUsage()
+{
+    m_memoryAccount.SetUsage(EstimateMemoryUsage(m_cells.GetWidth(), m_cells.GetHeight(), m_slabWorkers != nullptr, GetSteppedLargerThanLifeRule()));
+}
+
+void GameOfLife::FetchCellsFromWorkers()
+{
+    if (m_slabWorkers)
+        m_slabWorkers->DownloadCells(m_cells);
+}
+
+void GameOfLife::PublishCellsToWorkers()
+{
+    if (m_slabWorkers)
+        m_slabWorkers->UploadCells(m_cells);
+}
@@ -0,0 +1,345 @@
+#include "Generations.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+namespace {
+// Finds the live cells, state 1, of words [0, numberOfWords) of every plane.
+template <int numberOfPlanes>
+void FindLiveCells(const std::array<const std::uint64_t*, numberOfPlanes>& planes, std::uint64_t* liveCells, std::size_t numberOfWords)
+{
+    for (std::size_t word = 0; word < numberOfWords; ++word) {
+        std::uint64_t isLive = planes[0][word];
+        for (int plane = 1; plane < numberOfPlanes; ++plane) {
+            isLive &= ~planes[plane][word];
+        }
+        liveCells[word] = isLive;
+    }
+}
+
+// Moves every cell to its next state. Cells the Life-like rule makes live are born if dead or survive if live,
+// and every other cell that isn't dead counts up one state, decaying back to dead after the last one.
+template <int numberOfPlanes>
+void UpdatePlanes(const std::array<std::uint64_t*, numberOfPlanes>& planes, const std::uint64_t* liveCells, const std::uint64_t* nextLiveCells,
+    std::size_t numberOfWords, int numberOfStates)
+{
+    for (std::size_t word = 0; word < numberOfWords; ++word) {
+        std::uint64_t isNotDead = 0;
+        for (int plane = 0; plane < numberOfPlanes; ++plane) {
+            isNotDead |= planes[plane][word];
+        }
+
+        // Decaying cells can't be born again until they're dead.
+        const std::uint64_t isNextLive = nextLiveCells[word] & (~isNotDead | liveCells[word]);
+        const std::uint64_t isDecaying = isNotDead & ~isNextLive;
+
+        // Adds one to the state of decaying cells with a ripple carry through the planes. A state that reaches the number
+        // of states is dead again, and when that's a power of two the carry out of the top plane already makes it zero.
+        std::array<std::uint64_t, numberOfPlanes> nextPlanes;
+        std::uint64_t carry = isDecaying;
+        std::uint64_t isPastLastState = isDecaying;
+        for (int plane = 0; plane < numberOfPlanes; ++plane) {
+            nextPlanes[plane] = planes[plane][word] ^ carry;
+            carry &= planes[plane][word];
+            isPastLastState &= ((numberOfStates >> plane) & 1) ? nextPlanes[plane] : ~nextPlanes[plane];
+        }
+
+        const std::uint64_t isStillDecaying = isDecaying & ~isPastLastState;
+        planes[0][word] = isNextLive | (nextPlanes[0] & isStillDecaying);
+        for (int plane = 1; plane < numberOfPlanes; ++plane) {
+            planes[plane][word] = nextPlanes[plane] & isStillDecaying;
+        }
+    }
+}
+
+template <int numberOfPlanes>
+void FindLiveCells(const std::vector<PackedCells>& planes, PackedCells& liveCells)
+{
+    std::array<const std::uint64_t*, numberOfPlanes> planeWords;
+    for (int plane = 0; plane < numberOfPlanes; ++plane) {
+        planeWords[plane] = planes[plane].GetWords().data();
+    }
+
+    FindLiveCells<numberOfPlanes>(planeWords, liveCells.GetWords().data(), liveCells.GetWords().size());
+}
+
+template <int numberOfPlanes>
+void UpdatePlanes(std::vector<PackedCells>& planes, const PackedCells& liveCells, const PackedCells& nextLiveCells, int numberOfStates)
+{
+    std::array<std::uint64_t*, numberOfPlanes> planeWords;
+    for (int plane = 0; plane < numberOfPlanes; ++plane) {
+        planeWords[plane] = planes[plane].GetWords().data();
+    }
+
+    UpdatePlanes<numberOfPlanes>(planeWords, liveCells.GetWords().data(), nextLiveCells.GetWords().data(), liveCells.GetWords().size(), numberOfStates);
+}
+}
+
+GenerationsRule GenerationsRule::BriansBrain()
+{
+    return GenerationsRule { 1 << 2, 0, 3 };
+}
+
+GenerationsRule GenerationsRule::StarWars()
+{
+    return GenerationsRule { 1 << 2, (1 << 3) | (1 << 4) | (1 << 5), 4 };
+}
+
+bool GenerationsRule::Parse(const std::string& ruleString, GenerationsRule& rule)
+{
+    // The number of states is last, the rest is a Life-like rule.
+    const std::size_t statesStart = ruleString.find_last_of("Cc");
+    if (statesStart == std::string::npos || statesStart == 0 || ruleString[statesStart - 1] != '/')
+        return false;
+
+    const std::string states = ruleString.substr(statesStart + 1);
+    if (states.empty() || states.size() > 2 || !std::all_of(states.begin(), states.end(), [](char character) { return character >= '0' && character <= '9'; }))
+        return false;
+
+    const int numberOfStates = std::stoi(states);
+    LifeRule lifeRule {};
+    if (numberOfStates < 2 || numberOfStates > maximumNumberOfStates || !LifeRule::Parse(ruleString.substr(0, statesStart - 1), lifeRule))
+        return false;
+
+    rule = GenerationsRule { lifeRule.birth, lifeRule.survival, numberOfStates };
+    return true;
+}
+
+std::string GenerationsRule::ToString() const
+{
+    return LifeRule { birth, survival }.ToString() + "/C" + std::to_string(numberOfStates);
+}
+
+int GenerationsRule::GetNumberOfPlanes() const
+{
+    int numberOfPlanes = 1;
+    while ((1 << numberOfPlanes) < numberOfStates) {
+        ++numberOfPlanes;
+    }
+
+    return numberOfPlanes;
+}
+
+bool GenerationsRule::operator==(const GenerationsRule& other) const
+{
+    return birth == other.birth && survival == other.survival && numberOfStates == other.numberOfStates;
+}
+
+bool GenerationsRule::operator!=(const GenerationsRule& other) const
+{
+    return !(*this == other);
+}
+
+Generations::Generations()
+    : Generations(150, 150) {}
+
+Generations::Generations(int width, int height)
+    : m_width(std::max(width, 0))
+    , m_height(std::max(height, 0))
+    , m_rule(GenerationsRule::BriansBrain())
+    , m_planes(m_rule.GetNumberOfPlanes(), PackedCells(m_width, m_height))
+    , m_liveCells(m_width, m_height)
+    , m_nextLiveCells(m_width, m_height)
+    , m_generation(0)
+    , m_cellsVersion(0)
+    , m_memoryAccount("Generations")
+{
+    m_memoryAccount.SetUsage(EstimateMemoryUsage(m_width, m_height, m_rule.GetNumberOfPlanes()));
+}
+
+int Generations::GetWidth() const
+{
+    return m_width;
+}
+
+int Generations::GetHeight() const
+{
+    return m_height;
+}
+
+bool Generations::SetDimensions(int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+    if (width == m_width && height == m_height)
+        return true;
+
+    const std::size_t memoryUsage = EstimateMemoryUsage(width, height, static_cast<int>(m_planes.size()));
+    if (!m_memoryAccount.Reserve(memoryUsage))
+        return false;
+
+    m_width = width;
+    m_height = height;
+    for (auto& plane : m_planes) {
+        plane.Resize(width, height);
+    }
+    m_liveCells = PackedCells(width, height);
+    m_nextLiveCells = PackedCells(width, height);
+    m_memoryAccount.SetUsage(memoryUsage);
+    ++m_cellsVersion;
+    return true;
+}
+
+bool Generations::SetRule(const GenerationsRule& rule)
+{
+    if (rule.numberOfStates < 2 || rule.numberOfStates > GenerationsRule::maximumNumberOfStates)
+        return false;
+
+    const std::size_t memoryUsage = EstimateMemoryUsage(m_width, m_height, rule.GetNumberOfPlanes());
+    if (!m_memoryAccount.Reserve(memoryUsage))
+        return false;
+
+    // Only the few cells in states the new rule doesn't have need to be changed one at a time.
+    if (rule.numberOfStates < m_rule.numberOfStates) {
+        for (int y = 0; y < m_height; ++y) {
+            for (int x = 0; x < m_width; ++x) {
+                if (GetCellState(x, y) >= rule.numberOfStates)
+                    SetCellState(x, y, 0);
+            }
+        }
+    }
+
+    m_planes.resize(rule.GetNumberOfPlanes(), PackedCells(m_width, m_height));
+    m_rule = rule;
+    m_memoryAccount.SetUsage(memoryUsage);
+    ++m_cellsVersion;
+    return true;
+}
+
+const GenerationsRule& Generations::GetRule() const
+{
+    return m_rule;
+}
+
+int Generations::GetCellState(int x, int y) const
+{
+    int state = 0;
+    for (int plane = 0; plane < static_cast<int>(m_planes.size()); ++plane) {
+        if (m_planes[plane].GetCellState(x, y) == CellState::active)
+            state |= 1 << plane;
+    }
+
+    return state;
+}
+
+bool Generations::SetCellState(int x, int y, int state)
+{
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height || state < 0 || state >= m_rule.numberOfStates)
+        return false;
+
+    for (int plane = 0; plane < static_cast<int>(m_planes.size()); ++plane) {
+        m_planes[plane].SetCellState(x, y, ((state >> plane) & 1) ? CellState::active : CellState::inactive);
+    }
+
+    ++m_cellsVersion;
+    return true;
+}
+
+void Generations::GenerateEmptyCells()
+{
+    for (auto& plane : m_planes) {
+        plane.Fill(CellState::inactive);
+    }
+
+    m_generation = 0;
+    ++m_cellsVersion;
+}
+
+void Generations::GenerateRandomCells()
+{
+    GenerateEmptyCells();
+
+    std::mt19937_64 generator(std::random_device {}());
+    const std::uint64_t lastWordMask = m_planes[0].GetLastWordMask();
+    for (int y = 0; y < m_height; ++y) {
+        std::uint64_t* row = m_planes[0].GetRow(y);
+        for (int word = 0; word < m_planes[0].GetWordsPerRow(); ++word) {
+            row[word] = generator() & generator();
+        }
+        row[m_planes[0].GetWordsPerRow() - 1] &= lastWordMask;
+    }
+}
+
+const PackedCells& Generations::GetPlane(int plane) const
+{
+    return m_planes[plane];
+}
+
+void Generations::GetCellsInState(int state, PackedCells& cells) const
+{
+    std::vector<std::uint64_t>& words = cells.GetWords();
+    for (std::size_t word = 0; word < words.size(); ++word) {
+        std::uint64_t isInState = ~std::uint64_t(0);
+        for (int plane = 0; plane < static_cast<int>(m_planes.size()); ++plane) {
+            const std::uint64_t planeWord = m_planes[plane].GetWords()[word];
+            isInState &= ((state >> plane) & 1) ? planeWord : ~planeWord;
+        }
+        words[word] = isInState;
+    }
+
+    // The padding bits are in state 0 too.
+    if (state == 0 && cells.GetWordsPerRow() > 0) {
+        for (int y = 0; y < m_height; ++y) {
+            cells.GetRow(y)[cells.GetWordsPerRow() - 1] &= cells.GetLastWordMask();
+        }
+    }
+}
+
+void Generations::Step()
+{
+    if (m_width == 0 || m_height == 0)
+        return;
+
+    const LifeRule lifeRule { m_rule.birth, m_rule.survival };
+    switch (m_planes.size()) {
+    case 1:
+        FindLiveCells<1>(m_planes, m_liveCells);
+        break;
+    case 2:
+        FindLiveCells<2>(m_planes, m_liveCells);
+        break;
+    case 3:
+        FindLiveCells<3>(m_planes, m_liveCells);
+        break;
+    default:
+        FindLiveCells<4>(m_planes, m_liveCells);
+        break;
+    }
+
+    StepLifeRows(m_liveCells.GetWords().data(), m_nextLiveCells.GetWords().data(), m_liveCells.GetWordsPerRow(), m_height, m_liveCells.GetLastWordMask(),
+        0, m_height, lifeRule);
+
+    switch (m_planes.size()) {
+    case 1:
+        UpdatePlanes<1>(m_planes, m_liveCells, m_nextLiveCells, m_rule.numberOfStates);
+        break;
+    case 2:
+        UpdatePlanes<2>(m_planes, m_liveCells, m_nextLiveCells, m_rule.numberOfStates);
+        break;
+    case 3:
+        UpdatePlanes<3>(m_planes, m_liveCells, m_nextLiveCells, m_rule.numberOfStates);
+        break;
+    default:
+        UpdatePlanes<4>(m_planes, m_liveCells, m_nextLiveCells, m_rule.numberOfStates);
+        break;
+    }
+
+    ++m_generation;
+    ++m_cellsVersion;
+}
+
+std::size_t Generations::EstimateMemoryUsage(int width, int height, int numberOfPlanes)
+{
+    return static_cast<std::size_t>(numberOfPlanes + 2) * ((width + 63) / 64) * height * sizeof(std::uint64_t);
+}
+
+std::uint64_t Generations::GetGeneration() const
+{
+    return m_generation;
+}
+
+std::uint64_t Generations::GetCellsVersion() const
+{
+    return m_cellsVersion;
+}
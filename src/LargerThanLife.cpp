@@ -0,0 +1,228 @@
+#include "LargerThanLife.h"
+#include "Parsing.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace {
+// Reads "minimum..maximum" as the whole of text.
+bool ParseRange(const std::string& text, int& minimum, int& maximum)
+{
+    std::size_t position = 0;
+    if (!ParseNumber(text, position, minimum) || text.compare(position, 2, "..") != 0)
+        return false;
+
+    position += 2;
+    return ParseNumber(text, position, maximum) && position == text.size();
+}
+
+// Reads a number as the whole of text.
+bool ParseWholeNumber(const std::string& text, int& number)
+{
+    std::size_t position = 0;
+    return ParseNumber(text, position, number) && position == text.size();
+}
+
+// Every band sums the rows within the radius above and below it again, so bands are kept at least a square high.
+int GetNumberOfBands(int height, const LargerThanLifeRule& rule)
+{
+    const int maximumBands = std::max(1, height / (2 * rule.radius + 1));
+    return std::min(maximumBands, std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+}
+
+// Steps rows [firstRow, lastRow). The sums along each row within the radius are kept for the rows within the radius
+// of the current one, in a ring indexed by row, and their total down each column is the count.
+void StepLargerThanLifeBand(const PackedCells& cells, PackedCells& next, const LargerThanLifeRule& rule, int firstRow, int lastRow)
+{
+    const int width = cells.GetWidth();
+    const int height = cells.GetHeight();
+    const int radius = rule.radius;
+    const int diameter = 2 * radius + 1;
+
+    // Active cells before each position of the row, offset by the radius so that positions outside the row need no checks.
+    std::vector<std::int32_t> cellsBefore(static_cast<std::size_t>(width) + 2 * radius + 1);
+    // Counts along a row are at most the diameter, and counts of the square at most its square, hence 8 and 16 bits.
+    std::vector<std::uint8_t> rowSums(static_cast<std::size_t>(diameter) * width);
+    std::vector<std::uint16_t> counts(width, 0);
+
+    const auto sumRow = [&](int y) {
+        const std::uint64_t* row = cells.GetRow(y);
+        std::fill_n(cellsBefore.begin(), radius + 1, 0);
+        for (int x = 0; x < width; ++x) {
+            cellsBefore[x + radius + 1] = cellsBefore[x + radius] + static_cast<std::int32_t>((row[x / 64] >> (x % 64)) & 1);
+        }
+        std::fill(cellsBefore.begin() + width + radius + 1, cellsBefore.end(), cellsBefore[width + radius]);
+
+        std::uint8_t* sums = rowSums.data() + static_cast<std::size_t>(y % diameter) * width;
+        for (int x = 0; x < width; ++x) {
+            sums[x] = static_cast<std::uint8_t>(cellsBefore[x + diameter] - cellsBefore[x]);
+        }
+        return sums;
+    };
+
+    const auto addRow = [&](const std::uint8_t* sums) {
+        for (int x = 0; x < width; ++x) {
+            counts[x] = static_cast<std::uint16_t>(counts[x] + sums[x]);
+        }
+    };
+
+    const auto subtractRow = [&](const std::uint8_t* sums) {
+        for (int x = 0; x < width; ++x) {
+            counts[x] = static_cast<std::uint16_t>(counts[x] - sums[x]);
+        }
+    };
+
+    // The row above the square is included too, as it's the first to leave.
+    for (int y = std::max(0, firstRow - radius - 1); y < std::min(height, firstRow + radius); ++y) {
+        addRow(sumRow(y));
+    }
+
+    const int centreCount = rule.isCentreCounted ? 0 : 1;
+    for (int y = firstRow; y < lastRow; ++y) {
+        // The row leaving the square shares its place in the ring with the one entering it.
+        if (y - radius - 1 >= 0)
+            subtractRow(rowSums.data() + static_cast<std::size_t>((y - radius - 1) % diameter) * width);
+        if (y + radius < height)
+            addRow(sumRow(y + radius));
+
+        const std::uint64_t* row = cells.GetRow(y);
+        std::uint64_t* nextRow = next.GetRow(y);
+        for (int word = 0; word < cells.GetWordsPerRow(); ++word) {
+            const int firstX = word * 64;
+            const int numberOfBits = std::min(64, width - firstX);
+            std::uint64_t nextWord = 0;
+            for (int bit = 0; bit < numberOfBits; ++bit) {
+                const bool isActive = (row[word] >> bit) & 1;
+                const int count = counts[firstX + bit] - (isActive ? centreCount : 0);
+                const bool isNextActive = isActive ? (count >= rule.survivalMinimum && count <= rule.survivalMaximum)
+                                                   : (count >= rule.birthMinimum && count <= rule.birthMaximum);
+                nextWord |= static_cast<std::uint64_t>(isNextActive) << bit;
+            }
+            nextRow[word] = nextWord;
+        }
+    }
+}
+}
+
+LargerThanLifeRule LargerThanLifeRule::Bosco()
+{
+    return LargerThanLifeRule { 5, 34, 45, 34, 58, true };
+}
+
+bool LargerThanLifeRule::Parse(const std::string& ruleString, LargerThanLifeRule& rule)
+{
+    LargerThanLifeRule parsedRule { 0, 0, 0, 0, 0, false };
+    bool hasRadius = false;
+    bool hasBirth = false;
+    bool hasSurvival = false;
+
+    std::size_t start = 0;
+    while (start <= ruleString.size()) {
+        const std::size_t end = std::min(ruleString.find(',', start), ruleString.size());
+        const std::string field = ruleString.substr(start, end - start);
+        start = end + 1;
+        if (field.empty())
+            return false;
+
+        const std::string value = field.substr(1);
+        int number = 0;
+        switch (field[0]) {
+        case 'R':
+        case 'r':
+            if (hasRadius || !ParseWholeNumber(value, parsedRule.radius))
+                return false;
+            hasRadius = true;
+            break;
+        case 'C':
+        case 'c':
+            if (!ParseWholeNumber(value, number) || (number != 0 && number != 2))
+                return false;
+            break;
+        case 'M':
+        case 'm':
+            if (!ParseWholeNumber(value, number) || number > 1)
+                return false;
+            parsedRule.isCentreCounted = (number == 1);
+            break;
+        case 'S':
+        case 's':
+            if (hasSurvival || !ParseRange(value, parsedRule.survivalMinimum, parsedRule.survivalMaximum))
+                return false;
+            hasSurvival = true;
+            break;
+        case 'B':
+        case 'b':
+            if (hasBirth || !ParseRange(value, parsedRule.birthMinimum, parsedRule.birthMaximum))
+                return false;
+            hasBirth = true;
+            break;
+        case 'N':
+        case 'n':
+            if (value != "M" && value != "m")
+                return false;
+            break;
+        default:
+            return false;
+        }
+    }
+
+    if (!hasRadius || !hasBirth || !hasSurvival || parsedRule.radius < 1 || parsedRule.radius > maximumRadius)
+        return false;
+
+    rule = parsedRule;
+    return true;
+}
+
+std::string LargerThanLifeRule::ToString() const
+{
+    return "R" + std::to_string(radius) + ",C0,M" + (isCentreCounted ? "1" : "0")
+        + ",S" + std::to_string(survivalMinimum) + ".." + std::to_string(survivalMaximum)
+        + ",B" + std::to_string(birthMinimum) + ".." + std::to_string(birthMaximum) + ",NM";
+}
+
+bool LargerThanLifeRule::operator==(const LargerThanLifeRule& other) const
+{
+    return radius == other.radius && birthMinimum == other.birthMinimum && birthMaximum == other.birthMaximum
+        && survivalMinimum == other.survivalMinimum && survivalMaximum == other.survivalMaximum && isCentreCounted == other.isCentreCounted;
+}
+
+bool LargerThanLifeRule::operator!=(const LargerThanLifeRule& other) const
+{
+    return !(*this == other);
+}
+
+void StepLargerThanLife(const PackedCells& cells, PackedCells& next, const LargerThanLifeRule& rule)
+{
+    const int height = cells.GetHeight();
+    if (height == 0 || cells.GetWidth() == 0)
+        return;
+
+    const int numberOfBands = GetNumberOfBands(height, rule);
+
+    const auto stepBand = [&](int band) {
+        StepLargerThanLifeBand(cells, next, rule, height * band / numberOfBands, height * (band + 1) / numberOfBands);
+    };
+
+    // This thread steps the first band itself.
+    std::vector<std::future<void>> bands;
+    for (int band = 1; band < numberOfBands; ++band) {
+        bands.push_back(std::async(std::launch::async, stepBand, band));
+    }
+    stepBand(0);
+    for (auto& band : bands) {
+        band.get();
+    }
+}
+
+std::size_t EstimateLargerThanLifeMemoryUsage(int width, int height, const LargerThanLifeRule& rule)
+{
+    // The same buffers StepLargerThanLifeBand allocates: cells before each position, the ring of row sums and the counts.
+    const std::size_t diameter = 2 * static_cast<std::size_t>(rule.radius) + 1;
+    const std::size_t bandSize = (static_cast<std::size_t>(width) + diameter) * sizeof(std::int32_t)
+        + diameter * static_cast<std::size_t>(width) * sizeof(std::uint8_t) + static_cast<std::size_t>(width) * sizeof(std::uint16_t);
+
+    return static_cast<std::size_t>(GetNumberOfBands(height, rule)) * bandSize;
+}
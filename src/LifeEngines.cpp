@@ -0,0 +1,426 @@
+#include "LifeEngines.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+
+namespace {
+// Whether a cell with this many active neighbours is active in the next generation.
+bool IsActiveNext(bool isActive, int numberOfNeighbours, const LifeRule& rule)
+{
+    return (((isActive ? rule.survival : rule.birth) >> numberOfNeighbours) & 1) != 0;
+}
+
+// Counts each cell's neighbours one at a time, slow but obviously right.
+class NaiveLifeEngine : public LifeEngine {
+
+public:
+    const char* GetName() const override
+    {
+        return "Naive";
+    }
+
+    void Step(PackedCells& cells, PackedCells& scratch, int generations, const LifeRule& rule) override
+    {
+        for (int generation = 0; generation < generations; ++generation) {
+            for (int y = 0; y < cells.GetHeight(); ++y) {
+                for (int x = 0; x < cells.GetWidth(); ++x) {
+                    int numberOfNeighbours = 0;
+                    for (int dy = -1; dy <= 1; ++dy) {
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            if ((dx != 0 || dy != 0) && cells.GetCellState(x + dx, y + dy) == CellState::active)
+                                ++numberOfNeighbours;
+                        }
+                    }
+
+                    const bool isActive = (cells.GetCellState(x, y) == CellState::active);
+                    scratch.SetCellState(x, y, static_cast<CellState>(IsActiveNext(isActive, numberOfNeighbours, rule)));
+                }
+            }
+
+            std::swap(cells, scratch);
+        }
+    }
+};
+
+// Looks up every cell's next state from its 3x3 neighbourhood, read as a 9 bit number a column at a time.
+class NeighbourhoodTableLifeEngine : public LifeEngine {
+
+public:
+    const char* GetName() const override
+    {
+        return "3x3 Lookup Table";
+    }
+
+    void Step(PackedCells& cells, PackedCells& scratch, int generations, const LifeRule& rule) override
+    {
+        // Bit (3 * column + row) of an index is the cell at that column and row of the neighbourhood, so the centre is bit 4.
+        if (!m_hasTable || rule != m_tableRule) {
+            for (int index = 0; index < 512; ++index) {
+                int numberOfNeighbours = 0;
+                for (int bit = 0; bit < 9; ++bit) {
+                    if (bit != 4 && ((index >> bit) & 1))
+                        ++numberOfNeighbours;
+                }
+
+                m_table[index] = IsActiveNext((index >> 4) & 1, numberOfNeighbours, rule);
+            }
+
+            m_tableRule = rule;
+            m_hasTable = true;
+        }
+
+        const int width = cells.GetWidth();
+        const int height = cells.GetHeight();
+        for (int generation = 0; generation < generations; ++generation) {
+            for (int y = 0; y < height; ++y) {
+                const std::uint64_t* above = (y > 0) ? cells.GetRow(y - 1) : nullptr;
+                const std::uint64_t* middle = cells.GetRow(y);
+                const std::uint64_t* below = (y + 1 < height) ? cells.GetRow(y + 1) : nullptr;
+                const auto cellAt = [width](const std::uint64_t* row, int x) -> unsigned {
+                    return (row != nullptr && x < width) ? (row[x / 64] >> (x % 64)) & 1 : 0;
+                };
+                const auto columnAt = [&](int x) { return cellAt(above, x) | (cellAt(middle, x) << 1) | (cellAt(below, x) << 2); };
+
+                std::uint64_t* result = scratch.GetRow(y);
+                std::fill(result, result + scratch.GetWordsPerRow(), 0);
+
+                // The neighbourhood slides one column to the right for every cell.
+                unsigned index = columnAt(0) << 6;
+                for (int x = 0; x < width; ++x) {
+                    index = (index >> 3) | (columnAt(x + 1) << 6);
+                    result[x / 64] |= static_cast<std::uint64_t>(m_table[index]) << (x % 64);
+                }
+            }
+
+            std::swap(cells, scratch);
+        }
+    }
+
+private:
+    std::array<std::uint8_t, 512> m_table {};
+    LifeRule m_tableRule {};
+    bool m_hasTable = false;
+};
+
+// Looks up the next state of a 2x2 block of cells from the 4x4 block around it, a 16 bit number, in a 65536 entry table.
+class BlockTableLifeEngine : public LifeEngine {
+
+public:
+    const char* GetName() const override
+    {
+        return "4x4 Lookup Table";
+    }
+
+    void Step(PackedCells& cells, PackedCells& scratch, int generations, const LifeRule& rule) override
+    {
+        // Bit (4 * row + column) of an index is the cell at that row and column of the 4x4 block, and bit (2 * row + column)
+        // of an entry is the next state of the inner 2x2 block.
+        if (m_table.empty() || rule != m_tableRule) {
+            m_table.resize(65536);
+            for (int index = 0; index < 65536; ++index) {
+                const auto cellAt = [index](int column, int row) { return (index >> (4 * row + column)) & 1; };
+
+                std::uint8_t entry = 0;
+                for (int row = 1; row <= 2; ++row) {
+                    for (int column = 1; column <= 2; ++column) {
+                        int numberOfNeighbours = 0;
+                        for (int dy = -1; dy <= 1; ++dy) {
+                            for (int dx = -1; dx <= 1; ++dx) {
+                                if (dx != 0 || dy != 0)
+                                    numberOfNeighbours += cellAt(column + dx, row + dy);
+                            }
+                        }
+
+                        if (IsActiveNext(cellAt(column, row), numberOfNeighbours, rule))
+                            entry |= 1 << (2 * (row - 1) + (column - 1));
+                    }
+                }
+
+                m_table[index] = entry;
+            }
+
+            m_tableRule = rule;
+        }
+
+        const int height = cells.GetHeight();
+        const int wordsPerRow = cells.GetWordsPerRow();
+        const std::size_t paddedWordsPerRow = static_cast<std::size_t>(wordsPerRow) + 2;
+
+        // The four rows around a pair of rows, with an inactive word on each side so blocks at the edges read inactive cells.
+        m_paddedRows.assign(4 * paddedWordsPerRow, 0);
+
+        for (int generation = 0; generation < generations; ++generation) {
+            for (int y = 0; y < height; y += 2) {
+                for (int row = 0; row < 4; ++row) {
+                    const int sourceRow = y - 1 + row;
+                    std::uint64_t* paddedRow = m_paddedRows.data() + row * paddedWordsPerRow + 1;
+                    if (sourceRow >= 0 && sourceRow < height)
+                        std::copy(cells.GetRow(sourceRow), cells.GetRow(sourceRow) + wordsPerRow, paddedRow);
+                    else
+                        std::fill(paddedRow, paddedRow + wordsPerRow, 0);
+                }
+
+                std::uint64_t* upperResult = scratch.GetRow(y);
+                std::uint64_t* lowerResult = (y + 1 < height) ? scratch.GetRow(y + 1) : nullptr;
+
+                for (int word = 0; word < wordsPerRow; ++word) {
+                    std::uint64_t upperWord = 0;
+                    std::uint64_t lowerWord = 0;
+
+                    for (int bit = 0; bit < 64; bit += 2) {
+                        // The block's columns start one cell left of the pair, which is bit 63 of the word before for the first pair.
+                        const std::size_t paddedWord = (bit == 0) ? word : word + 1;
+                        const int shift = (bit == 0) ? 63 : bit - 1;
+
+                        unsigned index = 0;
+                        for (int row = 0; row < 4; ++row) {
+                            const std::uint64_t* paddedRow = m_paddedRows.data() + row * paddedWordsPerRow;
+                            std::uint64_t columns = paddedRow[paddedWord] >> shift;
+                            if (shift > 60)
+                                columns |= paddedRow[paddedWord + 1] << (64 - shift);
+                            index |= static_cast<unsigned>(columns & 0xF) << (4 * row);
+                        }
+
+                        const std::uint64_t entry = m_table[index];
+                        upperWord |= (entry & 0b11) << bit;
+                        lowerWord |= ((entry >> 2) & 0b11) << bit;
+                    }
+
+                    const std::uint64_t mask = (word + 1 == wordsPerRow) ? cells.GetLastWordMask() : ~std::uint64_t(0);
+                    upperResult[word] = upperWord & mask;
+                    if (lowerResult != nullptr)
+                        lowerResult[word] = lowerWord & mask;
+                }
+            }
+
+            std::swap(cells, scratch);
+        }
+    }
+
+private:
+    std::vector<std::uint8_t> m_table;
+    LifeRule m_tableRule {};
+    std::vector<std::uint64_t> m_paddedRows;
+};
+
+// Steps 64 cells at once with bitwise adders, see StepLifeRows.
+class BitParallelLifeEngine : public LifeEngine {
+
+public:
+    const char* GetName() const override
+    {
+        return "Bit-Parallel";
+    }
+
+    void Step(PackedCells& cells, PackedCells& scratch, int generations, const LifeRule& rule) override
+    {
+        for (int generation = 0; generation < generations; ++generation) {
+            StepLifeRows(cells.GetWords().data(), scratch.GetWords().data(), cells.GetWordsPerRow(), cells.GetHeight(), cells.GetLastWordMask(), 0, cells.GetHeight(), rule);
+            std::swap(cells, scratch);
+        }
+    }
+};
+
+// Splits every generation into one band of rows per hardware thread.
+class ThreadedLifeEngine : public LifeEngine {
+
+public:
+    const char* GetName() const override
+    {
+        return "Threaded Bit-Parallel";
+    }
+
+    void Step(PackedCells& cells, PackedCells& scratch, int generations, const LifeRule& rule) override
+    {
+        const int height = cells.GetHeight();
+        const int numberOfBands = std::max(1, std::min(height, m_workerPool.GetNumberOfThreads()));
+
+        for (int generation = 0; generation < generations; ++generation) {
+            m_workerPool.RunChunks(numberOfBands, [&](int band) {
+                StepLifeRows(cells.GetWords().data(), scratch.GetWords().data(), cells.GetWordsPerRow(), height, cells.GetLastWordMask(),
+                    height * band / numberOfBands, height * (band + 1) / numberOfBands, rule);
+            });
+
+            std::swap(cells, scratch);
+        }
+    }
+
+private:
+    // Generations are too short to start a thread for every band.
+    WorkerPool m_workerPool;
+};
+
+// Steps cache sized tiles several generations at a time on every hardware thread, see StepLifeGenerationsBlocked.
+class TemporallyBlockedLifeEngine : public LifeEngine {
+
+public:
+    const char* GetName() const override
+    {
+        return "Temporally Blocked";
+    }
+
+    void Step(PackedCells& cells, PackedCells& scratch, int generations, const LifeRule& rule) override
+    {
+        StepLifeGenerationsBlocked(cells, scratch, generations, rule, &m_workerPool);
+    }
+
+private:
+    WorkerPool m_workerPool;
+};
+
+// Engines are timed on a corner of the universe of at most this many cells across, for at least this long.
+constexpr int cornerSize = 1024;
+constexpr double minimumCornerSeconds = 0.005;
+// Engines slower than this fraction of the fastest on the corner aren't worth timing on the whole universe.
+constexpr double candidateThroughputFraction = 0.25;
+}
+
+std::vector<std::unique_ptr<LifeEngine>> CreateLifeEngines()
+{
+    std::vector<std::unique_ptr<LifeEngine>> engines;
+    engines.push_back(std::make_unique<NaiveLifeEngine>());
+    engines.push_back(std::make_unique<NeighbourhoodTableLifeEngine>());
+    engines.push_back(std::make_unique<BlockTableLifeEngine>());
+    engines.push_back(std::make_unique<BitParallelLifeEngine>());
+    engines.push_back(std::make_unique<ThreadedLifeEngine>());
+    engines.push_back(std::make_unique<TemporallyBlockedLifeEngine>());
+
+    return engines;
+}
+
+LifeEngineTuner::LifeEngineTuner()
+    : m_engines(CreateLifeEngines())
+    , m_throughputs(m_engines.size(), 0.0)
+    , m_isMeasuredOnWholeUniverse(m_engines.size(), false)
+    , m_candidates()
+    , m_isRetuneNeeded(true)
+    , m_selectedEngine(0)
+    , m_override(-1)
+{
+}
+
+int LifeEngineTuner::GetNumberOfEngines() const
+{
+    return static_cast<int>(m_engines.size());
+}
+
+const char* LifeEngineTuner::GetEngineName(int engine) const
+{
+    return m_engines[engine]->GetName();
+}
+
+double LifeEngineTuner::GetThroughput(int engine) const
+{
+    return m_throughputs[engine];
+}
+
+bool LifeEngineTuner::IsMeasuredOnWholeUniverse(int engine) const
+{
+    return m_isMeasuredOnWholeUniverse[engine];
+}
+
+int LifeEngineTuner::GetSelectedEngine() const
+{
+    if (m_override >= 0)
+        return m_override;
+
+    return m_candidates.empty() ? m_selectedEngine : m_candidates.back();
+}
+
+bool LifeEngineTuner::IsTuning() const
+{
+    return m_override < 0 && (m_isRetuneNeeded || !m_candidates.empty());
+}
+
+void LifeEngineTuner::SetOverride(int engine)
+{
+    m_override = (engine >= 0 && engine < GetNumberOfEngines()) ? engine : -1;
+}
+
+int LifeEngineTuner::GetOverride() const
+{
+    return m_override;
+}
+
+void LifeEngineTuner::Retune()
+{
+    m_isRetuneNeeded = true;
+    m_candidates.clear();
+}
+
+void LifeEngineTuner::Step(PackedCells& cells, PackedCells& scratch, int generations, const LifeRule& rule)
+{
+    if (generations <= 0 || cells.GetWordsPerRow() == 0 || cells.GetHeight() == 0)
+        return;
+
+    if (m_isRetuneNeeded && m_override < 0) {
+        TimeOnCorner(cells, rule);
+        m_isRetuneNeeded = false;
+    }
+
+    const bool isCandidate = (m_override < 0 && !m_candidates.empty());
+    const int engine = GetSelectedEngine();
+
+    const auto timerStart = std::chrono::steady_clock::now();
+    m_engines[engine]->Step(cells, scratch, generations, rule);
+    const std::chrono::duration<double> timerDuration = std::chrono::steady_clock::now() - timerStart;
+
+    // Later steps keep a running average, so the throughput follows the universe as it changes.
+    if (timerDuration.count() > 0.0) {
+        const double throughput = static_cast<double>(cells.GetWidth()) * cells.GetHeight() * generations / timerDuration.count();
+        m_throughputs[engine] = m_isMeasuredOnWholeUniverse[engine] ? 0.75 * m_throughputs[engine] + 0.25 * throughput : throughput;
+        m_isMeasuredOnWholeUniverse[engine] = true;
+    }
+
+    if (!isCandidate)
+        return;
+
+    m_candidates.pop_back();
+    if (m_candidates.empty()) {
+        for (int other = 0; other < GetNumberOfEngines(); ++other) {
+            if (m_isMeasuredOnWholeUniverse[other] && m_throughputs[other] > m_throughputs[m_selectedEngine])
+                m_selectedEngine = other;
+        }
+    }
+}
+
+void LifeEngineTuner::TimeOnCorner(const PackedCells& cells, const LifeRule& rule)
+{
+    // The corner is copied, so timing it leaves the universe as it is.
+    PackedCells corner(std::min(cells.GetWidth(), cornerSize), std::min(cells.GetHeight(), cornerSize));
+    for (int y = 0; y < corner.GetHeight(); ++y) {
+        std::copy(cells.GetRow(y), cells.GetRow(y) + corner.GetWordsPerRow(), corner.GetRow(y));
+        corner.GetRow(y)[corner.GetWordsPerRow() - 1] &= corner.GetLastWordMask();
+    }
+
+    double highestThroughput = 0.0;
+    for (int engine = 0; engine < GetNumberOfEngines(); ++engine) {
+        PackedCells sample = corner;
+        PackedCells scratch(sample.GetWidth(), sample.GetHeight());
+
+        int numberOfSteps = 0;
+        const auto timerStart = std::chrono::steady_clock::now();
+        std::chrono::duration<double> timerDuration;
+        do {
+            m_engines[engine]->Step(sample, scratch, 1, rule);
+            ++numberOfSteps;
+            timerDuration = std::chrono::steady_clock::now() - timerStart;
+        } while (timerDuration.count() < minimumCornerSeconds);
+
+        m_throughputs[engine] = static_cast<double>(corner.GetWidth()) * corner.GetHeight() * numberOfSteps / timerDuration.count();
+        m_isMeasuredOnWholeUniverse[engine] = false;
+        highestThroughput = std::max(highestThroughput, m_throughputs[engine]);
+    }
+
+    // The fastest candidates step first.
+    m_candidates.clear();
+    for (int engine = 0; engine < GetNumberOfEngines(); ++engine) {
+        if (m_throughputs[engine] >= candidateThroughputFraction * highestThroughput)
+            m_candidates.push_back(engine);
+    }
+    std::sort(m_candidates.begin(), m_candidates.end(), [this](int engine, int other) { return m_throughputs[engine] < m_throughputs[other]; });
+
+    m_selectedEngine = m_candidates.back();
+}
@@ -0,0 +1,229 @@
+#include "LifeEnsemble.h"
+#include "LifeKernel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <random>
+#include <thread>
+
+LifeEnsemble::LifeEnsemble()
+    : LifeEnsemble(0, 0) {}
+
+LifeEnsemble::LifeEnsemble(int width, int height)
+    : m_width(std::max(0, width))
+    , m_height(std::max(0, height))
+    , m_generation(0)
+    , m_history(static_cast<std::size_t>(stabilizationPeriod + 1) * (m_width + 2) * (m_height + 2))
+    , m_stableLanes(0)
+{
+    m_stabilizationGenerations.fill(-1);
+}
+
+std::size_t LifeEnsemble::EstimateMemoryUsage(int width, int height)
+{
+    return static_cast<std::size_t>(stabilizationPeriod + 1) * (std::max(0, width) + 2) * (std::max(0, height) + 2) * sizeof(std::uint64_t);
+}
+
+int LifeEnsemble::GetWidth() const
+{
+    return m_width;
+}
+
+int LifeEnsemble::GetHeight() const
+{
+    return m_height;
+}
+
+int LifeEnsemble::GetGeneration() const
+{
+    return m_generation;
+}
+
+std::uint64_t* LifeEnsemble::GetGenerationWords(int generation)
+{
+    return m_history.data() + static_cast<std::size_t>(generation % (stabilizationPeriod + 1)) * (m_width + 2) * (m_height + 2);
+}
+
+const std::uint64_t* LifeEnsemble::GetGenerationWords(int generation) const
+{
+    return m_history.data() + static_cast<std::size_t>(generation % (stabilizationPeriod + 1)) * (m_width + 2) * (m_height + 2);
+}
+
+CellState LifeEnsemble::GetCellState(int lane, int x, int y) const
+{
+    if (lane < 0 || lane >= numberOfLanes || x < 0 || x >= m_width || y < 0 || y >= m_height)
+        return CellState::inactive;
+
+    const std::uint64_t word = GetGenerationWords(m_generation)[static_cast<std::size_t>(y + 1) * (m_width + 2) + x + 1];
+    return static_cast<CellState>((word >> lane) & 1);
+}
+
+bool LifeEnsemble::SetCellState(int lane, int x, int y, CellState state)
+{
+    if (lane < 0 || lane >= numberOfLanes || x < 0 || x >= m_width || y < 0 || y >= m_height)
+        return false;
+
+    std::uint64_t& word = GetGenerationWords(m_generation)[static_cast<std::size_t>(y + 1) * (m_width + 2) + x + 1];
+    const std::uint64_t bit = std::uint64_t(1) << lane;
+    word = (state == CellState::active) ? (word | bit) : (word & ~bit);
+
+    // Edited universes start their stabilization search over.
+    m_stableLanes &= ~bit;
+    m_stabilizationGenerations[lane] = -1;
+    return true;
+}
+
+void LifeEnsemble::GenerateRandomSoups(std::uint64_t seed, int densityIn256ths)
+{
+    std::fill(m_history.begin(), m_history.end(), 0);
+    m_generation = 0;
+    m_stableLanes = 0;
+    m_stabilizationGenerations.fill(-1);
+
+    std::mt19937_64 randomWords(seed);
+    densityIn256ths = std::clamp(densityIn256ths, 0, 256);
+    std::uint64_t* cells = GetGenerationWords(0);
+
+    for (int y = 0; y < m_height; ++y) {
+        std::uint64_t* row = cells + static_cast<std::size_t>(y + 1) * (m_width + 2) + 1;
+        for (int x = 0; x < m_width; ++x) {
+            if (densityIn256ths == 256) {
+                row[x] = ~std::uint64_t(0);
+                continue;
+            }
+
+            // Each bit of the density, least significant first, either ors or ands in a fair random word,
+            // which leaves every bit set with a chance of exactly densityIn256ths / 256.
+            std::uint64_t word = 0;
+            for (int bit = 0; bit < 8; ++bit)
+                word = ((densityIn256ths >> bit) & 1) ? (word | randomWords()) : (word & randomWords());
+            row[x] = word;
+        }
+    }
+}
+
+void LifeEnsemble::Step()
+{
+    const int stride = m_width + 2;
+    const std::uint64_t* current = GetGenerationWords(m_generation);
+    std::uint64_t* next = GetGenerationWords(m_generation + 1);
+    // The oldest generation kept, it's about to be overwritten so the new generation is compared with the one after it.
+    const bool canCompare = (m_generation + 1 >= stabilizationPeriod);
+    const std::uint64_t* earlier = GetGenerationWords(canCompare ? m_generation + 1 - stabilizationPeriod : 0);
+
+    std::uint64_t changedLanes = 0;
+
+    for (int y = 1; y <= m_height; ++y) {
+        const std::uint64_t* above = current + static_cast<std::size_t>(y - 1) * stride;
+        const std::uint64_t* middle = current + static_cast<std::size_t>(y) * stride;
+        const std::uint64_t* below = current + static_cast<std::size_t>(y + 1) * stride;
+        const std::uint64_t* earlierRow = earlier + static_cast<std::size_t>(y) * stride;
+        std::uint64_t* result = next + static_cast<std::size_t>(y) * stride;
+
+        // Neighbouring cells are neighbouring words, so no shifting is needed unlike StepLifeRows.
+        for (int x = 1; x <= m_width; ++x) {
+            result[x] = NextLifeWord(above[x - 1], above[x], above[x + 1], middle[x - 1], middle[x], middle[x + 1], below[x - 1], below[x], below[x + 1]);
+            changedLanes |= result[x] ^ earlierRow[x];
+        }
+    }
+
+    ++m_generation;
+
+    if (canCompare) {
+        // A deterministic universe that repeats once repeats forever, so the first repeat marks where it became stable.
+        std::uint64_t newlyStableLanes = ~changedLanes & ~m_stableLanes;
+        m_stableLanes |= newlyStableLanes;
+        while (newlyStableLanes != 0) {
+            const int lane = CountTrailingZeros(newlyStableLanes);
+            m_stabilizationGenerations[lane] = m_generation - stabilizationPeriod;
+            newlyStableLanes &= newlyStableLanes - 1;
+        }
+    }
+}
+
+void LifeEnsemble::StepUntilStable(int maximumGeneration)
+{
+    while (m_generation < maximumGeneration && !IsEveryLaneStable())
+        Step();
+}
+
+std::array<int, LifeEnsemble::numberOfLanes> LifeEnsemble::GetPopulations() const
+{
+    std::array<int, numberOfLanes> populations {};
+    const std::uint64_t* cells = GetGenerationWords(m_generation);
+
+    for (int y = 1; y <= m_height; ++y) {
+        const std::uint64_t* row = cells + static_cast<std::size_t>(y) * (m_width + 2);
+        for (int x = 1; x <= m_width; ++x) {
+            for (std::uint64_t word = row[x]; word != 0; word &= word - 1)
+                ++populations[CountTrailingZeros(word)];
+        }
+    }
+
+    return populations;
+}
+
+const std::array<int, LifeEnsemble::numberOfLanes>& LifeEnsemble::GetStabilizationGenerations() const
+{
+    return m_stabilizationGenerations;
+}
+
+bool LifeEnsemble::IsEveryLaneStable() const
+{
+    return m_stableLanes == ~std::uint64_t(0);
+}
+
+SoupSweepResult RunSoupSweep(int width, int height, int numberOfSoups, int maximumGeneration, std::uint64_t seed, int densityIn256ths)
+{
+    const auto timerStart = std::chrono::steady_clock::now();
+
+    SoupSweepResult result {};
+    const int numberOfSweptSoups = std::max(0, numberOfSoups);
+    const int numberOfEnsembles = (numberOfSweptSoups + LifeEnsemble::numberOfLanes - 1) / LifeEnsemble::numberOfLanes;
+    const int numberOfThreads = std::max(1, std::min(numberOfEnsembles, static_cast<int>(std::thread::hardware_concurrency())));
+
+    // The ensembles only live while the sweep runs, the results for as long as the caller keeps them.
+    const std::size_t resultsSize = 2 * static_cast<std::size_t>(numberOfSweptSoups) * sizeof(int);
+    const std::size_t ensemblesSize = static_cast<std::size_t>(numberOfThreads) * LifeEnsemble::EstimateMemoryUsage(width, height);
+    result.memoryAccount = std::make_unique<MemoryAccount>("Soup sweep");
+    if (!result.memoryAccount->Reserve(resultsSize + ensemblesSize))
+        return result;
+
+    result.memoryAccount->SetUsage(resultsSize + ensemblesSize);
+    result.isRun = true;
+    result.numberOfSoups = numberOfSweptSoups;
+    result.stabilizationGenerations.assign(result.numberOfSoups, -1);
+    result.finalPopulations.assign(result.numberOfSoups, 0);
+
+    // Each thread takes every numberOfThreads'th ensemble and writes only its own soups, so no locking is needed.
+    // Every ensemble gets its own seed, so results don't depend on the number of threads.
+    const auto runEnsembles = [&](int firstEnsemble) {
+        LifeEnsemble ensemble(width, height);
+        for (int ensembleIndex = firstEnsemble; ensembleIndex < numberOfEnsembles; ensembleIndex += numberOfThreads) {
+            ensemble.GenerateRandomSoups(seed + ensembleIndex, densityIn256ths);
+            ensemble.StepUntilStable(maximumGeneration);
+
+            const auto populations = ensemble.GetPopulations();
+            const int firstSoup = ensembleIndex * LifeEnsemble::numberOfLanes;
+            const int lastSoup = std::min(result.numberOfSoups, firstSoup + LifeEnsemble::numberOfLanes);
+            for (int soup = firstSoup; soup < lastSoup; ++soup) {
+                result.stabilizationGenerations[soup] = ensemble.GetStabilizationGenerations()[soup - firstSoup];
+                result.finalPopulations[soup] = populations[soup - firstSoup];
+            }
+        }
+    };
+
+    std::vector<std::future<void>> threads;
+    for (int thread = 1; thread < numberOfThreads; ++thread)
+        threads.push_back(std::async(std::launch::async, runEnsembles, thread));
+
+    runEnsembles(0);
+    for (auto& thread : threads)
+        thread.get();
+
+    result.memoryAccount->SetUsage(resultsSize);
+    result.numberOfUnstableSoups = static_cast<int>(std::count(result.stabilizationGenerations.begin(), result.stabilizationGenerations.end(), -1));
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - timerStart).count();
+    return result;
+}
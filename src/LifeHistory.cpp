@@ -0,0 +1,201 @@
+#include "LifeHistory.h"
+#include "WordCompression.h"
+
+#include <algorithm>
+#include <utility>
+
+LifeHistory::LifeHistory()
+    : m_segments()
+    , m_firstGeneration(0)
+    , m_width(0)
+    , m_height(0)
+    , m_lastCells()
+    , m_secondLastCells()
+    , m_memoryBudget(256 * 1024 * 1024)
+    , m_memoryUsage(0)
+    , m_memoryAccount("Game of Life history", [this](std::size_t memoryLimit) {
+        DropOldestSegments(memoryLimit);
+        m_memoryAccount.SetUsage(GetMemoryUsage());
+    }) {}
+
+std::size_t LifeHistory::GetSegmentSize(const Segment& segment)
+{
+    std::size_t segmentSize = segment.keyframe.capacity() * sizeof(std::uint64_t) + segment.deltas.capacity() * sizeof(Delta);
+    for (const auto& delta : segment.deltas)
+        segmentSize += delta.compressedWords.capacity() * sizeof(std::uint64_t) + delta.compressedBits.capacity();
+
+    return segmentSize;
+}
+
+void LifeHistory::Record(std::uint64_t generation, const std::uint64_t* words, int width, int height)
+{
+    if (IsEmpty() || width != m_width || height != m_height || generation != GetLastGeneration() + 1) {
+        Clear();
+        m_firstGeneration = generation;
+        m_width = width;
+        m_height = height;
+        m_lastCells = PackedCells(width, height);
+        m_secondLastCells = PackedCells(width, height);
+    }
+
+    const std::size_t numberOfWords = m_lastCells.GetWords().size();
+    const std::uint64_t generationInSegment = (generation - m_firstGeneration) % keyframeInterval;
+
+    // Oscillators and still lifes are the same as two generations ago, so taking the xor with that generation leaves
+    // only the cells that really changed. The generation after the keyframe has nothing earlier in its segment to use.
+    const std::uint64_t* earlierWords = (generationInSegment == 1) ? m_lastCells.GetWords().data() : m_secondLastCells.GetWords().data();
+
+    if (generationInSegment == 0) {
+        m_segments.push_back(Segment { CompressWords(words, numberOfWords), {} });
+        m_segments.back().deltas.reserve(keyframeInterval - 1);
+    } else {
+        m_memoryUsage -= GetSegmentSize(m_segments.back());
+        Delta delta;
+        if (!CompressXorBits(words, earlierWords, numberOfWords, numberOfWords * sizeof(std::uint64_t) / 4, delta.compressedBits)) {
+            delta.compressedBits = {};
+            delta.compressedWords = CompressXorWords(words, earlierWords, numberOfWords);
+        }
+        m_segments.back().deltas.push_back(std::move(delta));
+    }
+
+    m_memoryUsage += GetSegmentSize(m_segments.back());
+    std::swap(m_lastCells, m_secondLastCells);
+    std::copy(words, words + numberOfWords, m_lastCells.GetWords().begin());
+
+    // The global memory budget is only told once the history fits in it, so it sees the whole growth since the last generation.
+    DropOldestSegments(m_memoryBudget);
+    while (m_segments.size() > 1 && !m_memoryAccount.Reserve(GetMemoryUsage(), false)) {
+        DropOldestSegments(GetMemoryUsage() - GetSegmentSize(m_segments.front()));
+    }
+    m_memoryAccount.SetUsage(GetMemoryUsage());
+}
+
+void LifeHistory::Truncate(std::uint64_t lastGeneration)
+{
+    if (IsEmpty() || lastGeneration >= GetLastGeneration())
+        return;
+
+    if (lastGeneration < m_firstGeneration) {
+        Clear();
+        return;
+    }
+
+    // Everything after the segment holding the generation goes, then the deltas after it within that segment.
+    const std::size_t segmentIndex = (lastGeneration - m_firstGeneration) / keyframeInterval;
+    while (m_segments.size() > segmentIndex + 1) {
+        m_memoryUsage -= GetSegmentSize(m_segments.back());
+        m_segments.pop_back();
+    }
+
+    Segment& segment = m_segments.back();
+    m_memoryUsage -= GetSegmentSize(segment);
+    segment.deltas.resize((lastGeneration - m_firstGeneration) % keyframeInterval);
+    m_memoryUsage += GetSegmentSize(segment);
+
+    Seek(lastGeneration, m_lastCells);
+    if (lastGeneration > m_firstGeneration)
+        Seek(lastGeneration - 1, m_secondLastCells);
+    m_memoryAccount.SetUsage(GetMemoryUsage());
+}
+
+void LifeHistory::Clear()
+{
+    m_segments.clear();
+    m_firstGeneration = 0;
+    m_lastCells = PackedCells();
+    m_secondLastCells = PackedCells();
+    m_memoryUsage = 0;
+    m_memoryAccount.SetUsage(GetMemoryUsage());
+}
+
+bool LifeHistory::IsEmpty() const
+{
+    return m_segments.empty();
+}
+
+std::uint64_t LifeHistory::GetFirstGeneration() const
+{
+    return m_firstGeneration;
+}
+
+std::uint64_t LifeHistory::GetLastGeneration() const
+{
+    if (IsEmpty())
+        return m_firstGeneration;
+
+    return m_firstGeneration + (m_segments.size() - 1) * keyframeInterval + m_segments.back().deltas.size();
+}
+
+bool LifeHistory::Seek(std::uint64_t generation, PackedCells& cells) const
+{
+    if (IsEmpty() || generation < m_firstGeneration || generation > GetLastGeneration())
+        return false;
+
+    const Segment& segment = m_segments[(generation - m_firstGeneration) / keyframeInterval];
+    const std::size_t numberOfDeltas = (generation - m_firstGeneration) % keyframeInterval;
+
+    if (cells.GetWidth() != m_width || cells.GetHeight() != m_height)
+        cells = PackedCells(m_width, m_height);
+
+    // Even and odd generations of the segment are decoded in separate buffers, as each delta applies to the generation two before it.
+    // The buffer holding generations of the same parity as the one sought is cells.
+    std::vector<std::uint64_t>& words = cells.GetWords();
+    std::vector<std::uint64_t> otherWords(numberOfDeltas > 0 ? words.size() : 0);
+    const auto bufferFor = [&](std::size_t generationInSegment) {
+        return ((numberOfDeltas - generationInSegment) % 2 == 0) ? words.data() : otherWords.data();
+    };
+
+    std::fill(words.begin(), words.end(), 0);
+    XorDecompressedWords(segment.keyframe, words.data());
+    if (numberOfDeltas % 2 == 1)
+        std::swap(words, otherWords);
+
+    for (std::size_t generationInSegment = 1; generationInSegment <= numberOfDeltas; ++generationInSegment) {
+        std::uint64_t* buffer = bufferFor(generationInSegment);
+        // The first delta is from the keyframe, which is in the other buffer.
+        if (generationInSegment == 1)
+            std::copy(bufferFor(0), bufferFor(0) + words.size(), buffer);
+
+        const Delta& delta = segment.deltas[generationInSegment - 1];
+        XorDecompressedWords(delta.compressedWords, buffer);
+        XorDecompressedBits(delta.compressedBits, buffer);
+    }
+
+    return true;
+}
+
+std::size_t LifeHistory::GetMemoryBudget() const
+{
+    return m_memoryBudget;
+}
+
+std::size_t LifeHistory::GetMemoryUsage() const
+{
+    return m_memoryUsage + GetCopiesSize();
+}
+
+std::size_t LifeHistory::EstimateCopiesSize(int width, int height)
+{
+    return 2 * static_cast<std::size_t>((width + 63) / 64) * static_cast<std::size_t>(height) * sizeof(std::uint64_t);
+}
+
+std::size_t LifeHistory::GetCopiesSize() const
+{
+    return (m_lastCells.GetWords().capacity() + m_secondLastCells.GetWords().capacity()) * sizeof(std::uint64_t);
+}
+
+void LifeHistory::SetMemoryBudget(std::size_t memoryBudget)
+{
+    m_memoryBudget = memoryBudget;
+    DropOldestSegments(m_memoryBudget);
+    m_memoryAccount.SetUsage(GetMemoryUsage());
+}
+
+void LifeHistory::DropOldestSegments(std::size_t memoryLimit)
+{
+    while (m_segments.size() > 1 && GetMemoryUsage() > memoryLimit) {
+        m_memoryUsage -= GetSegmentSize(m_segments.front());
+        m_segments.pop_front();
+        m_firstGeneration += keyframeInterval;
+    }
+}
@@ -0,0 +1,246 @@
+#include "LifeKernel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace {
+// Per core cache size that tiles are sized for, 1 MB if it can't be found.
+std::size_t GetTileCacheSize()
+{
+#if defined(__linux__) && defined(_SC_LEVEL2_CACHE_SIZE)
+    const long level2CacheSize = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (level2CacheSize > 0)
+        return static_cast<std::size_t>(level2CacheSize);
+#endif
+    return 1024 * 1024;
+}
+
+// Works one word at a time, so 64 cells are stepped at once.
+template <typename NextWord>
+void StepRows(const std::uint64_t* current, std::uint64_t* next, int wordsPerRow, int height, std::uint64_t lastWordMask, int firstRow, int lastRow, NextWord nextWord)
+{
+    for (int y = firstRow; y < lastRow; ++y) {
+        const std::size_t rowOffset = static_cast<std::size_t>(y) * wordsPerRow;
+        const std::uint64_t* middle = current + rowOffset;
+        std::uint64_t* result = next + rowOffset;
+
+        // Rows outside the grid read the middle row masked to nothing, which keeps the loop free of branches.
+        const std::uint64_t aboveMask = (y > 0) ? ~std::uint64_t(0) : 0;
+        const std::uint64_t belowMask = (y + 1 < height) ? ~std::uint64_t(0) : 0;
+        const std::uint64_t* above = (y > 0) ? middle - wordsPerRow : middle;
+        const std::uint64_t* below = (y + 1 < height) ? middle + wordsPerRow : middle;
+
+        // Sliding window over the previous, current and next word of each row.
+        std::uint64_t abovePrevious = 0;
+        std::uint64_t middlePrevious = 0;
+        std::uint64_t belowPrevious = 0;
+        std::uint64_t aboveCentre = above[0] & aboveMask;
+        std::uint64_t middleCentre = middle[0];
+        std::uint64_t belowCentre = below[0] & belowMask;
+
+        for (int word = 0; word < wordsPerRow; ++word) {
+            const bool hasNextWord = (word + 1 < wordsPerRow);
+            const std::uint64_t aboveNext = hasNextWord ? above[word + 1] & aboveMask : 0;
+            const std::uint64_t middleNext = hasNextWord ? middle[word + 1] : 0;
+            const std::uint64_t belowNext = hasNextWord ? below[word + 1] & belowMask : 0;
+
+            // Bit x of "Left" holds cell x - 1 and bit x of "Right" holds cell x + 1.
+            const std::uint64_t aboveLeft = (aboveCentre << 1) | (abovePrevious >> 63);
+            const std::uint64_t aboveRight = (aboveCentre >> 1) | (aboveNext << 63);
+            const std::uint64_t middleLeft = (middleCentre << 1) | (middlePrevious >> 63);
+            const std::uint64_t middleRight = (middleCentre >> 1) | (middleNext << 63);
+            const std::uint64_t belowLeft = (belowCentre << 1) | (belowPrevious >> 63);
+            const std::uint64_t belowRight = (belowCentre >> 1) | (belowNext << 63);
+
+            result[word] = nextWord(aboveLeft, aboveCentre, aboveRight, middleLeft, middleCentre, middleRight, belowLeft, belowCentre, belowRight);
+
+            abovePrevious = aboveCentre;
+            middlePrevious = middleCentre;
+            belowPrevious = belowCentre;
+            aboveCentre = aboveNext;
+            middleCentre = middleNext;
+            belowCentre = belowNext;
+        }
+
+        result[wordsPerRow - 1] &= lastWordMask;
+    }
+}
+
+}
+
+LifeRule LifeRule::Conway()
+{
+    return LifeRule { 1 << 3, (1 << 2) | (1 << 3) };
+}
+
+bool LifeRule::Parse(const std::string& ruleString, LifeRule& rule)
+{
+    LifeRule parsedRule { 0, 0 };
+    std::uint16_t* counts = nullptr;
+    bool hasBirth = false;
+    bool hasSurvival = false;
+
+    for (const char character : ruleString) {
+        if ((character == 'B' || character == 'b') && !hasBirth) {
+            counts = &parsedRule.birth;
+            hasBirth = true;
+        } else if ((character == 'S' || character == 's') && !hasSurvival) {
+            counts = &parsedRule.survival;
+            hasSurvival = true;
+        } else if (character == '/' && counts != nullptr) {
+            counts = nullptr;
+        } else if (character >= '0' && character <= '8' && counts != nullptr) {
+            *counts |= 1 << (character - '0');
+        } else {
+            return false;
+        }
+    }
+
+    if (!hasBirth || !hasSurvival)
+        return false;
+
+    rule = parsedRule;
+    return true;
+}
+
+std::string LifeRule::ToString() const
+{
+    std::string ruleString = "B";
+    for (int count = 0; count <= 8; ++count) {
+        if ((birth >> count) & 1)
+            ruleString += static_cast<char>('0' + count);
+    }
+
+    ruleString += "/S";
+    for (int count = 0; count <= 8; ++count) {
+        if ((survival >> count) & 1)
+            ruleString += static_cast<char>('0' + count);
+    }
+
+    return ruleString;
+}
+
+bool LifeRule::operator==(const LifeRule& other) const
+{
+    return birth == other.birth && survival == other.survival;
+}
+
+bool LifeRule::operator!=(const LifeRule& other) const
+{
+    return !(*this == other);
+}
+
+void StepLifeRows(const std::uint64_t* current, std::uint64_t* next, int wordsPerRow, int height, std::uint64_t lastWordMask, int firstRow, int lastRow, const LifeRule& rule)
+{
+    if (wordsPerRow == 0)
+        return;
+
+    // Conway's rule has its own adders, which are much cheaper than matching every neighbour count.
+    if (rule == LifeRule::Conway()) {
+        StepRows(current, next, wordsPerRow, height, lastWordMask, firstRow, lastRow, NextLifeWord);
+    } else {
+        StepRows(current, next, wordsPerRow, height, lastWordMask, firstRow, lastRow,
+            [&rule](std::uint64_t aboveLeft, std::uint64_t aboveCentre, std::uint64_t aboveRight,
+                std::uint64_t middleLeft, std::uint64_t middleCentre, std::uint64_t middleRight,
+                std::uint64_t belowLeft, std::uint64_t belowCentre, std::uint64_t belowRight) {
+                return NextLifeLikeWord(aboveLeft, aboveCentre, aboveRight, middleLeft, middleCentre, middleRight, belowLeft, belowCentre, belowRight, rule);
+            });
+    }
+}
+
+void StepLifeGenerationsBlocked(PackedCells& cells, PackedCells& scratch, int generations, const LifeRule& rule, WorkerPool* workerPool)
+{
+    const int width = cells.GetWidth();
+    const int height = cells.GetHeight();
+    const int wordsPerRow = cells.GetWordsPerRow();
+    if (wordsPerRow == 0 || height == 0 || generations <= 0)
+        return;
+
+    if (scratch.GetWidth() != width || scratch.GetHeight() != height)
+        scratch = PackedCells(width, height);
+
+    // Tiles are 16 words (1024 cells) wide plus a ghost word on each side, so ghost zones can be up to 64 cells wide.
+    // Two copies of a tile with its ghost zones have to fit in the per core cache.
+    const int tileWords = std::min(wordsPerRow, 16);
+    const int localWords = tileWords + 2;
+    const int localRowsInCache = static_cast<int>(GetTileCacheSize() / (2 * sizeof(std::uint64_t) * localWords));
+
+    // Deeper ghost zones save more memory traffic but redo more work, a quarter of the tile height keeps the redundant work below half.
+    const int maximumGhostRows = std::min(64, std::max(1, localRowsInCache / 6));
+    const int ghostRows = std::min(generations, maximumGhostRows);
+    const int tileRows = std::max(1, std::min(height, localRowsInCache - 2 * ghostRows));
+
+    const int tilesPerColumn = (height + tileRows - 1) / tileRows;
+    const int tilesPerRow = (wordsPerRow + tileWords - 1) / tileWords;
+    const int numberOfTiles = tilesPerColumn * tilesPerRow;
+    const int numberOfChunks = workerPool ? std::min(workerPool->GetNumberOfThreads(), numberOfTiles) : 1;
+
+    // Every chunk steps its tiles in its own pair of buffers.
+    const std::size_t localSize = static_cast<std::size_t>(localWords) * (tileRows + 2 * ghostRows);
+    std::vector<std::vector<std::uint64_t>> locals(2 * static_cast<std::size_t>(numberOfChunks));
+
+    while (generations > 0) {
+        const int blockGenerations = std::min(generations, ghostRows);
+
+        // Chunks take the next tile until there are none left, so chunks with cheaper tiles at the edges take more of them.
+        std::atomic<int> nextTile(0);
+        const auto stepTiles = [&](int chunk) {
+            std::vector<std::uint64_t>& local = locals[2 * chunk];
+            std::vector<std::uint64_t>& localNext = locals[2 * chunk + 1];
+            local.resize(localSize);
+            localNext.resize(localSize);
+
+            for (int tile; (tile = nextTile.fetch_add(1, std::memory_order_relaxed)) < numberOfTiles;) {
+                const int tileTop = (tile / tilesPerRow) * tileRows;
+                const int tileBottom = std::min(height, tileTop + tileRows);
+                const int regionTop = std::max(0, tileTop - blockGenerations);
+                const int regionBottom = std::min(height, tileBottom + blockGenerations);
+                const int regionRows = regionBottom - regionTop;
+
+                const int tileLeft = (tile % tilesPerRow) * tileWords;
+                const int tileRight = std::min(wordsPerRow, tileLeft + tileWords);
+                const int regionLeft = std::max(0, tileLeft - 1);
+                const int regionRight = std::min(wordsPerRow, tileRight + 1);
+                const int regionWords = regionRight - regionLeft;
+
+                // Region edges on the grid's edge are exact, any other edge is wrong by one more cell every generation,
+                // which the ghost zones absorb.
+                const bool isTopExact = (regionTop == 0);
+                const bool isBottomExact = (regionBottom == height);
+                const std::uint64_t regionLastWordMask = (regionRight == wordsPerRow) ? cells.GetLastWordMask() : ~std::uint64_t(0);
+
+                for (int row = 0; row < regionRows; ++row) {
+                    const std::uint64_t* source = cells.GetRow(regionTop + row) + regionLeft;
+                    std::copy(source, source + regionWords, local.begin() + static_cast<std::size_t>(row) * regionWords);
+                }
+
+                for (int generation = 1; generation <= blockGenerations; ++generation) {
+                    // Only rows that can still reach the tile are stepped.
+                    const int firstRow = isTopExact ? 0 : generation;
+                    const int lastRow = isBottomExact ? regionRows : regionRows - generation;
+                    StepLifeRows(local.data(), localNext.data(), regionWords, regionRows, regionLastWordMask, firstRow, lastRow, rule);
+                    std::swap(local, localNext);
+                }
+
+                for (int row = tileTop; row < tileBottom; ++row) {
+                    const std::uint64_t* source = local.data() + static_cast<std::size_t>(row - regionTop) * regionWords + (tileLeft - regionLeft);
+                    std::copy(source, source + (tileRight - tileLeft), scratch.GetRow(row) + tileLeft);
+                }
+            }
+        };
+
+        if (numberOfChunks > 1)
+            workerPool->RunChunks(numberOfChunks, stepTiles);
+        else
+            stepTiles(0);
+
+        std::swap(cells, scratch);
+        generations -= blockGenerations;
+    }
+}
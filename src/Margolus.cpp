@@ -0,0 +1,376 @@
+#include "Margolus.h"
+
+#include <algorithm>
+#include <future>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+// Left cells of the blocks of a word whose blocks start on its even bits.
+constexpr std::uint64_t leftCells = 0x5555555555555555;
+// Bands are only split off for at least this many words, starting threads costs more than stepping fewer.
+constexpr std::size_t minimumWordsPerBand = 1024;
+
+// The cells are updated in place, so they're all the memory a universe needs.
+std::size_t GetCellsSize(int width, int height)
+{
+    return static_cast<std::size_t>((width + 63) / 64) * height * sizeof(std::uint64_t);
+}
+
+// Multiplying a word of left cells by a code sets the left cells for bit 0 of the code and the right cells for bit 1,
+// so a block's new top and bottom row come from two multiplications without any carries between blocks.
+struct BlockCodes {
+    std::array<std::uint64_t, 16> top;
+    std::array<std::uint64_t, 16> bottom;
+};
+
+BlockCodes GetBlockCodes(const MargolusRule& rule)
+{
+    BlockCodes codes {};
+    for (int block = 0; block < 16; ++block) {
+        codes.top[block] = rule.newBlocks[block] & 3;
+        codes.bottom[block] = rule.newBlocks[block] >> 2;
+    }
+
+    return codes;
+}
+
+// New top and bottom rows of the 32 blocks in a pair of words, with every block starting on an even bit.
+// Each block state is decoded into a word with its left cell set for the blocks in that state, from products of the four cells.
+inline void UpdateBlockWords(std::uint64_t top, std::uint64_t bottom, const BlockCodes& codes, std::uint64_t& newTop, std::uint64_t& newBottom)
+{
+    const std::uint64_t topLeft = top & leftCells;
+    const std::uint64_t topRight = (top >> 1) & leftCells;
+    const std::uint64_t bottomLeft = bottom & leftCells;
+    const std::uint64_t bottomRight = (bottom >> 1) & leftCells;
+
+    const std::uint64_t topStates[4] = { ~topLeft & ~topRight & leftCells, topLeft & ~topRight, ~topLeft & topRight & leftCells, topLeft & topRight };
+    const std::uint64_t bottomStates[4] = { ~bottomLeft & ~bottomRight & leftCells, bottomLeft & ~bottomRight, ~bottomLeft & bottomRight & leftCells,
+        bottomLeft & bottomRight };
+
+    newTop = 0;
+    newBottom = 0;
+    for (int block = 0; block < 16; ++block) {
+        const std::uint64_t isInState = topStates[block & 3] & bottomStates[block >> 2];
+        newTop |= isInState * codes.top[block];
+        newBottom |= isInState * codes.bottom[block];
+    }
+}
+
+// Updates the blocks of a pair of rows in place. Blocks of the odd partition start on odd columns, so each word is first shifted
+// down a cell to start them on even bits and shifted back after, with the last block of the row wrapping around to cell 0.
+void UpdateBlockRows(std::uint64_t* top, std::uint64_t* bottom, int wordsPerRow, int width, std::uint64_t lastWordMask, const BlockCodes& codes,
+    bool isOddPartition)
+{
+    const int lastWord = wordsPerRow - 1;
+
+    if (!isOddPartition) {
+        for (int word = 0; word < wordsPerRow; ++word) {
+            UpdateBlockWords(top[word], bottom[word], codes, top[word], bottom[word]);
+        }
+        top[lastWord] &= lastWordMask;
+        bottom[lastWord] &= lastWordMask;
+        return;
+    }
+
+    // The last cell of the row, which is the left cell of the block wrapping around.
+    const int lastBit = (width - 1) % 64;
+    const std::uint64_t firstTopCell = top[0] & 1;
+    const std::uint64_t firstBottomCell = bottom[0] & 1;
+
+    std::uint64_t topCarry = 0;
+    std::uint64_t bottomCarry = 0;
+    std::uint64_t newTop = 0;
+    std::uint64_t newBottom = 0;
+    for (int word = 0; word < wordsPerRow; ++word) {
+        const std::uint64_t shiftedTop = (top[word] >> 1) | ((word == lastWord) ? firstTopCell << lastBit : top[word + 1] << 63);
+        const std::uint64_t shiftedBottom = (bottom[word] >> 1) | ((word == lastWord) ? firstBottomCell << lastBit : bottom[word + 1] << 63);
+        UpdateBlockWords(shiftedTop, shiftedBottom, codes, newTop, newBottom);
+
+        top[word] = (newTop << 1) | topCarry;
+        bottom[word] = (newBottom << 1) | bottomCarry;
+        topCarry = newTop >> 63;
+        bottomCarry = newBottom >> 63;
+    }
+
+    top[lastWord] &= lastWordMask;
+    bottom[lastWord] &= lastWordMask;
+    top[0] = (top[0] & ~std::uint64_t(1)) | ((newTop >> lastBit) & 1);
+    bottom[0] = (bottom[0] & ~std::uint64_t(1)) | ((newBottom >> lastBit) & 1);
+}
+}
+
+MargolusRule MargolusRule::BilliardBall()
+{
+    // Single balls cross their block, two balls meeting head on leave at right angles, and everything else stays, walls included.
+    return MargolusRule { { 0, 8, 4, 3, 2, 5, 9, 7, 1, 6, 10, 11, 12, 13, 14, 15 } };
+}
+
+MargolusRule MargolusRule::Critters()
+{
+    MargolusRule rule {};
+    for (int block = 0; block < 16; ++block) {
+        const int numberOfLiveCells = CountActiveCells(block);
+        int newBlock = (numberOfLiveCells == 2) ? block : ~block & 15;
+        // Turning a block around reverses the order of its cells.
+        if (numberOfLiveCells == 3)
+            newBlock = ((newBlock & 1) << 3) | ((newBlock & 2) << 1) | ((newBlock & 4) >> 1) | ((newBlock & 8) >> 3);
+        rule.newBlocks[block] = static_cast<std::uint8_t>(newBlock);
+    }
+
+    return rule;
+}
+
+MargolusRule MargolusRule::Tron()
+{
+    MargolusRule rule {};
+    for (int block = 0; block < 16; ++block) {
+        rule.newBlocks[block] = static_cast<std::uint8_t>((block == 0 || block == 15) ? ~block & 15 : block);
+    }
+
+    return rule;
+}
+
+bool MargolusRule::Parse(const std::string& ruleString, MargolusRule& rule)
+{
+    std::size_t position = (ruleString.compare(0, 4, "MS,D") == 0) ? 4 : 0;
+
+    MargolusRule parsedRule {};
+    for (int block = 0; block < 16; ++block) {
+        if (block > 0) {
+            if (position >= ruleString.size() || (ruleString[position] != ';' && ruleString[position] != ','))
+                return false;
+            ++position;
+        }
+
+        int newBlock = 0;
+        const std::size_t start = position;
+        while (position < ruleString.size() && ruleString[position] >= '0' && ruleString[position] <= '9' && position - start < 2) {
+            newBlock = newBlock * 10 + (ruleString[position] - '0');
+            ++position;
+        }
+
+        if (position == start || newBlock > 15)
+            return false;
+        parsedRule.newBlocks[block] = static_cast<std::uint8_t>(newBlock);
+    }
+
+    if (position != ruleString.size())
+        return false;
+
+    rule = parsedRule;
+    return true;
+}
+
+std::string MargolusRule::ToString() const
+{
+    std::string ruleString = "MS,D";
+    for (int block = 0; block < 16; ++block) {
+        if (block > 0)
+            ruleString += ';';
+        ruleString += std::to_string(newBlocks[block]);
+    }
+
+    return ruleString;
+}
+
+bool MargolusRule::IsReversible() const
+{
+    std::uint32_t newBlocksSeen = 0;
+    for (const std::uint8_t newBlock : newBlocks) {
+        newBlocksSeen |= std::uint32_t(1) << newBlock;
+    }
+
+    return newBlocksSeen == 0xFFFF;
+}
+
+MargolusRule MargolusRule::GetInverse() const
+{
+    MargolusRule inverse {};
+    for (int block = 0; block < 16; ++block) {
+        inverse.newBlocks[newBlocks[block]] = static_cast<std::uint8_t>(block);
+    }
+
+    return inverse;
+}
+
+bool MargolusRule::operator==(const MargolusRule& other) const
+{
+    return newBlocks == other.newBlocks;
+}
+
+bool MargolusRule::operator!=(const MargolusRule& other) const
+{
+    return !(*this == other);
+}
+
+Margolus::Margolus()
+    : Margolus(150, 150) {}
+
+Margolus::Margolus(int width, int height)
+    : m_width(std::max(width, 0) & ~1)
+    , m_height(std::max(height, 0) & ~1)
+    , m_rule(MargolusRule::BilliardBall())
+    , m_inverseRule(m_rule.GetInverse())
+    , m_isReversible(true)
+    , m_cells(m_width, m_height)
+    , m_generation(0)
+    , m_cellsVersion(0)
+    , m_memoryAccount("Margolus")
+{
+    m_memoryAccount.SetUsage(GetCellsSize(m_width, m_height));
+}
+
+int Margolus::GetWidth() const
+{
+    return m_width;
+}
+
+int Margolus::GetHeight() const
+{
+    return m_height;
+}
+
+bool Margolus::SetDimensions(int width, int height)
+{
+    width &= ~1;
+    height &= ~1;
+    if (width <= 0 || height <= 0)
+        return false;
+    if (width == m_width && height == m_height)
+        return true;
+
+    if (!m_memoryAccount.Reserve(GetCellsSize(width, height)))
+        return false;
+
+    m_width = width;
+    m_height = height;
+    m_cells.Resize(width, height);
+    m_memoryAccount.SetUsage(GetCellsSize(width, height));
+    ++m_cellsVersion;
+    return true;
+}
+
+void Margolus::SetRule(const MargolusRule& rule)
+{
+    m_rule = rule;
+    m_isReversible = rule.IsReversible();
+    if (m_isReversible)
+        m_inverseRule = rule.GetInverse();
+}
+
+const MargolusRule& Margolus::GetRule() const
+{
+    return m_rule;
+}
+
+bool Margolus::IsReversible() const
+{
+    return m_isReversible;
+}
+
+CellState Margolus::GetCellState(int x, int y) const
+{
+    return m_cells.GetCellState(x, y);
+}
+
+bool Margolus::SetCellState(int x, int y, CellState state)
+{
+    if (!m_cells.SetCellState(x, y, state))
+        return false;
+
+    ++m_cellsVersion;
+    return true;
+}
+
+void Margolus::GenerateEmptyCells()
+{
+    m_cells.Fill(CellState::inactive);
+    m_generation = 0;
+    ++m_cellsVersion;
+}
+
+void Margolus::GenerateRandomCells()
+{
+    GenerateEmptyCells();
+    if (m_width == 0 || m_height == 0)
+        return;
+
+    std::mt19937_64 generator(std::random_device {}());
+    for (int y = 0; y < m_height; ++y) {
+        std::uint64_t* row = m_cells.GetRow(y);
+        for (int word = 0; word < m_cells.GetWordsPerRow(); ++word) {
+            row[word] = generator() & generator();
+        }
+        row[m_cells.GetWordsPerRow() - 1] &= m_cells.GetLastWordMask();
+    }
+}
+
+const PackedCells& Margolus::GetCells() const
+{
+    return m_cells;
+}
+
+void Margolus::Step()
+{
+    UpdateBlocks(m_rule, m_generation);
+    ++m_generation;
+}
+
+bool Margolus::StepBack()
+{
+    if (!m_isReversible)
+        return false;
+
+    // The inverse rule on the partition the last generation updated puts every block back as it was.
+    UpdateBlocks(m_inverseRule, m_generation - 1);
+    --m_generation;
+    return true;
+}
+
+void Margolus::UpdateBlocks(const MargolusRule& rule, std::int64_t generation)
+{
+    if (m_width == 0 || m_height == 0)
+        return;
+
+    const BlockCodes codes = GetBlockCodes(rule);
+    const bool isOddPartition = (generation & 1) != 0;
+    const int wordsPerRow = m_cells.GetWordsPerRow();
+    const int numberOfBlockRows = m_height / 2;
+
+    // Every pair of rows is updated by exactly one band, the odd partition's last pair wrapping around to row 0.
+    const auto updateBand = [&](int firstBlockRow, int lastBlockRow) {
+        for (int blockRow = firstBlockRow; blockRow < lastBlockRow; ++blockRow) {
+            const int topRow = 2 * blockRow + (isOddPartition ? 1 : 0);
+            const int bottomRow = (topRow + 1) % m_height;
+            UpdateBlockRows(m_cells.GetRow(topRow), m_cells.GetRow(bottomRow), wordsPerRow, m_width, m_cells.GetLastWordMask(), codes, isOddPartition);
+        }
+    };
+
+    const std::size_t numberOfWords = m_cells.GetWords().size();
+    const int maximumBands = static_cast<int>(std::max<std::size_t>(1, numberOfWords / minimumWordsPerBand));
+    const int numberOfBands = std::min({ maximumBands, numberOfBlockRows, std::max(1, static_cast<int>(std::thread::hardware_concurrency())) });
+
+    // This thread updates the first band itself.
+    std::vector<std::future<void>> bands;
+    for (int band = 1; band < numberOfBands; ++band) {
+        bands.push_back(std::async(std::launch::async, updateBand, numberOfBlockRows * band / numberOfBands, numberOfBlockRows * (band + 1) / numberOfBands));
+    }
+    updateBand(0, numberOfBlockRows / numberOfBands);
+    for (auto& band : bands) {
+        band.get();
+    }
+
+    ++m_cellsVersion;
+}
+
+std::int64_t Margolus::GetGeneration() const
+{
+    return m_generation;
+}
+
+std::uint64_t Margolus::GetCellsVersion() const
+{
+    return m_cellsVersion;
+}
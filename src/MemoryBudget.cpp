@@ -0,0 +1,235 @@
+#include "MemoryBudget.h"
+
+#include <algorithm>
+#include <utility>
+
+#if defined(__linux__)
+#include <fstream>
+
+#include <unistd.h>
+#endif
+
+namespace {
+void UpdatePeak(std::atomic<std::size_t>& peak, std::size_t usage)
+{
+    std::size_t currentPeak = peak.load(std::memory_order_relaxed);
+    while (usage > currentPeak && !peak.compare_exchange_weak(currentPeak, usage, std::memory_order_relaxed)) {
+    }
+}
+}
+
+MemoryAccount::MemoryAccount(std::string name, std::function<void(std::size_t)> shrink)
+    : MemoryAccount(std::move(name), MemoryBudget::GetGlobal(), std::move(shrink))
+{
+}
+
+MemoryAccount::MemoryAccount(std::string name, MemoryBudget& budget, std::function<void(std::size_t)> shrink)
+    : m_budget(budget)
+    , m_name(std::move(name))
+    , m_shrink(std::move(shrink))
+    , m_usage(0)
+    , m_peakUsage(0)
+{
+    m_budget.Open(*this);
+}
+
+MemoryAccount::~MemoryAccount()
+{
+    m_budget.Close(*this);
+}
+
+const std::string& MemoryAccount::GetName() const
+{
+    return m_name;
+}
+
+std::size_t MemoryAccount::GetUsage() const
+{
+    return m_usage.load(std::memory_order_relaxed);
+}
+
+std::size_t MemoryAccount::GetPeakUsage() const
+{
+    return m_peakUsage.load(std::memory_order_relaxed);
+}
+
+bool MemoryAccount::IsShrinkable() const
+{
+    return m_shrink != nullptr;
+}
+
+bool MemoryAccount::Reserve(std::size_t usage, bool isRefusalReported)
+{
+    return m_budget.Reserve(*this, usage, isRefusalReported);
+}
+
+void MemoryAccount::SetUsage(std::size_t usage)
+{
+    const std::size_t oldUsage = m_usage.exchange(usage, std::memory_order_relaxed);
+    UpdatePeak(m_peakUsage, usage);
+    m_budget.AddUsage(oldUsage, usage);
+}
+
+MemoryBudget& MemoryBudget::GetGlobal()
+{
+    static MemoryBudget globalBudget;
+    return globalBudget;
+}
+
+std::size_t MemoryBudget::GetDefaultLimit()
+{
+#if defined(__linux__)
+    const long numberOfPages = sysconf(_SC_PHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    if (numberOfPages > 0 && pageSize > 0)
+        return static_cast<std::size_t>(numberOfPages) * static_cast<std::size_t>(pageSize) / 2;
+#endif
+    return std::size_t(4) * 1024 * 1024 * 1024;
+}
+
+std::size_t MemoryBudget::GetProcessResidentMemory()
+{
+#if defined(__linux__)
+    // The total and resident sizes in pages.
+    std::ifstream statm("/proc/self/statm");
+    std::size_t numberOfPages = 0;
+    std::size_t numberOfResidentPages = 0;
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    if (statm >> numberOfPages >> numberOfResidentPages && pageSize > 0)
+        return numberOfResidentPages * static_cast<std::size_t>(pageSize);
+#endif
+    return 0;
+}
+
+MemoryBudget::MemoryBudget(std::size_t limit)
+    : m_mutex()
+    , m_accounts()
+    , m_limit(limit)
+    , m_usage(0)
+    , m_peakUsage(0)
+    , m_numberOfRefusals(0)
+    , m_lastRefusal()
+{
+}
+
+std::size_t MemoryBudget::GetLimit() const
+{
+    return m_limit.load(std::memory_order_relaxed);
+}
+
+void MemoryBudget::SetLimit(std::size_t limit)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_limit = limit;
+
+    const std::size_t usage = m_usage.load(std::memory_order_relaxed);
+    if (usage > limit)
+        ShrinkCaches(usage - limit, nullptr);
+}
+
+std::size_t MemoryBudget::GetUsage() const
+{
+    return m_usage.load(std::memory_order_relaxed);
+}
+
+std::size_t MemoryBudget::GetPeakUsage() const
+{
+    return m_peakUsage.load(std::memory_order_relaxed);
+}
+
+std::vector<MemoryAccountUsage> MemoryBudget::GetAccountUsages() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<MemoryAccountUsage> accountUsages;
+    for (const MemoryAccount* account : m_accounts) {
+        accountUsages.push_back(MemoryAccountUsage { account->GetName(), account->GetUsage(), account->GetPeakUsage(), account->IsShrinkable() });
+    }
+
+    return accountUsages;
+}
+
+std::uint64_t MemoryBudget::GetNumberOfRefusals() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_numberOfRefusals;
+}
+
+MemoryRefusal MemoryBudget::GetLastRefusal() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastRefusal;
+}
+
+void MemoryBudget::Open(MemoryAccount& account)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_accounts.push_back(&account);
+}
+
+void MemoryBudget::Close(MemoryAccount& account)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_accounts.erase(std::remove(m_accounts.begin(), m_accounts.end(), &account), m_accounts.end());
+    AddUsage(account.GetUsage(), 0);
+}
+
+bool MemoryBudget::Reserve(MemoryAccount& account, std::size_t usage, bool isRefusalReported)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const std::size_t accountUsage = account.GetUsage();
+    if (usage <= accountUsage)
+        return true;
+
+    const std::size_t growth = usage - accountUsage;
+    const std::size_t limit = m_limit.load(std::memory_order_relaxed);
+    const auto getShortfall = [&]() {
+        const std::size_t totalUsage = m_usage.load(std::memory_order_relaxed) + growth;
+        return (totalUsage > limit) ? totalUsage - limit : 0;
+    };
+
+    if (getShortfall() > 0)
+        ShrinkCaches(getShortfall(), &account);
+
+    const std::size_t shortfall = getShortfall();
+    if (shortfall == 0)
+        return true;
+
+    if (isRefusalReported) {
+        ++m_numberOfRefusals;
+        m_lastRefusal = MemoryRefusal { account.GetName(), usage, usage - std::min(usage, shortfall) };
+    }
+
+    return false;
+}
+
+void MemoryBudget::AddUsage(std::size_t oldUsage, std::size_t newUsage)
+{
+    // Wraps around to take away usage that shrank.
+    const std::size_t usage = m_usage.fetch_add(newUsage - oldUsage, std::memory_order_relaxed) + (newUsage - oldUsage);
+    UpdatePeak(m_peakUsage, usage);
+}
+
+std::size_t MemoryBudget::ShrinkCaches(std::size_t bytes, const MemoryAccount* except)
+{
+    std::vector<MemoryAccount*> caches;
+    for (MemoryAccount* account : m_accounts) {
+        if (account != except && account->IsShrinkable() && account->GetUsage() > 0)
+            caches.push_back(account);
+    }
+
+    std::sort(caches.begin(), caches.end(), [](const MemoryAccount* first, const MemoryAccount* second) { return first->GetUsage() > second->GetUsage(); });
+
+    std::size_t freedBytes = 0;
+    for (MemoryAccount* cache : caches) {
+        if (freedBytes >= bytes)
+            break;
+
+        const std::size_t usage = cache->GetUsage();
+        cache->m_shrink(usage - std::min(usage, bytes - freedBytes));
+        freedBytes += usage - std::min(usage, cache->GetUsage());
+    }
+
+    return freedBytes;
+}
@@ -0,0 +1,240 @@
+#include "PackedCells.h"
+
+#include <algorithm>
+#include <tuple>
+
+bool CellCoordinates::operator<(const CellCoordinates& other) const
+{
+    return std::tie(y, x) < std::tie(other.y, other.x);
+}
+
+bool CellCoordinates::operator==(const CellCoordinates& other) const
+{
+    return x == other.x && y == other.y;
+}
+
+PackedCells::PackedCells()
+    : m_width(0)
+    , m_height(0)
+    , m_wordsPerRow(0)
+    , m_words() {}
+
+PackedCells::PackedCells(int width, int height)
+    : m_width(std::max(width, 0))
+    , m_height(std::max(height, 0))
+    , m_wordsPerRow((m_width + 63) / 64)
+    , m_words(static_cast<std::size_t>(m_wordsPerRow) * m_height, 0) {}
+
+int PackedCells::GetWidth() const
+{
+    return m_width;
+}
+
+int PackedCells::GetHeight() const
+{
+    return m_height;
+}
+
+int PackedCells::GetWordsPerRow() const
+{
+    return m_wordsPerRow;
+}
+
+std::uint64_t PackedCells::GetLastWordMask() const
+{
+    const int usedBits = m_width % 64;
+    return (usedBits == 0) ? ~std::uint64_t(0) : (std::uint64_t(1) << usedBits) - 1;
+}
+
+CellState PackedCells::GetCellState(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+        return CellState::inactive;
+
+    return static_cast<CellState>((GetRow(y)[x / 64] >> (x % 64)) & 1);
+}
+
+bool PackedCells::SetCellState(int x, int y, CellState state)
+{
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+        return false;
+
+    const std::uint64_t bit = std::uint64_t(1) << (x % 64);
+    if (state == CellState::active)
+        GetRow(y)[x / 64] |= bit;
+    else
+        GetRow(y)[x / 64] &= ~bit;
+
+    return true;
+}
+
+std::uint64_t* PackedCells::GetRow(int y)
+{
+    return m_words.data() + static_cast<std::size_t>(y) * m_wordsPerRow;
+}
+
+const std::uint64_t* PackedCells::GetRow(int y) const
+{
+    return m_words.data() + static_cast<std::size_t>(y) * m_wordsPerRow;
+}
+
+std::vector<std::uint64_t>& PackedCells::GetWords()
+{
+    return m_words;
+}
+
+const std::vector<std::uint64_t>& PackedCells::GetWords() const
+{
+    return m_words;
+}
+
+PackedCellsView PackedCells::GetView() const
+{
+    return PackedCellsView(m_words.data(), m_width, m_height, m_wordsPerRow);
+}
+
+void PackedCells::Fill(CellState state)
+{
+    std::fill(m_words.begin(), m_words.end(), (state == CellState::active) ? ~std::uint64_t(0) : 0);
+
+    if (state == CellState::active && m_wordsPerRow > 0) {
+        for (int y = 0; y < m_height; ++y) {
+            GetRow(y)[m_wordsPerRow - 1] &= GetLastWordMask();
+        }
+    }
+}
+
+void PackedCells::Resize(int width, int height)
+{
+    width = std::max(width, 0);
+    height = std::max(height, 0);
+
+    if (width == m_width && height == m_height)
+        return;
+
+    const int wordsPerRow = (width + 63) / 64;
+
+    // Rows are contiguous, so only the row count changing just adds or removes words at the end.
+    if (wordsPerRow == m_wordsPerRow) {
+        m_words.resize(static_cast<std::size_t>(wordsPerRow) * height, 0);
+        // Growing leaves spare capacity and shrinking keeps the rows cut off, neither of which is wanted for a universe.
+        m_words.shrink_to_fit();
+        m_width = width;
+        m_height = height;
+
+        // Clears cells that were cut off by a narrower width.
+        if (wordsPerRow > 0) {
+            for (int y = 0; y < m_height; ++y) {
+                GetRow(y)[m_wordsPerRow - 1] &= GetLastWordMask();
+            }
+        }
+
+        return;
+    }
+
+    PackedCells resized(width, height);
+    const int rowsToCopy = std::min(height, m_height);
+    const int wordsToCopy = std::min(wordsPerRow, m_wordsPerRow);
+    for (int y = 0; y < rowsToCopy && wordsToCopy > 0; ++y) {
+        std::copy(GetRow(y), GetRow(y) + wordsToCopy, resized.GetRow(y));
+        resized.GetRow(y)[resized.m_wordsPerRow - 1] &= resized.GetLastWordMask();
+    }
+
+    *this = std::move(resized);
+}
+
+PackedCellsView::PackedCellsView()
+    : PackedCellsView(nullptr, 0, 0, 0) {}
+
+PackedCellsView::PackedCellsView(const std::uint64_t* words, int width, int height, std::size_t stride, int bitOffset)
+    : m_words(words)
+    , m_width(std::max(width, 0))
+    , m_height(std::max(height, 0))
+    , m_stride(stride)
+    , m_bitOffset(bitOffset)
+    , m_wordsPerRow((m_width == 0) ? 0 : (bitOffset + m_width - 1) / 64 + 1)
+    , m_firstWordMask(~std::uint64_t(0) << bitOffset)
+    , m_lastWordMask(((bitOffset + m_width) % 64 == 0) ? ~std::uint64_t(0) : (std::uint64_t(1) << ((bitOffset + m_width) % 64)) - 1) {}
+
+int PackedCellsView::GetWidth() const
+{
+    return m_width;
+}
+
+int PackedCellsView::GetHeight() const
+{
+    return m_height;
+}
+
+std::size_t PackedCellsView::GetStride() const
+{
+    return m_stride;
+}
+
+int PackedCellsView::GetBitOffset() const
+{
+    return m_bitOffset;
+}
+
+const std::uint64_t* PackedCellsView::GetRow(int y) const
+{
+    return m_words + static_cast<std::size_t>(y) * m_stride;
+}
+
+int PackedCellsView::GetWordsPerRow() const
+{
+    return m_wordsPerRow;
+}
+
+std::uint64_t PackedCellsView::GetFirstWordMask() const
+{
+    return m_firstWordMask;
+}
+
+std::uint64_t PackedCellsView::GetLastWordMask() const
+{
+    return m_lastWordMask;
+}
+
+CellState PackedCellsView::GetCellState(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+        return CellState::inactive;
+
+    const int bit = m_bitOffset + x;
+    return static_cast<CellState>((GetRow(y)[bit / 64] >> (bit % 64)) & 1);
+}
+
+PackedCellsView PackedCellsView::GetTile(int x, int y, int width, int height) const
+{
+    const int firstX = std::clamp(x, 0, m_width);
+    const int firstY = std::clamp(y, 0, m_height);
+    const int lastX = std::clamp(x + std::max(width, 0), firstX, m_width);
+    const int lastY = std::clamp(y + std::max(height, 0), firstY, m_height);
+    const int firstBit = m_bitOffset + firstX;
+
+    return PackedCellsView((m_words == nullptr) ? nullptr : GetRow(firstY) + firstBit / 64, lastX - firstX, lastY - firstY, m_stride, firstBit % 64);
+}
+
+std::size_t PackedCellsView::CountLiveCells() const
+{
+    std::size_t liveCells = 0;
+    for (int y = 0; y < m_height; ++y) {
+        const std::uint64_t* row = GetRow(y);
+        for (int word = 0; word < m_wordsPerRow; ++word) {
+            std::uint64_t bits = row[word];
+            if (word == 0)
+                bits &= m_firstWordMask;
+            if (word == m_wordsPerRow - 1)
+                bits &= m_lastWordMask;
+            liveCells += CountActiveCells(bits);
+        }
+    }
+
+    return liveCells;
+}
+
+PackedCellsView::LiveCells PackedCellsView::GetLiveCells() const
+{
+    return LiveCells { *this };
+}
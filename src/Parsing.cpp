@@ -0,0 +1,13 @@
+#include "Parsing.h"
+
+bool ParseNumber(const std::string& text, std::size_t& position, int& number)
+{
+    const std::size_t start = position;
+    number = 0;
+    while (position < text.size() && text[position] >= '0' && text[position] <= '9' && position - start < 6) {
+        number = number * 10 + (text[position] - '0');
+        ++position;
+    }
+
+    return position > start;
+}
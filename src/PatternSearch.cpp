@@ -0,0 +1,675 @@
+#include "PatternSearch.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+// Spreads an index over 64 bits, so consecutive candidates of a seed are unrelated.
+std::uint64_t MixBits(std::uint64_t bits)
+{
+    bits += 0x9e3779b97f4a7c15;
+    bits = (bits ^ (bits >> 30)) * 0xbf58476d1ce4e5b9;
+    bits = (bits ^ (bits >> 27)) * 0x94d049bb133111eb;
+    return bits ^ (bits >> 31);
+}
+
+// The smallest rectangle holding every active cell, empty if there are none.
+PackedCells CropToActiveCells(const PackedCells& cells)
+{
+    int firstX = cells.GetWidth();
+    int lastX = -1;
+    int firstY = cells.GetHeight();
+    int lastY = -1;
+    for (const auto& cell : cells.GetView().GetLiveCells()) {
+        firstX = std::min(firstX, cell.x);
+        lastX = std::max(lastX, cell.x);
+        firstY = std::min(firstY, cell.y);
+        lastY = std::max(lastY, cell.y);
+    }
+
+    if (lastX < 0)
+        return PackedCells(0, 0);
+
+    PackedCells cropped(lastX - firstX + 1, lastY - firstY + 1);
+    for (const auto& cell : cells.GetView().GetTile(firstX, firstY, cropped.GetWidth(), cropped.GetHeight()).GetLiveCells()) {
+        cropped.SetCellState(cell.x, cell.y, CellState::active);
+    }
+
+    return cropped;
+}
+
+// Steps a pattern one generation, cropped to its active cells afterwards.
+PackedCells StepCropped(const PackedCells& cells, const LifeRule& rule)
+{
+    PackedCells padded(cells.GetWidth() + 2, cells.GetHeight() + 2);
+    for (const auto& cell : cells.GetView().GetLiveCells()) {
+        padded.SetCellState(cell.x + 1, cell.y + 1, CellState::active);
+    }
+
+    PackedCells next(padded.GetWidth(), padded.GetHeight());
+    StepLifeRows(padded.GetWords().data(), next.GetWords().data(), padded.GetWordsPerRow(), padded.GetHeight(), padded.GetLastWordMask(), 0, padded.GetHeight(), rule);
+    return CropToActiveCells(next);
+}
+
+// One of the 8 rotations and reflections: bit 0 mirrors left to right, bit 1 top to bottom, and bit 2 swaps the axes first.
+PackedCells TransformCells(const PackedCells& cells, int symmetry)
+{
+    const bool isTransposed = (symmetry & 4) != 0;
+    const int width = isTransposed ? cells.GetHeight() : cells.GetWidth();
+    const int height = isTransposed ? cells.GetWidth() : cells.GetHeight();
+
+    PackedCells transformed(width, height);
+    for (const auto& cell : cells.GetView().GetLiveCells()) {
+        int x = isTransposed ? cell.y : cell.x;
+        int y = isTransposed ? cell.x : cell.y;
+        if (symmetry & 1)
+            x = width - 1 - x;
+        if (symmetry & 2)
+            y = height - 1 - y;
+        transformed.SetCellState(x, y, CellState::active);
+    }
+
+    return transformed;
+}
+
+// Dimensions followed by the words, so any two patterns compare as different unless they're the same.
+std::vector<std::uint64_t> EncodeCells(const PackedCells& cells)
+{
+    std::vector<std::uint64_t> encoding { static_cast<std::uint64_t>(cells.GetWidth()), static_cast<std::uint64_t>(cells.GetHeight()) };
+    encoding.insert(encoding.end(), cells.GetWords().begin(), cells.GetWords().end());
+    return encoding;
+}
+
+std::uint64_t HashEncoding(const std::vector<std::uint64_t>& encoding)
+{
+    std::uint64_t hash = encoding.size();
+    for (const auto word : encoding) {
+        hash = MixBits(hash ^ word);
+    }
+
+    return hash;
+}
+
+// Cells [firstX, lastX) by [firstY, lastY) of a search field.
+struct FieldRegion {
+    int firstX;
+    int lastX;
+    int firstY;
+    int lastY;
+};
+
+void ClearRegion(std::uint64_t* cells, int stride, const FieldRegion& region)
+{
+    for (int y = region.firstY; y < region.lastY; ++y) {
+        std::uint64_t* row = cells + static_cast<std::size_t>(y + 1) * stride + 1;
+        std::fill(row + region.firstX, row + region.lastX, 0);
+    }
+}
+
+void ClearLanes(std::uint64_t* cells, int stride, const FieldRegion& region, std::uint64_t lanes)
+{
+    for (int y = region.firstY; y < region.lastY; ++y) {
+        std::uint64_t* row = cells + static_cast<std::size_t>(y + 1) * stride + 1;
+        for (int x = region.firstX; x < region.lastX; ++x) {
+            row[x] &= ~lanes;
+        }
+    }
+}
+
+// Lanes with an active cell on the edge of a field, given the region holding all of its active cells.
+std::uint64_t GetEdgeLanes(const std::uint64_t* cells, int stride, int fieldWidth, int fieldHeight, const FieldRegion& region)
+{
+    const auto getWord = [&](int x, int y) { return cells[static_cast<std::size_t>(y + 1) * stride + x + 1]; };
+    std::uint64_t lanes = 0;
+    for (int x = region.firstX; x < region.lastX; ++x) {
+        if (region.firstY == 0)
+            lanes |= getWord(x, 0);
+        if (region.lastY == fieldHeight)
+            lanes |= getWord(x, fieldHeight - 1);
+    }
+    for (int y = region.firstY; y < region.lastY; ++y) {
+        if (region.firstX == 0)
+            lanes |= getWord(0, y);
+        if (region.lastX == fieldWidth)
+            lanes |= getWord(fieldWidth - 1, y);
+    }
+
+    return lanes;
+}
+
+// Steps the words of one generation within the region into the next, returning every lane that has an active cell
+// and the smallest region holding those cells.
+template <bool isConway>
+std::uint64_t StepLanes(const std::uint64_t* current, std::uint64_t* next, int stride, const FieldRegion& region, FieldRegion& activeRegion, const LifeRule& rule)
+{
+    std::uint64_t activeLanes = 0;
+    activeRegion = FieldRegion { region.lastX, region.firstX, region.lastY, region.firstY };
+    for (int y = region.firstY; y < region.lastY; ++y) {
+        const std::uint64_t* above = current + static_cast<std::size_t>(y) * stride;
+        const std::uint64_t* middle = above + stride;
+        const std::uint64_t* below = middle + stride;
+        std::uint64_t* result = next + static_cast<std::size_t>(y + 1) * stride;
+
+        // Neighbouring cells are neighbouring words, as in LifeEnsemble.
+        std::uint64_t rowLanes = 0;
+        for (int x = region.firstX + 1; x <= region.lastX; ++x) {
+            if (isConway)
+                result[x] = NextLifeWord(above[x - 1], above[x], above[x + 1], middle[x - 1], middle[x], middle[x + 1], below[x - 1], below[x], below[x + 1]);
+            else
+                result[x] = NextLifeLikeWord(above[x - 1], above[x], above[x + 1], middle[x - 1], middle[x], middle[x + 1], below[x - 1], below[x], below[x + 1], rule);
+            rowLanes |= result[x];
+        }
+
+        if (rowLanes == 0)
+            continue;
+
+        // Word x of a row holds cell x - 1, after the border.
+        int firstWord = region.firstX + 1;
+        while (result[firstWord] == 0)
+            ++firstWord;
+        int lastWord = region.lastX;
+        while (result[lastWord] == 0)
+            --lastWord;
+
+        activeRegion.firstX = std::min(activeRegion.firstX, firstWord - 1);
+        activeRegion.lastX = std::max(activeRegion.lastX, lastWord);
+        activeRegion.firstY = std::min(activeRegion.firstY, y);
+        activeRegion.lastY = y + 1;
+        activeLanes |= rowLanes;
+    }
+
+    return activeLanes;
+}
+}
+
+// Generation g is kept in slot g % (maximumPeriod + 1). A slot's words outside the region last stepped into it are all inactive,
+// and its active cells are all within its active region, which is only ever larger than they need after lanes are dropped.
+struct PatternSearch::Field {
+    std::vector<std::uint64_t> generations;
+    std::vector<FieldRegion> steppedRegions;
+    std::vector<FieldRegion> activeRegions;
+    // Lanes in each column and row of a generation's active region, for finding each lane's bounds.
+    std::vector<std::uint64_t> columnLanes;
+    std::vector<std::uint64_t> rowLanes;
+};
+
+PatternSearch::PatternSearch()
+    : m_settings { 5, 5, true, 0, 1, 4, 0, LifeRule::Conway() }
+    , m_numberOfCandidates(0)
+    , m_numberOfChunks(0)
+    , m_lastGeneration(0)
+    , m_margin(0)
+    , m_fieldWidth(0)
+    , m_fieldHeight(0)
+    , m_stride(0)
+    , m_generationSize(0)
+    , m_workRanges()
+    , m_workers()
+    , m_isStopping(false)
+    , m_numberOfRunningWorkers(0)
+    , m_numberOfTestedCandidates(0)
+    , m_startTime()
+    , m_seconds(0.0)
+    , m_resultsMutex()
+    , m_results()
+    , m_canonicalForms()
+    , m_resultsByHash()
+    , m_memoryAccount("Pattern search")
+{
+}
+
+PatternSearch::~PatternSearch()
+{
+    Stop();
+}
+
+bool PatternSearch::Start(const PatternSearchSettings& settings)
+{
+    Stop();
+
+    const int numberOfBoxCells = settings.boxWidth * settings.boxHeight;
+    if (settings.boxWidth < 1 || settings.boxHeight < 1 || settings.boxWidth > PatternSearchSettings::maximumBoxSize || settings.boxHeight > PatternSearchSettings::maximumBoxSize
+        || (settings.isExhaustive && numberOfBoxCells > PatternSearchSettings::maximumExhaustiveCells)
+        || settings.maximumPeriod < 1 || settings.maximumPeriod > PatternSearchSettings::maximumPeriodLimit
+        || settings.settleGenerations < 0 || settings.settleGenerations > PatternSearchSettings::maximumSettleGenerations
+        || (settings.rule.birth & 1) != 0)
+        return false;
+
+    // Cells move at most one cell a generation, so the field only has to reach as far as light can go, if that's any closer.
+    const int lastGeneration = settings.settleGenerations + settings.maximumPeriod;
+    const int margin = std::min(lastGeneration, PatternSearchSettings::maximumFieldReach);
+    const int fieldWidth = settings.boxWidth + 2 * margin;
+    const int fieldHeight = settings.boxHeight + 2 * margin;
+    const std::size_t generationSize = static_cast<std::size_t>(fieldWidth + 2) * (fieldHeight + 2);
+
+    const int numberOfWorkers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const std::size_t memoryUsage = numberOfWorkers * generationSize * (settings.maximumPeriod + 1) * sizeof(std::uint64_t);
+    if (!m_memoryAccount.Reserve(memoryUsage))
+        return false;
+
+    m_memoryAccount.SetUsage(memoryUsage);
+    m_settings = settings;
+    m_numberOfCandidates = settings.isExhaustive ? std::uint64_t(1) << numberOfBoxCells : settings.numberOfRandomCandidates;
+    m_numberOfChunks = (m_numberOfCandidates + numberOfLanes - 1) / numberOfLanes;
+    m_lastGeneration = lastGeneration;
+    m_margin = margin;
+    m_fieldWidth = fieldWidth;
+    m_fieldHeight = fieldHeight;
+    m_stride = fieldWidth + 2;
+    m_generationSize = generationSize;
+
+    {
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        m_results.clear();
+        m_canonicalForms.clear();
+        m_resultsByHash.clear();
+    }
+
+    m_workRanges.clear();
+    for (int worker = 0; worker < numberOfWorkers; ++worker) {
+        m_workRanges.push_back(std::make_unique<WorkRange>());
+        m_workRanges.back()->next = m_numberOfChunks / numberOfWorkers * worker + std::min<std::uint64_t>(worker, m_numberOfChunks % numberOfWorkers);
+        m_workRanges.back()->end = m_workRanges.back()->next + m_numberOfChunks / numberOfWorkers + (static_cast<std::uint64_t>(worker) < m_numberOfChunks % numberOfWorkers ? 1 : 0);
+    }
+
+    m_isStopping = false;
+    m_numberOfRunningWorkers = numberOfWorkers;
+    m_numberOfTestedCandidates = 0;
+    m_seconds = 0.0;
+    m_startTime = std::chrono::steady_clock::now();
+    for (int worker = 0; worker < numberOfWorkers; ++worker) {
+        m_workers.push_back(std::async(std::launch::async, &PatternSearch::RunWorker, this, worker));
+    }
+
+    return true;
+}
+
+void PatternSearch::Stop()
+{
+    m_isStopping = true;
+    for (auto& worker : m_workers) {
+        worker.get();
+    }
+    m_workers.clear();
+    m_memoryAccount.SetUsage(0);
+}
+
+bool PatternSearch::IsRunning() const
+{
+    return m_numberOfRunningWorkers > 0;
+}
+
+const PatternSearchSettings& PatternSearch::GetSettings() const
+{
+    return m_settings;
+}
+
+std::uint64_t PatternSearch::GetNumberOfCandidates() const
+{
+    return m_numberOfCandidates;
+}
+
+std::uint64_t PatternSearch::GetNumberOfTestedCandidates() const
+{
+    return m_numberOfTestedCandidates;
+}
+
+double PatternSearch::GetSeconds() const
+{
+    if (IsRunning())
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+
+    return m_seconds;
+}
+
+std::vector<FoundPattern> PatternSearch::GetResults() const
+{
+    std::lock_guard<std::mutex> lock(m_resultsMutex);
+    return m_results;
+}
+
+std::size_t PatternSearch::GetNumberOfResults() const
+{
+    std::lock_guard<std::mutex> lock(m_resultsMutex);
+    return m_results.size();
+}
+
+// Only one range is ever locked at a time. A thief takes the top half of the largest range, which its owner isn't working near.
+bool PatternSearch::TakeChunk(int worker, std::uint64_t& chunk)
+{
+    WorkRange& ownRange = *m_workRanges[worker];
+    {
+        std::lock_guard<std::mutex> lock(ownRange.mutex);
+        if (ownRange.next < ownRange.end) {
+            chunk = ownRange.next++;
+            return true;
+        }
+    }
+
+    for (;;) {
+        int victim = -1;
+        std::uint64_t mostRemaining = 0;
+        for (int other = 0; other < static_cast<int>(m_workRanges.size()); ++other) {
+            std::lock_guard<std::mutex> lock(m_workRanges[other]->mutex);
+            const std::uint64_t remaining = m_workRanges[other]->end - m_workRanges[other]->next;
+            if (remaining > mostRemaining) {
+                victim = other;
+                mostRemaining = remaining;
+            }
+        }
+
+        if (victim < 0)
+            return false;
+
+        std::uint64_t first = 0;
+        std::uint64_t end = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_workRanges[victim]->mutex);
+            WorkRange& victimRange = *m_workRanges[victim];
+            // Someone else may have got there first.
+            if (victimRange.next >= victimRange.end)
+                continue;
+
+            end = victimRange.end;
+            first = victimRange.next + (victimRange.end - victimRange.next) / 2;
+            victimRange.end = first;
+        }
+
+        std::lock_guard<std::mutex> lock(ownRange.mutex);
+        chunk = first;
+        ownRange.next = first + 1;
+        ownRange.end = end;
+        return true;
+    }
+}
+
+void PatternSearch::RunWorker(int worker)
+{
+    const int numberOfSlots = m_settings.maximumPeriod + 1;
+    Field field;
+    field.generations.assign(m_generationSize * numberOfSlots, 0);
+    field.steppedRegions.assign(numberOfSlots, FieldRegion { 0, 0, 0, 0 });
+    field.activeRegions.assign(numberOfSlots, FieldRegion { 0, 0, 0, 0 });
+
+    std::uint64_t chunk = 0;
+    while (!m_isStopping && TakeChunk(worker, chunk)) {
+        SearchChunk(chunk, field);
+        m_numberOfTestedCandidates += std::min<std::uint64_t>(numberOfLanes, m_numberOfCandidates - chunk * numberOfLanes);
+    }
+
+    // Every field is given back once the last worker finishes.
+    if (--m_numberOfRunningWorkers == 0) {
+        m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+        m_memoryAccount.SetUsage(0);
+    }
+}
+
+void PatternSearch::SearchChunk(std::uint64_t chunk, Field& field)
+{
+    const int boxWidth = m_settings.boxWidth;
+    const int boxHeight = m_settings.boxHeight;
+    const int numberOfBoxCells = boxWidth * boxHeight;
+    const int numberOfSlots = m_settings.maximumPeriod + 1;
+    const auto getGeneration = [&](int generation) { return field.generations.data() + static_cast<std::size_t>(generation % numberOfSlots) * m_generationSize; };
+    const auto getIndex = [&](int x, int y) { return static_cast<std::size_t>(y + 1) * m_stride + x + 1; };
+
+    // Only the regions the last chunk stepped into can have active words left.
+    for (int slot = 0; slot < numberOfSlots; ++slot) {
+        ClearRegion(getGeneration(slot), m_stride, field.steppedRegions[slot]);
+        field.steppedRegions[slot] = FieldRegion { 0, 0, 0, 0 };
+        field.activeRegions[slot] = FieldRegion { 0, 0, 0, 0 };
+    }
+
+    const std::uint64_t firstCandidate = chunk * numberOfLanes;
+    const std::uint64_t numberOfCandidates = std::min<std::uint64_t>(numberOfLanes, m_numberOfCandidates - firstCandidate);
+    const std::uint64_t candidateLanes = (numberOfCandidates == numberOfLanes) ? ~std::uint64_t(0) : (std::uint64_t(1) << numberOfCandidates) - 1;
+
+    // Bit i of a candidate's configuration is cell (i % boxWidth, i / boxWidth) of the box, and each cell's word holds it for every lane.
+    std::uint64_t* initialCells = getGeneration(0);
+    if (m_settings.isExhaustive) {
+        // The lane is the low 6 bits of the configuration and the chunk the rest, so each cell's word is one of a few fixed patterns.
+        static constexpr std::uint64_t laneBits[6] = { 0xaaaaaaaaaaaaaaaa, 0xcccccccccccccccc, 0xf0f0f0f0f0f0f0f0, 0xff00ff00ff00ff00, 0xffff0000ffff0000, 0xffffffff00000000 };
+        for (int cell = 0; cell < numberOfBoxCells; ++cell) {
+            const std::uint64_t word = (cell < 6) ? laneBits[cell] : (((firstCandidate >> cell) & 1) ? ~std::uint64_t(0) : 0);
+            initialCells[getIndex(m_margin + cell % boxWidth, m_margin + cell / boxWidth)] = word & candidateLanes;
+        }
+    } else {
+        std::uint64_t configurations[numberOfLanes] = {};
+        for (int lane = 0; lane < static_cast<int>(numberOfCandidates); ++lane) {
+            configurations[lane] = MixBits(m_settings.seed * 0x9e3779b97f4a7c15 + firstCandidate + lane);
+        }
+        for (int cell = 0; cell < numberOfBoxCells; ++cell) {
+            std::uint64_t word = 0;
+            for (int lane = 0; lane < numberOfLanes; ++lane) {
+                word |= ((configurations[lane] >> cell) & 1) << lane;
+            }
+            initialCells[getIndex(m_margin + cell % boxWidth, m_margin + cell / boxWidth)] = word;
+        }
+    }
+
+    field.steppedRegions[0] = FieldRegion { m_margin, m_margin + boxWidth, m_margin, m_margin + boxHeight };
+    field.activeRegions[0] = field.steppedRegions[0];
+
+    // Cells spread at most one cell a generation, so only the active region grown by a cell is stepped,
+    // after clearing whatever the slot's earlier generation left.
+    const bool isConway = (m_settings.rule == LifeRule::Conway());
+    std::uint64_t activeLanes = 0;
+    for (int generation = 0; generation < m_lastGeneration; ++generation) {
+        const int slot = (generation + 1) % numberOfSlots;
+        const FieldRegion& activeRegion = field.activeRegions[generation % numberOfSlots];
+        const FieldRegion region { std::max(activeRegion.firstX - 1, 0), std::min(activeRegion.lastX + 1, m_fieldWidth),
+            std::max(activeRegion.firstY - 1, 0), std::min(activeRegion.lastY + 1, m_fieldHeight) };
+
+        std::uint64_t* nextCells = getGeneration(generation + 1);
+        ClearRegion(nextCells, m_stride, field.steppedRegions[slot]);
+        field.steppedRegions[slot] = region;
+        activeLanes = isConway ? StepLanes<true>(getGeneration(generation), nextCells, m_stride, region, field.activeRegions[slot], m_settings.rule)
+                               : StepLanes<false>(getGeneration(generation), nextCells, m_stride, region, field.activeRegions[slot], m_settings.rule);
+        if (activeLanes == 0)
+            return;
+
+        // Lanes at the edge would spread out of the field, so they're compared now instead of at the last generation, and dropped.
+        const FieldRegion& nextRegion = field.activeRegions[slot];
+        const bool isAtEdge = nextRegion.firstX == 0 || nextRegion.lastX == m_fieldWidth || nextRegion.firstY == 0 || nextRegion.lastY == m_fieldHeight;
+        if (!isAtEdge || generation + 1 == m_lastGeneration)
+            continue;
+
+        const std::uint64_t edgeLanes = GetEdgeLanes(nextCells, m_stride, m_fieldWidth, m_fieldHeight, nextRegion);
+        if (edgeLanes == 0)
+            continue;
+
+        RecordRepeatingLanes(field, generation + 1, edgeLanes, firstCandidate);
+        for (int droppedSlot = 0; droppedSlot < numberOfSlots; ++droppedSlot) {
+            ClearLanes(getGeneration(droppedSlot), m_stride, field.steppedRegions[droppedSlot], edgeLanes);
+        }
+        activeLanes &= ~edgeLanes;
+        if (activeLanes == 0)
+            return;
+    }
+
+    RecordRepeatingLanes(field, m_lastGeneration, activeLanes, firstCandidate);
+}
+
+std::uint64_t PatternSearch::RecordRepeatingLanes(Field& field, int generation, std::uint64_t lanes, std::uint64_t firstCandidate)
+{
+    const int numberOfSlots = m_settings.maximumPeriod + 1;
+    const auto getGeneration = [&](int slotGeneration) { return field.generations.data() + static_cast<std::size_t>(slotGeneration % numberOfSlots) * m_generationSize; };
+    const auto getIndex = [&](int x, int y) { return static_cast<std::size_t>(y + 1) * m_stride + x + 1; };
+
+    // Bounds of each lane's active cells. A lane can only repeat moved by (dx, dy) if its bounds did the same, so the bounds
+    // give the one movement worth comparing for each lane and period, rather than every movement light allows.
+    struct LaneBounds {
+        int firstX[numberOfLanes];
+        int lastX[numberOfLanes];
+        int firstY[numberOfLanes];
+        int lastY[numberOfLanes];
+    };
+
+    // Only a generation's active region is scanned, as it holds all of its active cells.
+    std::vector<std::uint64_t>& columnLanes = field.columnLanes;
+    std::vector<std::uint64_t>& rowLanes = field.rowLanes;
+    const auto findBounds = [&](int boundedGeneration, LaneBounds& bounds) {
+        const std::uint64_t* cells = getGeneration(boundedGeneration);
+        const FieldRegion& region = field.activeRegions[boundedGeneration % numberOfSlots];
+        columnLanes.assign(static_cast<std::size_t>(std::max(region.lastX - region.firstX, 0)), 0);
+        rowLanes.assign(static_cast<std::size_t>(std::max(region.lastY - region.firstY, 0)), 0);
+        for (int y = region.firstY; y < region.lastY; ++y) {
+            const std::uint64_t* row = cells + getIndex(0, y);
+            std::uint64_t lanesInRow = 0;
+            for (int x = region.firstX; x < region.lastX; ++x) {
+                lanesInRow |= row[x];
+                columnLanes[x - region.firstX] |= row[x];
+            }
+            rowLanes[y - region.firstY] = lanesInRow;
+        }
+
+        // The first and last row or column each lane appears in.
+        const auto scatter = [](const std::vector<std::uint64_t>& lanesAt, int offset, int* first, int* last) {
+            std::uint64_t seenLanes = 0;
+            for (int position = 0; position < static_cast<int>(lanesAt.size()); ++position) {
+                for (std::uint64_t newLanes = lanesAt[position] & ~seenLanes; newLanes != 0; newLanes &= newLanes - 1)
+                    first[CountTrailingZeros(newLanes)] = position + offset;
+                seenLanes |= lanesAt[position];
+            }
+            seenLanes = 0;
+            for (int position = static_cast<int>(lanesAt.size()) - 1; position >= 0; --position) {
+                for (std::uint64_t newLanes = lanesAt[position] & ~seenLanes; newLanes != 0; newLanes &= newLanes - 1)
+                    last[CountTrailingZeros(newLanes)] = position + offset;
+                seenLanes |= lanesAt[position];
+            }
+        };
+        scatter(columnLanes, region.firstX, bounds.firstX, bounds.lastX);
+        scatter(rowLanes, region.firstY, bounds.firstY, bounds.lastY);
+    };
+
+    // Lanes present in a generation, from the rows just scanned.
+    const auto getPresentLanes = [&]() {
+        std::uint64_t presentLanes = 0;
+        for (const auto rowLane : rowLanes)
+            presentLanes |= rowLane;
+        return presentLanes;
+    };
+
+    // A lane repeats with period p when the generation is generation - p moved by (dx, dy). Shorter periods are tried
+    // first so each lane keeps its smallest, and comparing stops as soon as every lane being compared has a difference.
+    const std::uint64_t* lastCells = getGeneration(generation);
+    LaneBounds lastBounds;
+    findBounds(generation, lastBounds);
+    std::uint64_t remainingLanes = lanes;
+    int periods[numberOfLanes] = {};
+    int displacementsX[numberOfLanes] = {};
+    int displacementsY[numberOfLanes] = {};
+
+    LaneBounds earlierBounds;
+    const int maximumPeriod = std::min(m_settings.maximumPeriod, generation);
+    for (int period = 1; period <= maximumPeriod && remainingLanes != 0; ++period) {
+        const std::uint64_t* earlierCells = getGeneration(generation - period);
+        findBounds(generation - period, earlierBounds);
+
+        // Lanes grouped by the movement their bounds made, with the rows and columns to compare for each group.
+        struct Movement {
+            int dx;
+            int dy;
+            std::uint64_t lanes;
+            int firstX;
+            int lastX;
+            int firstY;
+            int lastY;
+        };
+        std::vector<Movement> movements;
+        for (std::uint64_t comparedLanes = remainingLanes & getPresentLanes(); comparedLanes != 0; comparedLanes &= comparedLanes - 1) {
+            const int lane = CountTrailingZeros(comparedLanes);
+            const int dx = lastBounds.firstX[lane] - earlierBounds.firstX[lane];
+            const int dy = lastBounds.firstY[lane] - earlierBounds.firstY[lane];
+            if (lastBounds.lastX[lane] - earlierBounds.lastX[lane] != dx || lastBounds.lastY[lane] - earlierBounds.lastY[lane] != dy
+                || std::abs(dx) > period || std::abs(dy) > period)
+                continue;
+
+            auto movement = std::find_if(movements.begin(), movements.end(), [&](const Movement& other) { return other.dx == dx && other.dy == dy; });
+            if (movement == movements.end()) {
+                movements.push_back(Movement { dx, dy, 0, lastBounds.firstX[lane], lastBounds.lastX[lane], lastBounds.firstY[lane], lastBounds.lastY[lane] });
+                movement = movements.end() - 1;
+            }
+            movement->lanes |= std::uint64_t(1) << lane;
+            movement->firstX = std::min(movement->firstX, lastBounds.firstX[lane]);
+            movement->lastX = std::max(movement->lastX, lastBounds.lastX[lane]);
+            movement->firstY = std::min(movement->firstY, lastBounds.firstY[lane]);
+            movement->lastY = std::max(movement->lastY, lastBounds.lastY[lane]);
+        }
+
+        std::uint64_t repeatingLanes = 0;
+        for (const auto& movement : movements) {
+            // Outside the lanes' bounds both generations are inactive.
+            std::uint64_t differentLanes = 0;
+            for (int y = movement.firstY; y <= movement.lastY && (differentLanes & movement.lanes) != movement.lanes; ++y) {
+                const std::uint64_t* row = lastCells + getIndex(0, y);
+                const std::uint64_t* earlierRow = earlierCells + getIndex(-movement.dx, y - movement.dy);
+                for (int x = movement.firstX; x <= movement.lastX; ++x) {
+                    differentLanes |= row[x] ^ earlierRow[x];
+                }
+            }
+
+            for (std::uint64_t sameLanes = movement.lanes & ~differentLanes; sameLanes != 0; sameLanes &= sameLanes - 1) {
+                const int lane = CountTrailingZeros(sameLanes);
+                periods[lane] = period;
+                displacementsX[lane] = movement.dx;
+                displacementsY[lane] = movement.dy;
+            }
+            repeatingLanes |= movement.lanes & ~differentLanes;
+        }
+        remainingLanes &= ~repeatingLanes;
+    }
+
+    const std::uint64_t settledLanes = lanes & ~remainingLanes;
+    for (std::uint64_t foundLanes = settledLanes; foundLanes != 0; foundLanes &= foundLanes - 1) {
+        const int lane = CountTrailingZeros(foundLanes);
+        PackedCells cells(lastBounds.lastX[lane] - lastBounds.firstX[lane] + 1, lastBounds.lastY[lane] - lastBounds.firstY[lane] + 1);
+        for (int y = lastBounds.firstY[lane]; y <= lastBounds.lastY[lane]; ++y) {
+            for (int x = lastBounds.firstX[lane]; x <= lastBounds.lastX[lane]; ++x) {
+                if ((lastCells[getIndex(x, y)] >> lane) & 1)
+                    cells.SetCellState(x - lastBounds.firstX[lane], y - lastBounds.firstY[lane], CellState::active);
+            }
+        }
+
+        RecordPattern(cells, periods[lane], displacementsX[lane], displacementsY[lane], firstCandidate + lane);
+    }
+
+    return settledLanes;
+}
+
+// The canonical form is the smallest encoding of every phase in every orientation, so the same pattern always has the same one.
+void PatternSearch::RecordPattern(const PackedCells& cells, int period, int dx, int dy, std::uint64_t candidate)
+{
+    std::vector<std::uint64_t> canonicalForm;
+    PackedCells phase = cells;
+    for (int generation = 0; generation < period; ++generation) {
+        for (int symmetry = 0; symmetry < 8; ++symmetry) {
+            std::vector<std::uint64_t> encoding = EncodeCells(TransformCells(phase, symmetry));
+            if (canonicalForm.empty() || encoding < canonicalForm)
+                canonicalForm = std::move(encoding);
+        }
+        phase = StepCropped(phase, m_settings.rule);
+    }
+
+    const std::uint64_t hash = HashEncoding(canonicalForm);
+    std::lock_guard<std::mutex> lock(m_resultsMutex);
+    auto& sameHashResults = m_resultsByHash[hash];
+    for (const auto result : sameHashResults) {
+        if (m_canonicalForms[result] == canonicalForm) {
+            ++m_results[result].numberOfOccurrences;
+            m_results[result].firstCandidate = std::min(m_results[result].firstCandidate, candidate);
+            return;
+        }
+    }
+
+    const PatternKind kind = (dx != 0 || dy != 0) ? PatternKind::spaceship : (period == 1 ? PatternKind::stillLife : PatternKind::oscillator);
+    int population = 0;
+    for (const auto word : cells.GetWords()) {
+        population += CountActiveCells(word);
+    }
+
+    sameHashResults.push_back(m_results.size());
+    m_results.push_back(FoundPattern { cells, kind, period, dx, dy, population, 1, candidate });
+    m_canonicalForms.push_back(std::move(canonicalForm));
+}
@@ -0,0 +1,712 @@
+#include "SimulationService.h"
+#include "LifeKernel.h"
+#include "WordCompression.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <sstream>
+#include <utility>
+
+#if defined(__linux__)
+
+#include <cerrno>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+std::size_t GetCellsSize(int width, int height)
+{
+    return static_cast<std::size_t>((width + 63) / 64) * static_cast<std::size_t>(height) * sizeof(std::uint64_t);
+}
+
+enum MessageType : std::uint32_t {
+    reply = 1,
+    frame = 2
+};
+
+template <typename Value>
+void AppendValue(std::vector<std::uint8_t>& output, Value value)
+{
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+    output.insert(output.end(), bytes, bytes + sizeof(value));
+}
+
+// Copies the viewport out of the universe, cells of the viewport outside the universe are inactive.
+void CopyViewport(const PackedCells& universe, int viewportX, int viewportY, PackedCells& viewport)
+{
+    const int wordsPerRow = universe.GetWordsPerRow();
+
+    for (int y = 0; y < viewport.GetHeight(); ++y) {
+        std::uint64_t* row = viewport.GetRow(y);
+        const int universeY = viewportY + y;
+        if (universeY < 0 || universeY >= universe.GetHeight()) {
+            std::fill(row, row + viewport.GetWordsPerRow(), 0);
+            continue;
+        }
+
+        const std::uint64_t* universeRow = universe.GetRow(universeY);
+        const auto wordAt = [&](long long word) -> std::uint64_t {
+            return (word >= 0 && word < wordsPerRow) ? universeRow[word] : 0;
+        };
+
+        for (int word = 0; word < viewport.GetWordsPerRow(); ++word) {
+            // The viewport's word starts part way through a word of the universe, so it's made of two words of the universe.
+            const long long firstCell = static_cast<long long>(viewportX) + 64LL * word;
+            const long long firstWord = (firstCell >= 0) ? firstCell / 64 : (firstCell - 63) / 64;
+            const int shift = static_cast<int>(firstCell - firstWord * 64);
+            row[word] = (shift == 0) ? wordAt(firstWord) : (wordAt(firstWord) >> shift) | (wordAt(firstWord + 1) << (64 - shift));
+        }
+
+        row[viewport.GetWordsPerRow() - 1] &= viewport.GetLastWordMask();
+    }
+}
+}
+
+SimulationService::SimulationService()
+    : m_gameOfLife()
+    , m_pendingGenerations(0)
+    , m_isRunning(false)
+    , m_commandMutex()
+    , m_commandCondition()
+    , m_commands()
+    , m_isSteppingStopped(false)
+    , m_isApplyingEditsQueued(false)
+    , m_generationMutex()
+    , m_latestGeneration()
+    , m_publishedGeneration()
+    , m_spareGeneration()
+    , m_numberOfSubscribers(0)
+    , m_memoryAccount("Served generations")
+    , m_replyMutex()
+    , m_replies()
+    , m_clients()
+    , m_nextClientId(0)
+    , m_listenSocket(-1)
+    , m_wakeEvent(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+    , m_isStopping(false)
+{
+    // Nothing scrubs back through a served universe, so there's no need to record it.
+    m_gameOfLife.SetRecordingHistory(false);
+}
+
+SimulationService::~SimulationService()
+{
+    if (m_wakeEvent >= 0)
+        close(m_wakeEvent);
+}
+
+bool SimulationService::IsSupported()
+{
+    return true;
+}
+
+void SimulationService::Stop()
+{
+    m_isStopping = true;
+    const std::uint64_t wake = 1;
+    if (m_wakeEvent >= 0 && write(m_wakeEvent, &wake, sizeof(wake)) != sizeof(wake)) {
+        // The counter is already non-zero, so the service will wake anyway.
+    }
+}
+
+void SimulationService::QueueCommand(std::function<void()> command)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_commandMutex);
+        m_commands.push_back(std::move(command));
+    }
+    m_commandCondition.notify_one();
+}
+
+void SimulationService::QueueReply(std::uint64_t clientId, std::string reply)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_replyMutex);
+        m_replies.emplace_back(clientId, std::move(reply));
+    }
+
+    const std::uint64_t wake = 1;
+    if (write(m_wakeEvent, &wake, sizeof(wake)) != sizeof(wake)) {
+        // The counter is already non-zero, so the reply will be sent anyway.
+    }
+}
+
+void SimulationService::RunStepping()
+{
+    for (;;) {
+        std::vector<std::function<void()>> commands;
+        {
+            std::unique_lock<std::mutex> lock(m_commandMutex);
+            m_commandCondition.wait(lock, [this] { return m_isSteppingStopped || !m_commands.empty() || m_pendingGenerations > 0 || m_isRunning; });
+            if (m_isSteppingStopped)
+                return;
+
+            commands.swap(m_commands);
+        }
+
+        for (const auto& command : commands) {
+            command();
+        }
+
+        if (m_pendingGenerations > 0 || m_isRunning) {
+            m_gameOfLife.SetAllCellStates();
+            if (m_pendingGenerations > 0)
+                --m_pendingGenerations;
+        }
+
+        // Without subscribers only keyframes need a generation, and they ask for it, so the spare copy isn't kept either.
+        if (m_numberOfSubscribers.load() > 0) {
+            PublishGeneration();
+        } else if (m_spareGeneration) {
+            m_spareGeneration.reset();
+            UpdateMemoryUsage();
+        }
+    }
+}
+
+bool SimulationService::PublishGeneration()
+{
+    // The generation published before last is written over once no client is building a frame from it, so large universes
+    // aren't allocated again every generation. Clients only take it while it's the latest, so nobody can take it from here on,
+    // and the fence makes sure every client that let go of it has finished reading.
+    std::shared_ptr<PublishedGeneration> generation = std::move(m_spareGeneration);
+    if (generation && generation.use_count() == 1)
+        std::atomic_thread_fence(std::memory_order_acquire);
+    else
+        generation.reset();
+
+    const int width = m_gameOfLife.GetWidth();
+    const int height = m_gameOfLife.GetHeight();
+    if (!generation || generation->cells.GetWidth() != width || generation->cells.GetHeight() != height) {
+        const std::size_t publishedSize = m_publishedGeneration ? GetCellsSize(m_publishedGeneration->cells.GetWidth(), m_publishedGeneration->cells.GetHeight()) : 0;
+        if (!m_memoryAccount.Reserve(publishedSize + GetCellsSize(width, height))) {
+            UpdateMemoryUsage();
+            return false;
+        }
+
+        if (!generation)
+            generation = std::make_shared<PublishedGeneration>();
+        generation->cells = PackedCells(width, height);
+    }
+
+    const std::uint64_t* words = m_gameOfLife.GetCurrentWords();
+    std::copy(words, words + generation->cells.GetWords().size(), generation->cells.GetWords().begin());
+    generation->generation = m_gameOfLife.GetGeneration();
+    generation->version = m_publishedGeneration ? m_publishedGeneration->version + 1 : 1;
+
+    {
+        std::lock_guard<std::mutex> lock(m_generationMutex);
+        m_latestGeneration = generation;
+    }
+    m_spareGeneration = std::move(m_publishedGeneration);
+    m_publishedGeneration = std::move(generation);
+    UpdateMemoryUsage();
+
+    const std::uint64_t wake = 1;
+    if (write(m_wakeEvent, &wake, sizeof(wake)) != sizeof(wake)) {
+        // The counter is already non-zero, so the clients will be served anyway.
+    }
+    return true;
+}
+
+void SimulationService::UpdateMemoryUsage()
+{
+    std::size_t usage = 0;
+    for (const auto* generation : { m_publishedGeneration.get(), m_spareGeneration.get() }) {
+        if (generation != nullptr)
+            usage += GetCellsSize(generation->cells.GetWidth(), generation->cells.GetHeight());
+    }
+
+    m_memoryAccount.SetUsage(usage);
+}
+
+std::shared_ptr<const SimulationService::PublishedGeneration> SimulationService::GetLatestGeneration()
+{
+    std::lock_guard<std::mutex> lock(m_generationMutex);
+    return m_latestGeneration;
+}
+
+bool SimulationService::Run(const std::string& socketPath)
+{
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (m_wakeEvent < 0 || socketPath.empty() || socketPath.size() >= sizeof(address.sun_path))
+        return false;
+
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    m_listenSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listenSocket < 0)
+        return false;
+
+    // A socket left behind by a previous run would make bind fail.
+    unlink(socketPath.c_str());
+    if (bind(m_listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(m_listenSocket, 16) != 0) {
+        close(m_listenSocket);
+        m_listenSocket = -1;
+        return false;
+    }
+
+    m_isSteppingStopped = false;
+    auto stepping = std::async(std::launch::async, [this] { RunStepping(); });
+
+    std::vector<pollfd> pollDescriptors;
+    bool isInputPending = false;
+    while (!m_isStopping) {
+        pollDescriptors.clear();
+        pollDescriptors.push_back({ m_wakeEvent, POLLIN, 0 });
+        pollDescriptors.push_back({ m_listenSocket, POLLIN, 0 });
+        for (const auto& client : m_clients) {
+            // A client awaiting a reply or with a full queue isn't read from, nor polled at all unless it has output,
+            // since a hangup would always be reported.
+            const bool hasOutput = client.outputOffset < client.output.size();
+            if (client.isAwaitingReply && !hasOutput)
+                continue;
+            const bool isRead = !client.isAwaitingReply && !IsOutputFull(client);
+            pollDescriptors.push_back({ client.socket, static_cast<short>((isRead ? POLLIN : 0) | (hasOutput ? POLLOUT : 0)), 0 });
+        }
+
+        // Commands left waiting for a full queue that has since been written out are handled straight away.
+        if (poll(pollDescriptors.data(), pollDescriptors.size(), isInputPending ? 0 : -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (pollDescriptors[0].revents & POLLIN) {
+            std::uint64_t count = 0;
+            if (read(m_wakeEvent, &count, sizeof(count)) != sizeof(count)) {
+                // Another wake already emptied the counter.
+            }
+        }
+
+        if (pollDescriptors[1].revents & POLLIN) {
+            for (int clientSocket; (clientSocket = accept4(m_listenSocket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0;) {
+                m_clients.push_back(Client { m_nextClientId++, clientSocket, {}, false, false, {}, 0, false, 0, 0, 0, 0, PackedCells(), 0 });
+            }
+        }
+
+        std::vector<std::pair<std::uint64_t, std::string>> replies;
+        {
+            std::lock_guard<std::mutex> lock(m_replyMutex);
+            replies.swap(m_replies);
+        }
+        for (const auto& reply : replies) {
+            const auto client = std::find_if(m_clients.begin(), m_clients.end(), [&](const Client& other) { return other.id == reply.first; });
+            if (client == m_clients.end())
+                continue;
+
+            AppendReply(*client, reply.second);
+            client->isAwaitingReply = false;
+
+            const std::shared_ptr<const PublishedGeneration> latestGeneration = GetLatestGeneration();
+            if (client->isKeyframeRequested && reply.second == "OK" && latestGeneration) {
+                // Unsubscribed clients are sent the whole universe.
+                if (!client->isSubscribed) {
+                    client->viewportX = 0;
+                    client->viewportY = 0;
+                    client->viewportWidth = latestGeneration->cells.GetWidth();
+                    client->viewportHeight = latestGeneration->cells.GetHeight();
+                }
+                AppendFrame(*client, *latestGeneration, true);
+            }
+            client->isKeyframeRequested = false;
+        }
+
+        const std::shared_ptr<const PublishedGeneration> latestGeneration = GetLatestGeneration();
+        isInputPending = false;
+        std::size_t descriptorIndex = 2;
+        for (auto client = m_clients.begin(); client != m_clients.end();) {
+            // Clients accepted during this iteration and clients awaiting a reply without output weren't polled.
+            const short events = (descriptorIndex < pollDescriptors.size() && pollDescriptors[descriptorIndex].fd == client->socket)
+                ? pollDescriptors[descriptorIndex++].revents
+                : 0;
+            bool isConnected = !(events & (POLLERR | POLLNVAL));
+
+            if (isConnected && !client->isAwaitingReply && !IsOutputFull(*client) && (events & (POLLIN | POLLHUP))) {
+                char buffer[4096];
+                const ssize_t bytesRead = read(client->socket, buffer, sizeof(buffer));
+                if (bytesRead > 0)
+                    client->input.append(buffer, static_cast<std::size_t>(bytesRead));
+                else if (bytesRead == 0 || (errno != EAGAIN && errno != EINTR))
+                    isConnected = false;
+            }
+
+            // Also picks up the commands left waiting for a reply that has just arrived.
+            if (isConnected)
+                isConnected = HandleInput(*client);
+
+            // Frames are only built for clients with room in their queue, the rest catch up once they've read what they have.
+            if (isConnected && client->isSubscribed && !IsOutputFull(*client) && latestGeneration && client->sentVersion != latestGeneration->version)
+                AppendFrame(*client, *latestGeneration, false);
+
+            if (isConnected && client->outputOffset < client->output.size())
+                isConnected = WriteOutput(*client);
+
+            if (isConnected && !client->isAwaitingReply && !IsOutputFull(*client) && client->input.find('\n') != std::string::npos)
+                isInputPending = true;
+
+            if (!isConnected) {
+                if (client->isSubscribed)
+                    --m_numberOfSubscribers;
+                close(client->socket);
+                client = m_clients.erase(client);
+            } else {
+                ++client;
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_commandMutex);
+        m_isSteppingStopped = true;
+    }
+    m_commandCondition.notify_one();
+    stepping.get();
+
+    for (const auto& client : m_clients) {
+        close(client.socket);
+    }
+    m_clients.clear();
+    m_numberOfSubscribers = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_generationMutex);
+        m_latestGeneration.reset();
+    }
+    m_publishedGeneration.reset();
+    m_spareGeneration.reset();
+    UpdateMemoryUsage();
+
+    close(m_listenSocket);
+    m_listenSocket = -1;
+    unlink(socketPath.c_str());
+    m_isStopping = false;
+    return true;
+}
+
+bool SimulationService::HandleInput(Client& client)
+{
+    for (std::size_t lineEnd; !client.isAwaitingReply && !IsOutputFull(client) && (lineEnd = client.input.find('\n')) != std::string::npos;) {
+        const std::string line = client.input.substr(0, lineEnd);
+        client.input.erase(0, lineEnd + 1);
+        if (!HandleCommand(client, line))
+            return false;
+    }
+
+    // Nobody sends a command this long, so the client is misbehaving. Input stops being read while a reply is awaited
+    // or the queue is full.
+    return client.isAwaitingReply || IsOutputFull(client) || client.input.size() <= 4096;
+}
+
+bool SimulationService::HandleCommand(Client& client, const std::string& line)
+{
+    std::istringstream arguments(line);
+    std::string command;
+    arguments >> command;
+
+    if (command == "SIZE") {
+        int width = 0;
+        int height = 0;
+        if (!(arguments >> width >> height) || width <= 0 || height <= 0 || width > 65536 || height > 65536) {
+            AppendReply(client, "ERROR expected SIZE <width> <height>, each from 1 to 65536");
+            return true;
+        }
+
+        // The memory budget may refuse the new size, which only the stepping thread finds out.
+        client.isAwaitingReply = true;
+        QueueCommand([this, clientId = client.id, width, height] {
+            QueueReply(clientId, m_gameOfLife.SetGameDimensions(width, height) ? "OK" : "ERROR the universe doesn't fit in the memory budget");
+        });
+        return true;
+    } else if (command == "LOAD") {
+        std::string patternName;
+        arguments >> patternName;
+
+        if (patternName == "empty") {
+            QueueCommand([this] { m_gameOfLife.GenerateEmptyCells(); });
+        } else if (patternName == "random") {
+            QueueCommand([this] { m_gameOfLife.GenerateRandomCells(); });
+        } else if (patternName == "r-pentomino") {
+            QueueCommand([this] { m_gameOfLife.GeneratePattern(Pattern::R_Pentomino); });
+        } else if (patternName == "glider-gun") {
+            QueueCommand([this] { m_gameOfLife.GeneratePattern(Pattern::Glider_Gun); });
+        } else if (patternName == "infinite-growth") {
+            QueueCommand([this] { m_gameOfLife.GeneratePattern(Pattern::Infinite_Growth); });
+        } else {
+            AppendReply(client, "ERROR expected LOAD <empty|random|r-pentomino|glider-gun|infinite-growth>");
+            return true;
+        }
+    } else if (command == "RULE") {
+        std::string ruleString;
+        LifeRule rule {};
+        if (!(arguments >> ruleString) || !LifeRule::Parse(ruleString, rule)) {
+            AppendReply(client, "ERROR expected RULE <B3/S23>");
+            return true;
+        }
+
+        QueueCommand([this, rule] { m_gameOfLife.SetRule(rule); });
+    } else if (command == "PAINT") {
+        int x = 0;
+        int y = 0;
+        int length = 0;
+        int state = 0;
+        if (!(arguments >> x >> y >> length >> state) || length <= 0 || (state != 0 && state != 1)) {
+            AppendReply(client, "ERROR expected PAINT <x> <y> <length> <0|1>");
+            return true;
+        }
+
+        // Only this thread pushes edits, straight onto the stepping thread's edit queue, which is applied before every generation.
+        // A command is only queued to apply them while paused, and only when there isn't one queued already. It clears the flag
+        // before applying, so anything pushed after it has been cleared is applied by the next command.
+        const CellEdit edit { x, y, length, state == 1 ? CellState::active : CellState::inactive };
+        if (m_gameOfLife.GetEditQueue().Push(&edit, 1) == 0) {
+            AppendReply(client, "ERROR too many edits queued");
+            return true;
+        }
+
+        if (!m_isApplyingEditsQueued.exchange(true)) {
+            QueueCommand([this] {
+                m_isApplyingEditsQueued.store(false);
+                m_gameOfLife.ApplyQueuedEdits();
+            });
+        }
+    } else if (command == "STEP") {
+        long long generations = 0;
+        if (!(arguments >> generations) || generations <= 0) {
+            AppendReply(client, "ERROR expected STEP <generations>");
+            return true;
+        }
+
+        QueueCommand([this, generations] { m_pendingGenerations += static_cast<std::uint64_t>(generations); });
+    } else if (command == "RUN") {
+        QueueCommand([this] { m_isRunning = true; });
+    } else if (command == "PAUSE") {
+        QueueCommand([this] {
+            m_isRunning = false;
+            m_pendingGenerations = 0;
+        });
+    } else if (command == "SUBSCRIBE") {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+        if (!(arguments >> x >> y >> width >> height) || width <= 0 || height <= 0 || width > 65536 || height > 65536) {
+            AppendReply(client, "ERROR expected SUBSCRIBE <x> <y> <width> <height>, width and height from 1 to 65536");
+            return true;
+        }
+
+        if (!client.isSubscribed)
+            ++m_numberOfSubscribers;
+        client.isSubscribed = true;
+        client.viewportX = x;
+        client.viewportY = y;
+        client.viewportWidth = width;
+        client.viewportHeight = height;
+        RequestKeyframe(client);
+        return true;
+    } else if (command == "SNAPSHOT") {
+        RequestKeyframe(client);
+        return true;
+    } else if (command == "QUIT") {
+        return false;
+    } else if (!command.empty()) {
+        AppendReply(client, "ERROR unknown command " + command);
+        return true;
+    } else {
+        return true;
+    }
+
+    AppendReply(client, "OK");
+    return true;
+}
+
+void SimulationService::RequestKeyframe(Client& client)
+{
+    // Keyframes can be as large as the universe, so a client can only have one on its way at a time.
+    client.isAwaitingReply = true;
+    client.isKeyframeRequested = true;
+    QueueCommand([this, clientId = client.id] {
+        QueueReply(clientId, PublishGeneration() ? "OK" : "ERROR the generation doesn't fit in the memory budget");
+    });
+}
+
+bool SimulationService::IsOutputFull(const Client& client)
+{
+    return client.output.size() - client.outputOffset >= maximumQueuedBytes;
+}
+
+void SimulationService::AppendReply(Client& client, const std::string& reply)
+{
+    AppendValue(client.output, static_cast<std::uint32_t>(MessageType::reply));
+    AppendValue(client.output, static_cast<std::uint32_t>(reply.size()));
+    client.output.insert(client.output.end(), reply.begin(), reply.end());
+}
+
+void SimulationService::AppendFrame(Client& client, const PublishedGeneration& generation, bool isKeyframe)
+{
+    PackedCells viewport(client.viewportWidth, client.viewportHeight);
+    CopyViewport(generation.cells, client.viewportX, client.viewportY, viewport);
+
+    if (isKeyframe || client.sentCells.GetWidth() != viewport.GetWidth() || client.sentCells.GetHeight() != viewport.GetHeight()) {
+        client.sentCells = PackedCells(viewport.GetWidth(), viewport.GetHeight());
+        isKeyframe = true;
+    }
+
+    std::vector<std::uint8_t> payload;
+    AppendValue(payload, generation.generation);
+    AppendValue(payload, static_cast<std::uint32_t>(isKeyframe));
+    AppendValue(payload, static_cast<std::int32_t>(client.viewportX));
+    AppendValue(payload, static_cast<std::int32_t>(client.viewportY));
+    AppendValue(payload, static_cast<std::int32_t>(client.viewportWidth));
+    AppendValue(payload, static_cast<std::int32_t>(client.viewportHeight));
+    const std::size_t numberOfTilesOffset = payload.size();
+    AppendValue(payload, std::uint32_t(0));
+
+    // Against a keyframe's empty sent cells, the xor is the tile itself.
+    std::uint32_t numberOfTiles = 0;
+    std::uint64_t tile[64];
+    for (int tileRow = 0; tileRow * 64 < viewport.GetHeight(); ++tileRow) {
+        const int tileHeight = std::min(64, viewport.GetHeight() - tileRow * 64);
+        for (int tileColumn = 0; tileColumn < viewport.GetWordsPerRow(); ++tileColumn) {
+            std::uint64_t changedCells = 0;
+            for (int row = 0; row < tileHeight; ++row) {
+                tile[row] = viewport.GetRow(tileRow * 64 + row)[tileColumn] ^ client.sentCells.GetRow(tileRow * 64 + row)[tileColumn];
+                changedCells |= tile[row];
+            }
+
+            if (changedCells == 0)
+                continue;
+
+            const std::vector<std::uint64_t> compressedTile = CompressWords(tile, static_cast<std::size_t>(tileHeight));
+            AppendValue(payload, static_cast<std::uint32_t>(tileColumn));
+            AppendValue(payload, static_cast<std::uint32_t>(tileRow));
+            AppendValue(payload, static_cast<std::uint32_t>(compressedTile.size()));
+            const auto* compressedBytes = reinterpret_cast<const std::uint8_t*>(compressedTile.data());
+            payload.insert(payload.end(), compressedBytes, compressedBytes + compressedTile.size() * sizeof(std::uint64_t));
+            ++numberOfTiles;
+        }
+    }
+
+    std::memcpy(payload.data() + numberOfTilesOffset, &numberOfTiles, sizeof(numberOfTiles));
+
+    AppendValue(client.output, static_cast<std::uint32_t>(MessageType::frame));
+    AppendValue(client.output, static_cast<std::uint32_t>(payload.size()));
+    client.output.insert(client.output.end(), payload.begin(), payload.end());
+
+    client.sentCells = std::move(viewport);
+    client.sentVersion = generation.version;
+}
+
+bool SimulationService::WriteOutput(Client& client)
+{
+    while (client.outputOffset < client.output.size()) {
+        const ssize_t bytesWritten = send(client.socket, client.output.data() + client.outputOffset, client.output.size() - client.outputOffset, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (bytesWritten < 0) {
+            // What has been sent is dropped once it's most of the queue, so a client that never quite catches up can't grow it forever.
+            if (client.outputOffset > client.output.size() / 2) {
+                client.output.erase(client.output.begin(), client.output.begin() + static_cast<std::ptrdiff_t>(client.outputOffset));
+                client.outputOffset = 0;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+
+        client.outputOffset += static_cast<std::size_t>(bytesWritten);
+    }
+
+    client.output.clear();
+    client.outputOffset = 0;
+    return true;
+}
+
+#else
+
+// Unix domain sockets and eventfd are Linux only here, so other platforms can't serve a universe.
+SimulationService::SimulationService()
+    : m_gameOfLife()
+    , m_pendingGenerations(0)
+    , m_isRunning(false)
+    , m_commandMutex()
+    , m_commandCondition()
+    , m_commands()
+    , m_isSteppingStopped(false)
+    , m_isApplyingEditsQueued(false)
+    , m_generationMutex()
+    , m_latestGeneration()
+    , m_publishedGeneration()
+    , m_spareGeneration()
+    , m_numberOfSubscribers(0)
+    , m_memoryAccount("Served generations")
+    , m_replyMutex()
+    , m_replies()
+    , m_clients()
+    , m_nextClientId(0)
+    , m_listenSocket(-1)
+    , m_wakeEvent(-1)
+    , m_isStopping(false) {}
+
+SimulationService::~SimulationService() { }
+
+bool SimulationService::IsSupported()
+{
+    return false;
+}
+
+bool SimulationService::Run(const std::string&)
+{
+    return false;
+}
+
+void SimulationService::Stop() { }
+
+void SimulationService::RunStepping() { }
+
+bool SimulationService::PublishGeneration()
+{
+    return false;
+}
+
+void SimulationService::UpdateMemoryUsage() { }
+
+std::shared_ptr<const SimulationService::PublishedGeneration> SimulationService::GetLatestGeneration()
+{
+    return nullptr;
+}
+
+void SimulationService::QueueCommand(std::function<void()>) { }
+
+void SimulationService::QueueReply(std::uint64_t, std::string) { }
+
+bool SimulationService::HandleInput(Client&)
+{
+    return false;
+}
+
+bool SimulationService::HandleCommand(Client&, const std::string&)
+{
+    return false;
+}
+
+void SimulationService::RequestKeyframe(Client&) { }
+
+bool SimulationService::IsOutputFull(const Client&)
+{
+    return false;
+}
+
+void SimulationService::AppendReply(Client&, const std::string&) { }
+
+void SimulationService::AppendFrame(Client&, const PublishedGeneration&, bool) { }
+
+bool SimulationService::WriteOutput(Client&)
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,453 @@
+#include "SlabWorkers.h"
+
+#include <algorithm>
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "LifeKernel.h"
+
+namespace {
+// Lives in the first page of the shared memory, ahead of the two cell buffers.
+struct SharedHeader {
+    // Index of the buffer holding the current generation, workers write the next generation into the other one.
+    std::atomic<std::uint32_t> currentBuffer;
+    // Birth counts in the low 16 bits and survival counts in the high 16 bits, see LifeRule.
+    std::atomic<std::uint32_t> rule;
+};
+
+struct WorkerSetup {
+    int sharedMemory;
+    std::size_t headerSize;
+    std::size_t bufferSize;
+    int wordsPerRow;
+    int height;
+    std::uint64_t lastWordMask;
+};
+
+// Runs in the forked worker, which only makes system calls and steps its own rows, so nothing here allocates.
+[[noreturn]] void RunWorker(const WorkerSetup& setup, int firstRow, int lastRow, int startEvent, int doneEvent, const std::vector<int>& cpus, pid_t ownerProcessId)
+{
+    // Workers never outlive the process that owns the universe.
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    if (getppid() != ownerProcessId)
+        _exit(1);
+
+    if (!cpus.empty()) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (const int cpu : cpus) {
+            CPU_SET(cpu, &cpuSet);
+        }
+        sched_setaffinity(0, sizeof(cpuSet), &cpuSet);
+    }
+
+    void* shared = mmap(nullptr, setup.headerSize + 2 * setup.bufferSize, PROT_READ | PROT_WRITE, MAP_SHARED, setup.sharedMemory, 0);
+    if (shared == MAP_FAILED)
+        _exit(1);
+
+    const auto* header = static_cast<const SharedHeader*>(shared);
+    auto* buffers = reinterpret_cast<std::uint64_t*>(static_cast<char*>(shared) + setup.headerSize);
+    const std::size_t wordsPerBuffer = setup.bufferSize / sizeof(std::uint64_t);
+
+    for (;;) {
+        std::uint64_t count = 0;
+        if (read(startEvent, &count, sizeof(count)) != sizeof(count)) {
+            if (errno == EINTR)
+                continue;
+            _exit(1);
+        }
+
+        const std::uint32_t current = header->currentBuffer.load();
+        const std::uint32_t rule = header->rule.load();
+        StepLifeRows(buffers + current * wordsPerBuffer, buffers + (current ^ 1) * wordsPerBuffer, setup.wordsPerRow, setup.height, setup.lastWordMask, firstRow, lastRow,
+            LifeRule { static_cast<std::uint16_t>(rule & 0xFFFF), static_cast<std::uint16_t>(rule >> 16) });
+
+        const std::uint64_t done = 1;
+        if (write(doneEvent, &done, sizeof(done)) != sizeof(done))
+            _exit(1);
+    }
+}
+
+std::size_t RoundUpToPage(std::size_t size)
+{
+    const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return ((size + pageSize - 1) / pageSize) * pageSize;
+}
+}
+
+SlabWorkers::SlabWorkers()
+    : m_width(0)
+    , m_height(0)
+    , m_wordsPerRow(0)
+    , m_numberOfRestarts(0)
+    , m_sharedMemory(-1)
+    , m_headerSize(0)
+    , m_bufferSize(0)
+    , m_header(nullptr)
+    , m_readOnlyCells(nullptr)
+    , m_workers() {}
+
+SlabWorkers::~SlabWorkers()
+{
+    Stop();
+}
+
+bool SlabWorkers::IsSupported()
+{
+    return true;
+}
+
+bool SlabWorkers::Start(int width, int height, int numberOfWorkers, bool isPinnedToCpus)
+{
+    Stop();
+
+    if (width <= 0 || height <= 0 || numberOfWorkers <= 0)
+        return false;
+
+    m_width = width;
+    m_height = height;
+    m_wordsPerRow = (width + 63) / 64;
+    m_numberOfRestarts = 0;
+    // Buffers are page aligned so that each one can be mapped on its own.
+    m_headerSize = RoundUpToPage(sizeof(SharedHeader));
+    m_bufferSize = RoundUpToPage(static_cast<std::size_t>(m_wordsPerRow) * height * sizeof(std::uint64_t));
+
+    // The name is unlinked straight away, so the universe only lives as long as its descriptors and mappings.
+    static std::atomic<int> universeCounter { 0 };
+    const std::string name = "/cellular-automata-" + std::to_string(getpid()) + "-" + std::to_string(universeCounter++);
+    m_sharedMemory = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (m_sharedMemory < 0)
+        return false;
+    shm_unlink(name.c_str());
+
+    if (ftruncate(m_sharedMemory, static_cast<off_t>(m_headerSize + 2 * m_bufferSize)) != 0) {
+        Stop();
+        return false;
+    }
+
+    void* header = mmap(nullptr, m_headerSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_sharedMemory, 0);
+    void* readOnlyCells = mmap(nullptr, 2 * m_bufferSize, PROT_READ, MAP_SHARED, m_sharedMemory, static_cast<off_t>(m_headerSize));
+    m_header = (header == MAP_FAILED) ? nullptr : header;
+    m_readOnlyCells = (readOnlyCells == MAP_FAILED) ? nullptr : readOnlyCells;
+    if (m_header == nullptr || m_readOnlyCells == nullptr) {
+        Stop();
+        return false;
+    }
+
+    new (m_header) SharedHeader();
+    static_cast<SharedHeader*>(m_header)->currentBuffer = 0;
+    SetRule(LifeRule::Conway());
+
+    // Neighbouring CPU numbers usually share a NUMA node, so each worker gets a contiguous block of them.
+    std::vector<int> availableCpus;
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (isPinnedToCpus && sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &cpuSet))
+                availableCpus.push_back(cpu);
+        }
+    }
+
+    numberOfWorkers = std::min(numberOfWorkers, height);
+    for (int index = 0; index < numberOfWorkers; ++index) {
+        Worker worker { -1, -1, -1, (index * height) / numberOfWorkers, ((index + 1) * height) / numberOfWorkers, {} };
+        worker.startEvent = eventfd(0, EFD_CLOEXEC);
+        worker.doneEvent = eventfd(0, EFD_CLOEXEC);
+
+        const std::size_t numberOfCpus = availableCpus.size();
+        if (numberOfCpus > 0) {
+            const std::size_t firstCpu = (index * numberOfCpus) / numberOfWorkers;
+            const std::size_t lastCpu = std::max(firstCpu + 1, ((index + 1) * numberOfCpus) / numberOfWorkers);
+            worker.cpus.assign(availableCpus.begin() + firstCpu, availableCpus.begin() + std::min(lastCpu, numberOfCpus));
+        }
+
+        m_workers.push_back(worker);
+        if (worker.startEvent < 0 || worker.doneEvent < 0 || !StartWorker(m_workers.back())) {
+            Stop();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SlabWorkers::Stop()
+{
+    KillWorkers();
+    for (auto& worker : m_workers) {
+        if (worker.startEvent >= 0)
+            close(worker.startEvent);
+        if (worker.doneEvent >= 0)
+            close(worker.doneEvent);
+    }
+    m_workers.clear();
+
+    if (m_header != nullptr)
+        munmap(m_header, m_headerSize);
+    if (m_readOnlyCells != nullptr)
+        munmap(const_cast<void*>(m_readOnlyCells), 2 * m_bufferSize);
+    if (m_sharedMemory >= 0)
+        close(m_sharedMemory);
+
+    m_header = nullptr;
+    m_readOnlyCells = nullptr;
+    m_sharedMemory = -1;
+}
+
+void SlabWorkers::KillWorkers()
+{
+    for (auto& worker : m_workers) {
+        if (worker.processId > 0) {
+            kill(worker.processId, SIGKILL);
+            waitpid(worker.processId, nullptr, 0);
+        }
+        worker.processId = -1;
+    }
+}
+
+bool SlabWorkers::StartWorker(Worker& worker)
+{
+    const WorkerSetup setup { m_sharedMemory, m_headerSize, m_bufferSize, m_wordsPerRow, m_height, PackedCells(m_width, 1).GetLastWordMask() };
+    const pid_t ownerProcessId = getpid();
+
+    const pid_t processId = fork();
+    if (processId < 0)
+        return false;
+    if (processId == 0)
+        RunWorker(setup, worker.firstRow, worker.lastRow, worker.startEvent, worker.doneEvent, worker.cpus, ownerProcessId);
+
+    worker.processId = processId;
+    return true;
+}
+
+bool SlabWorkers::IsRunning() const
+{
+    return !m_workers.empty();
+}
+
+int SlabWorkers::GetNumberOfWorkers() const
+{
+    return static_cast<int>(m_workers.size());
+}
+
+int SlabWorkers::GetNumberOfRestarts() const
+{
+    return m_numberOfRestarts;
+}
+
+int SlabWorkers::GetWordsPerRow() const
+{
+    return m_wordsPerRow;
+}
+
+const std::uint64_t* SlabWorkers::GetCurrentCells() const
+{
+    if (!IsRunning())
+        return nullptr;
+
+    const std::uint32_t current = static_cast<const SharedHeader*>(m_header)->currentBuffer.load();
+    return reinterpret_cast<const std::uint64_t*>(static_cast<const char*>(m_readOnlyCells) + current * m_bufferSize);
+}
+
+void SlabWorkers::UploadCells(const PackedCells& cells)
+{
+    if (!IsRunning() || cells.GetWidth() != m_width || cells.GetHeight() != m_height)
+        return;
+
+    // Writable only for the copy, the rest of the time this process can't touch the workers' slabs.
+    const std::uint32_t current = static_cast<const SharedHeader*>(m_header)->currentBuffer.load();
+    void* writableCells = mmap(nullptr, m_bufferSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_sharedMemory, static_cast<off_t>(m_headerSize + current * m_bufferSize));
+    if (writableCells == MAP_FAILED)
+        return;
+
+    std::memcpy(writableCells, cells.GetWords().data(), cells.GetWords().size() * sizeof(std::uint64_t));
+    munmap(writableCells, m_bufferSize);
+}
+
+void SlabWorkers::DownloadCells(PackedCells& cells) const
+{
+    if (!IsRunning())
+        return;
+
+    cells = PackedCells(m_width, m_height);
+    const std::uint64_t* currentCells = GetCurrentCells();
+    std::copy(currentCells, currentCells + cells.GetWords().size(), cells.GetWords().begin());
+}
+
+void SlabWorkers::UploadRows(const PackedCells& cells, int firstRow, int lastRow)
+{
+    if (!IsRunning() || cells.GetWidth() != m_width || cells.GetHeight() != m_height || firstRow < 0 || lastRow > m_height || firstRow >= lastRow)
+        return;
+
+    const std::uint32_t current = static_cast<const SharedHeader*>(m_header)->currentBuffer.load();
+    void* writableCells = mmap(nullptr, m_bufferSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_sharedMemory, static_cast<off_t>(m_headerSize + current * m_bufferSize));
+    if (writableCells == MAP_FAILED)
+        return;
+
+    const std::size_t firstWord = static_cast<std::size_t>(firstRow) * m_wordsPerRow;
+    const std::size_t numberOfWords = static_cast<std::size_t>(lastRow - firstRow) * m_wordsPerRow;
+    std::memcpy(static_cast<std::uint64_t*>(writableCells) + firstWord, cells.GetWords().data() + firstWord, numberOfWords * sizeof(std::uint64_t));
+    munmap(writableCells, m_bufferSize);
+}
+
+void SlabWorkers::DownloadRows(PackedCells& cells, int firstRow, int lastRow) const
+{
+    if (!IsRunning() || cells.GetWidth() != m_width || cells.GetHeight() != m_height || firstRow < 0 || lastRow > m_height || firstRow >= lastRow)
+        return;
+
+    const std::uint64_t* currentCells = GetCurrentCells();
+    const std::size_t firstWord = static_cast<std::size_t>(firstRow) * m_wordsPerRow;
+    const std::size_t lastWord = static_cast<std::size_t>(lastRow) * m_wordsPerRow;
+    std::copy(currentCells + firstWord, currentCells + lastWord, cells.GetWords().begin() + static_cast<std::ptrdiff_t>(firstWord));
+}
+
+void SlabWorkers::SetRule(const LifeRule& rule)
+{
+    // Workers read the rule when they're started on a step.
+    if (m_header != nullptr)
+        static_cast<SharedHeader*>(m_header)->rule = static_cast<std::uint32_t>(rule.birth) | (static_cast<std::uint32_t>(rule.survival) << 16);
+}
+
+bool SlabWorkers::Step()
+{
+    // Workers are only ever missing after a step failed.
+    if (!IsRunning() || std::any_of(m_workers.begin(), m_workers.end(), [](const Worker& worker) { return worker.processId <= 0; }))
+        return false;
+
+    // The workers may be part way through a step that's given up on, so they're all killed rather than left to get out of step.
+    const auto fail = [this]() {
+        KillWorkers();
+        return false;
+    };
+
+    const std::uint64_t start = 1;
+    for (const auto& worker : m_workers) {
+        if (write(worker.startEvent, &start, sizeof(start)) != sizeof(start))
+            return fail();
+    }
+
+    for (auto& worker : m_workers) {
+        for (;;) {
+            pollfd doneEvent { worker.doneEvent, POLLIN, 0 };
+            if (poll(&doneEvent, 1, 100) > 0) {
+                std::uint64_t count = 0;
+                if (read(worker.doneEvent, &count, sizeof(count)) == sizeof(count))
+                    break;
+            }
+
+            // No answer yet, so make sure the worker is still alive. Only its own process is ever waited for,
+            // so the deaths of the other workers are left for their own turn.
+            const pid_t waitedProcessId = waitpid(worker.processId, nullptr, WNOHANG);
+            if (waitedProcessId < 0)
+                return fail();
+            if (waitedProcessId == worker.processId) {
+                worker.processId = -1;
+                if (!StartWorker(worker))
+                    return fail();
+
+                ++m_numberOfRestarts;
+                if (write(worker.startEvent, &start, sizeof(start)) != sizeof(start))
+                    return fail();
+            }
+        }
+    }
+
+    auto* header = static_cast<SharedHeader*>(m_header);
+    header->currentBuffer = header->currentBuffer.load() ^ 1;
+    return true;
+}
+
+#else
+
+// Shared memory workers rely on eventfd and fork, so other platforms always step in a single process.
+SlabWorkers::SlabWorkers()
+    : m_width(0)
+    , m_height(0)
+    , m_wordsPerRow(0)
+    , m_numberOfRestarts(0)
+    , m_sharedMemory(-1)
+    , m_headerSize(0)
+    , m_bufferSize(0)
+    , m_header(nullptr)
+    , m_readOnlyCells(nullptr)
+    , m_workers() {}
+
+SlabWorkers::~SlabWorkers() = default;
+
+bool SlabWorkers::IsSupported()
+{
+    return false;
+}
+
+bool SlabWorkers::Start(int, int, int, bool)
+{
+    return false;
+}
+
+void SlabWorkers::Stop() { }
+
+void SlabWorkers::KillWorkers() { }
+
+bool SlabWorkers::StartWorker(Worker&)
+{
+    return false;
+}
+
+bool SlabWorkers::IsRunning() const
+{
+    return false;
+}
+
+int SlabWorkers::GetNumberOfWorkers() const
+{
+    return 0;
+}
+
+int SlabWorkers::GetNumberOfRestarts() const
+{
+    return 0;
+}
+
+int SlabWorkers::GetWordsPerRow() const
+{
+    return 0;
+}
+
+const std::uint64_t* SlabWorkers::GetCurrentCells() const
+{
+    return nullptr;
+}
+
+void SlabWorkers::UploadCells(const PackedCells&) { }
+
+void SlabWorkers::DownloadCells(PackedCells&) const { }
+
+void SlabWorkers::UploadRows(const PackedCells&, int, int) { }
+
+void SlabWorkers::DownloadRows(PackedCells&, int, int) const { }
+
+void SlabWorkers::SetRule(const LifeRule&) { }
+
+bool SlabWorkers::Step()
+{
+    return false;
+}
+
+#endif
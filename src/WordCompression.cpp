@@ -0,0 +1,135 @@
+#include "WordCompression.h"
+#include "PackedCells.h"
+
+#include <algorithm>
+
+namespace {
+template <typename WordAt>
+std::vector<std::uint64_t> CompressWordsFrom(WordAt wordAt, std::size_t numberOfWords)
+{
+    std::vector<std::uint64_t> compressedWords;
+    for (std::size_t index = 0; index < numberOfWords;) {
+        const std::uint64_t word = wordAt(index);
+        if (word != 0) {
+            compressedWords.push_back(word);
+            ++index;
+            continue;
+        }
+
+        std::size_t runEnd = index;
+        while (runEnd < numberOfWords && wordAt(runEnd) == 0) {
+            ++runEnd;
+        }
+
+        compressedWords.push_back(0);
+        compressedWords.push_back(runEnd - index);
+        index = runEnd;
+    }
+
+    compressedWords.shrink_to_fit();
+    return compressedWords;
+}
+}
+
+std::vector<std::uint64_t> CompressWords(const std::uint64_t* words, std::size_t numberOfWords)
+{
+    return CompressWordsFrom([words](std::size_t index) { return words[index]; }, numberOfWords);
+}
+
+std::vector<std::uint64_t> DecompressWords(const std::vector<std::uint64_t>& compressedWords)
+{
+    std::vector<std::uint64_t> words;
+    for (std::size_t index = 0; index < compressedWords.size(); ++index) {
+        if (compressedWords[index] != 0) {
+            words.push_back(compressedWords[index]);
+        } else {
+            ++index;
+            words.insert(words.end(), compressedWords[index], 0);
+        }
+    }
+
+    return words;
+}
+
+bool DecompressWords(const std::uint64_t* compressedWords, std::size_t numberOfCompressedWords, std::uint64_t* words, std::size_t numberOfWords)
+{
+    std::size_t wordIndex = 0;
+    for (std::size_t index = 0; index < numberOfCompressedWords; ++index) {
+        if (compressedWords[index] != 0) {
+            if (wordIndex == numberOfWords)
+                return false;
+            words[wordIndex++] = compressedWords[index];
+        } else {
+            // A run needs its length, and has to fit in what's left.
+            if (++index == numberOfCompressedWords || compressedWords[index] > numberOfWords - wordIndex)
+                return false;
+            std::fill_n(words + wordIndex, compressedWords[index], std::uint64_t(0));
+            wordIndex += compressedWords[index];
+        }
+    }
+
+    return wordIndex == numberOfWords;
+}
+
+std::vector<std::uint64_t> CompressXorWords(const std::uint64_t* words, const std::uint64_t* otherWords, std::size_t numberOfWords)
+{
+    return CompressWordsFrom([words, otherWords](std::size_t index) { return words[index] ^ otherWords[index]; }, numberOfWords);
+}
+
+void XorDecompressedWords(const std::vector<std::uint64_t>& compressedWords, std::uint64_t* words)
+{
+    std::size_t wordIndex = 0;
+    for (std::size_t index = 0; index < compressedWords.size(); ++index) {
+        if (compressedWords[index] != 0) {
+            words[wordIndex++] ^= compressedWords[index];
+        } else {
+            ++index;
+            wordIndex += compressedWords[index];
+        }
+    }
+}
+
+bool CompressXorBits(const std::uint64_t* words, const std::uint64_t* otherWords, std::size_t numberOfWords, std::size_t maximumSize, std::vector<std::uint8_t>& compressedBits)
+{
+    compressedBits.clear();
+    std::uint64_t nextPosition = 0;
+
+    for (std::size_t index = 0; index < numberOfWords; ++index) {
+        for (std::uint64_t word = words[index] ^ otherWords[index]; word != 0; word &= word - 1) {
+            const std::uint64_t position = index * 64 + CountTrailingZeros(word);
+            std::uint64_t gap = position - nextPosition;
+            nextPosition = position + 1;
+
+            while (gap >= 0x80) {
+                compressedBits.push_back(static_cast<std::uint8_t>(gap | 0x80));
+                gap >>= 7;
+            }
+            compressedBits.push_back(static_cast<std::uint8_t>(gap));
+
+            if (compressedBits.size() > maximumSize)
+                return false;
+        }
+    }
+
+    compressedBits.shrink_to_fit();
+    return true;
+}
+
+void XorDecompressedBits(const std::vector<std::uint8_t>& compressedBits, std::uint64_t* words)
+{
+    std::uint64_t nextPosition = 0;
+
+    for (std::size_t index = 0; index < compressedBits.size();) {
+        std::uint64_t gap = 0;
+        for (int shift = 0;; shift += 7) {
+            const std::uint8_t byte = compressedBits[index++];
+            gap |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                break;
+        }
+
+        const std::uint64_t position = nextPosition + gap;
+        words[position / 64] ^= std::uint64_t(1) << (position % 64);
+        nextPosition = position + 1;
+    }
+}
@@ -0,0 +1,84 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool(int numberOfThreads)
+    : m_numberOfThreads((numberOfThreads > 0) ? numberOfThreads : std::max(1, static_cast<int>(std::thread::hardware_concurrency())))
+    , m_workers()
+    , m_task(nullptr)
+    , m_numberOfChunks(0)
+    , m_remainingChunks(0)
+    , m_round(0)
+    , m_isStopping(false)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_roundStarted.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+int WorkerPool::GetNumberOfThreads() const
+{
+    return m_numberOfThreads;
+}
+
+void WorkerPool::RunChunks(int numberOfChunks, const std::function<void(int)>& task)
+{
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+
+    numberOfChunks = std::min(numberOfChunks, m_numberOfThreads);
+    if (numberOfChunks <= 1) {
+        task(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Chunk 0 is the calling thread's.
+        for (int chunk = static_cast<int>(m_workers.size()) + 1; chunk < m_numberOfThreads; ++chunk) {
+            m_workers.emplace_back(&WorkerPool::RunWorker, this, chunk, m_round);
+        }
+
+        m_task = &task;
+        m_numberOfChunks = numberOfChunks;
+        m_remainingChunks = numberOfChunks - 1;
+        ++m_round;
+    }
+    m_roundStarted.notify_all();
+
+    task(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_roundFinished.wait(lock, [this] { return m_remainingChunks == 0; });
+    m_task = nullptr;
+}
+
+void WorkerPool::RunWorker(int chunk, std::uint64_t round)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_roundStarted.wait(lock, [&] { return m_isStopping || m_round != round; });
+        if (m_isStopping)
+            return;
+
+        round = m_round;
+        if (chunk >= m_numberOfChunks)
+            continue;
+
+        const std::function<void(int)>& task = *m_task;
+        lock.unlock();
+        task(chunk);
+        lock.lock();
+
+        if (--m_remainingChunks == 0)
+            m_roundFinished.notify_one();
+    }
+}
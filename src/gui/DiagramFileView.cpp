@@ -0,0 +1,54 @@
+#include "DiagramFileView.h"
+
+#include <algorithm>
+#include <limits>
+
+DiagramFileView::DiagramFileView(DiagramFile& diagramFile)
+    : m_diagramFile(diagramFile)
+    , m_rowWords()
+    , m_drawnRuleNumber(-1)
+    , m_drawnNumberOfCellsPerGeneration(0)
+    , m_drawnStartingGeneration(0)
+    , m_cellsVersion(0)
+{
+}
+
+void DiagramFileView::DrawCells()
+{
+    if (!m_diagramFile.IsOpen())
+        return;
+
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+
+    draw_list->PushClipRect(m_min_canvas_position, m_max_canvas_position, true);
+
+    // The grid counts rows with an int, so only the first two billion generations can be shown.
+    const std::uint64_t maximumRows = static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+    const int numberOfGenerations = static_cast<int>(std::min(m_diagramFile.GetNumberOfGenerations(), maximumRows));
+    const int numberOfCompletedGenerations = static_cast<int>(std::min(m_diagramFile.GetNumberOfCompletedGenerations(), maximumRows));
+
+    const ImVec2 origin = ImVec2(m_min_canvas_position.x + m_grid_scrolling.x, m_min_canvas_position.y + m_grid_scrolling.y);
+    draw_list->AddRect(origin, ImVec2(origin.x + (static_cast<float>(m_diagramFile.GetNumberOfCellsPerGeneration()) * m_grid_steps), origin.y + (static_cast<float>(numberOfGenerations) * m_grid_steps)), m_cell_colour_main);
+
+    if (m_diagramFile.GetRuleNumber() != m_drawnRuleNumber || m_diagramFile.GetNumberOfCellsPerGeneration() != m_drawnNumberOfCellsPerGeneration
+        || m_diagramFile.GetStartingGeneration() != m_drawnStartingGeneration) {
+        m_drawnRuleNumber = m_diagramFile.GetRuleNumber();
+        m_drawnNumberOfCellsPerGeneration = m_diagramFile.GetNumberOfCellsPerGeneration();
+        m_drawnStartingGeneration = m_diagramFile.GetStartingGeneration();
+        ++m_cellsVersion;
+    }
+
+    DrawPackedRows(
+        [&](int y, int firstWord, int lastWord) -> const std::uint64_t* {
+            m_rowWords.resize(lastWord - firstWord);
+            return m_diagramFile.ReadRow(y, firstWord, lastWord - firstWord, m_rowWords.data()) ? m_rowWords.data() : nullptr;
+        },
+        m_diagramFile.GetWordsPerRow(), numberOfCompletedGenerations, m_cellsVersion);
+
+    draw_list->PopClipRect();
+}
+
+void DiagramFileView::ScrollTo(int position, int generation)
+{
+    m_grid_scrolling = ImVec2(-static_cast<float>(position) * m_grid_steps, -static_cast<float>(generation) * m_grid_steps);
+}
@@ -0,0 +1,22 @@
+#include "ElementaryView.h"
+
+ElementaryView::ElementaryView(const Elementary& elementary)
+    : m_elementary(elementary)
+{
+}
+
+void ElementaryView::DrawCells()
+{
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+
+    draw_list->PushClipRect(m_min_canvas_position, m_max_canvas_position, true);
+
+    const ImVec2 origin = ImVec2(m_min_canvas_position.x + m_grid_scrolling.x, m_min_canvas_position.y + m_grid_scrolling.y);
+    draw_list->AddRect(origin, ImVec2(origin.x + (m_elementary.GetNumberOfCellsPerGeneration() * m_grid_steps), origin.y + (m_elementary.GetNumberOfGenerations() * m_grid_steps)), m_cell_colour_main);
+
+    // A running preview shows the generations it has finished so far.
+    const PackedCells& cells = m_elementary.GetCells();
+    DrawPackedCells(cells.GetWords().data(), cells.GetWordsPerRow(), m_elementary.GetNumberOfComputedGenerations(), m_elementary.GetCellsVersion());
+
+    draw_list->PopClipRect();
+}
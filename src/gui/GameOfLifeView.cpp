@@ -0,0 +1,20 @@
+#include "GameOfLifeView.h"
+
+GameOfLifeView::GameOfLifeView(const GameOfLife& gameOfLife)
+    : m_gameOfLife(gameOfLife)
+{
+}
+
+void GameOfLifeView::DrawCells()
+{
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+
+    const ImVec2 origin = ImVec2(m_min_canvas_position.x + m_grid_scrolling.x, m_min_canvas_position.y + m_grid_scrolling.y);
+
+    draw_list->PushClipRect(m_min_canvas_position, m_max_canvas_position, true);
+    draw_list->AddRect(origin, ImVec2(origin.x + (m_gameOfLife.GetWidth() * m_grid_steps), origin.y + (m_gameOfLife.GetHeight() * m_grid_steps)), IM_COL32(200, 200, 200, 255));
+
+    DrawPackedCells(m_gameOfLife.GetCurrentWords(), m_gameOfLife.GetWordsPerRow(), m_gameOfLife.GetHeight(), m_gameOfLife.GetCellsVersion());
+
+    draw_list->PopClipRect();
+}
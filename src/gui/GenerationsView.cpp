@@ -0,0 +1,49 @@
+#include "GenerationsView.h"
+
+namespace {
+// The decaying states fade down to this fraction of the main cell colour.
+constexpr float lastStateBrightness = 0.2f;
+}
+
+GenerationsView::GenerationsView(const Generations& generations)
+    : m_generations(generations)
+    , m_cellsInState()
+    , m_cellsInStateVersion(~std::uint64_t(0))
+{
+}
+
+void GenerationsView::DrawCells()
+{
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+
+    const ImVec2 origin = ImVec2(m_min_canvas_position.x + m_grid_scrolling.x, m_min_canvas_position.y + m_grid_scrolling.y);
+
+    draw_list->PushClipRect(m_min_canvas_position, m_max_canvas_position, true);
+    draw_list->AddRect(origin, ImVec2(origin.x + (m_generations.GetWidth() * m_grid_steps), origin.y + (m_generations.GetHeight() * m_grid_steps)), IM_COL32(200, 200, 200, 255));
+
+    const int numberOfStates = m_generations.GetRule().numberOfStates;
+    if (m_cellsInStateVersion != m_generations.GetCellsVersion()) {
+        m_cellsInState.resize(numberOfStates - 1);
+        for (int state = 1; state < numberOfStates; ++state) {
+            PackedCells& cells = m_cellsInState[state - 1];
+            if (cells.GetWidth() != m_generations.GetWidth() || cells.GetHeight() != m_generations.GetHeight())
+                cells = PackedCells(m_generations.GetWidth(), m_generations.GetHeight());
+            m_generations.GetCellsInState(state, cells);
+        }
+        m_cellsInStateVersion = m_generations.GetCellsVersion();
+    }
+
+    // Drawn from the last state to the first, which ends up on top.
+    std::vector<const std::uint64_t*> layers;
+    std::vector<ImU32> colours;
+    for (int state = numberOfStates - 1; state >= 1; --state) {
+        const float brightness = (numberOfStates == 2) ? 1.0f : 1.0f - (1.0f - lastStateBrightness) * (state - 1) / (numberOfStates - 2);
+        const ImVec4 colour = m_cell_colour_main.Value;
+        layers.push_back(m_cellsInState[state - 1].GetWords().data());
+        colours.push_back(ImColor(colour.x * brightness, colour.y * brightness, colour.z * brightness, colour.w));
+    }
+
+    DrawPackedLayers(layers, colours, m_cellsInState.empty() ? 0 : m_cellsInState[0].GetWordsPerRow(), m_generations.GetHeight(), m_cellsInStateVersion);
+
+    draw_list->PopClipRect();
+}
@@ -0,0 +1,291 @@
+#include "Grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <utility>
+
+Grid::Grid()
+    : m_cells_to_draw()
+    , m_enable_grid(true)
+    , m_canvas_size(100.0f, 100.0f)
+    , m_min_canvas_position(0.0f, 0.0f)
+    , m_max_canvas_position(100.0f, 100.0f)
+    , m_grid_scrolling(ImVec2(0.0f, 0.0f))
+    , m_grid_steps(10)
+    , m_cell_colour_main(IM_COL32(255.0f, 255.0f, 255.0f, 255.0f))
+    , m_enable_painting(false)
+    , m_is_painting(false)
+    , m_is_erasing(false)
+    , m_is_stroke_start(false)
+    , m_paint_from { 0, 0 }
+    , m_paint_to { 0, 0 }
+    , m_cached_cell_vertices()
+    , m_cell_cache_key()
+    , m_is_cell_cache_valid(false) {};
+
+namespace {
+// Vertices are copied in batches small enough for 16-bit indices.
+constexpr int cachedRectanglesPerBatch = 8192;
+}
+
+bool Grid::CellCacheKey::operator==(const CellCacheKey& other) const
+{
+    return cells_version == other.cells_version && words_per_row == other.words_per_row && number_of_rows == other.number_of_rows
+        && grid_steps == other.grid_steps && canvas_position.x == other.canvas_position.x && canvas_position.y == other.canvas_position.y
+        && scrolling.x == other.scrolling.x && scrolling.y == other.scrolling.y
+        && canvas_width == other.canvas_width && canvas_height == other.canvas_height && colour == other.colour;
+}
+
+// Probably want to convert this to a smart pointer...
+void Grid::EnableGrid(bool input)
+{
+    m_enable_grid = input;
+}
+
+ImVec2 Grid::GetMinimumCanvasPosition() const
+{
+    return m_min_canvas_position;
+}
+
+ImVec2 Grid::GetMaximumCanvasPosition() const
+{
+    return m_max_canvas_position;
+}
+
+ImVec2 Grid::GetCanvasSize() const
+{
+    return m_canvas_size;
+}
+
+ImColor Grid::GetCellMainCellColour()
+{
+    return m_cell_colour_main;
+}
+
+int Grid::GetGridSteps() const
+{
+    return m_grid_steps;
+}
+
+// Only use positive integers or the negative sign will be dropped, as well as any decimals.
+void Grid::SetGridSteps(int gridSteps)
+{
+    if (gridSteps > 0) {
+        m_grid_steps = gridSteps;
+    }
+}
+
+void Grid::SetMainCellColour(ImColor colour)
+{
+    m_cell_colour_main = colour;
+}
+
+void Grid::EnablePainting(bool input)
+{
+    m_enable_painting = input;
+}
+
+bool Grid::GetPaintStroke(CellCoordinates& from, CellCoordinates& to, bool& is_erasing, bool& is_stroke_start) const
+{
+    if (!m_is_painting)
+        return false;
+
+    from = m_paint_from;
+    to = m_paint_to;
+    is_erasing = m_is_erasing;
+    is_stroke_start = m_is_stroke_start;
+    return true;
+}
+
+void Grid::DrawGrid()
+{
+    m_min_canvas_position = ImGui::GetCursorScreenPos();
+    m_canvas_size = ImGui::GetContentRegionAvail();
+
+    // Resize canvas.
+    if (m_canvas_size.x < 50.0f)
+        m_canvas_size.x = 50.0f;
+    if (m_canvas_size.y < 50.0f)
+        m_canvas_size.y = 50.0f;
+    m_max_canvas_position = ImVec2(m_min_canvas_position.x + m_canvas_size.x, m_min_canvas_position.y + m_canvas_size.y);
+
+    // Draw canvas border and background colour.
+    ImGuiIO& io = ImGui::GetIO();
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+
+    draw_list->AddRectFilled(m_min_canvas_position, m_max_canvas_position, IM_COL32(0, 0, 0, 0));
+    draw_list->AddRect(m_min_canvas_position, m_max_canvas_position, IM_COL32(255, 255, 255, 255));
+
+    // Invisible button advances layout cursor + allows interaction with the grid.
+    ImGui::InvisibleButton("Grid Invisible Button", m_canvas_size, ImGuiButtonFlags_MouseButtonLeft | ImGuiButtonFlags_MouseButtonRight | ImGuiButtonFlags_MouseButtonMiddle);
+    const bool is_button_hovered = ImGui::IsItemHovered();
+    const bool is_mouse_clicked = ImGui::IsItemActive();
+
+    // Pan around the grid.
+    // Can make threshold for panning dynamic depending on whether or not mouse is hovering over a widget, for example.
+    const float mouse_threshold_for_panning = 0.0f;
+    const ImGuiMouseButton panning_button = m_enable_painting ? ImGuiMouseButton_Middle : ImGuiMouseButton_Left;
+    if (is_mouse_clicked && ImGui::IsMouseDragging(panning_button, mouse_threshold_for_panning)) {
+        m_grid_scrolling.x += io.MouseDelta.x;
+        m_grid_scrolling.y += io.MouseDelta.y;
+    }
+
+    // Paint the cell under the mouse, joined to the one under it last frame.
+    const bool was_painting = m_is_painting;
+    const bool is_painting_down = ImGui::IsMouseDown(ImGuiMouseButton_Left);
+    const bool is_erasing_down = ImGui::IsMouseDown(ImGuiMouseButton_Right);
+    m_is_painting = m_enable_painting && is_mouse_clicked && (is_painting_down || is_erasing_down);
+    if (m_is_painting) {
+        const ImVec2 origin = ImVec2(m_min_canvas_position.x + m_grid_scrolling.x, m_min_canvas_position.y + m_grid_scrolling.y);
+        const CellCoordinates cell { static_cast<int>(std::floor((io.MousePos.x - origin.x) / m_grid_steps)), static_cast<int>(std::floor((io.MousePos.y - origin.y) / m_grid_steps)) };
+
+        m_is_stroke_start = !was_painting;
+        m_paint_from = m_is_stroke_start ? cell : m_paint_to;
+        m_paint_to = cell;
+        m_is_erasing = is_erasing_down && !is_painting_down;
+    }
+
+    if (m_enable_grid) {
+        // Draw grid lines
+        draw_list->PushClipRect(m_min_canvas_position, m_max_canvas_position, true);
+        for (float x = std::fmod(m_grid_scrolling.x, m_grid_steps); x < m_canvas_size.x; x += m_grid_steps) {
+            draw_list->AddLine(ImVec2(m_min_canvas_position.x + x, m_min_canvas_position.y), ImVec2(m_min_canvas_position.x + x, m_max_canvas_position.y), IM_COL32(200, 200, 200, 40));
+        }
+
+        for (float y = std::fmod(m_grid_scrolling.y, m_grid_steps); y < m_canvas_size.y; y += m_grid_steps) {
+            draw_list->AddLine(ImVec2(m_min_canvas_position.x, m_min_canvas_position.y + y), ImVec2(m_max_canvas_position.x, m_min_canvas_position.y + y), IM_COL32(200, 200, 200, 40));
+        }
+
+        draw_list->PopClipRect();
+    }
+}
+
+// Only use positive integers or the negative sign will be dropped, as well as any decimals.
+void Grid::DrawCells()
+{
+    ImGuiIO& io = ImGui::GetIO();
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+
+    for (auto cell : m_cells_to_draw) {
+        // To remove negative numbers, which don't show up on the grid.
+        if (cell.x < 0 || cell.y < 0) {
+            cell.x = std::abs(cell.x);
+            cell.y = std::abs(cell.y);
+        }
+
+        const ImVec2 origin = ImVec2(m_min_canvas_position.x + m_grid_scrolling.x, m_min_canvas_position.y + m_grid_scrolling.y);
+        ImVec2 cell_pos_i = ImVec2(origin.x + (cell.x * m_grid_steps), origin.y + (cell.y * m_grid_steps));
+        ImVec2 cell_pos_f = ImVec2(cell_pos_i.x + m_grid_steps, cell_pos_i.y + m_grid_steps);
+
+        draw_list->PushClipRect(m_min_canvas_position, m_max_canvas_position, true);
+        draw_list->AddRectFilled(cell_pos_i, cell_pos_f, m_cell_colour_main);
+        draw_list->PopClipRect();
+    }
+}
+
+// Only rows and words inside the canvas are visited, and every run of active cells within a word is drawn as a single rectangle.
+void Grid::DrawPackedCells(const std::uint64_t* words, int wordsPerRow, int numberOfRows, std::uint64_t cellsVersion)
+{
+    DrawPackedRows([&](int y, int firstWord, int) { return words + static_cast<std::size_t>(y) * wordsPerRow + firstWord; }, wordsPerRow, numberOfRows, cellsVersion);
+}
+
+void Grid::DrawPackedRows(const std::function<const std::uint64_t*(int, int, int)>& getRowWords, int wordsPerRow, int numberOfRows, std::uint64_t cellsVersion)
+{
+    if (!IsCellCacheValid(wordsPerRow, numberOfRows, cellsVersion))
+        AddPackedRows(getRowWords, wordsPerRow, numberOfRows, m_cell_colour_main);
+
+    DrawCachedCells(ImGui::GetWindowDrawList());
+}
+
+void Grid::DrawPackedLayers(const std::vector<const std::uint64_t*>& layers, const std::vector<ImU32>& colours, int wordsPerRow, int numberOfRows, std::uint64_t cellsVersion)
+{
+    if (!IsCellCacheValid(wordsPerRow, numberOfRows, cellsVersion)) {
+        for (std::size_t layer = 0; layer < layers.size() && layer < colours.size(); ++layer) {
+            const std::uint64_t* words = layers[layer];
+            AddPackedRows([&](int y, int firstWord, int) { return words + static_cast<std::size_t>(y) * wordsPerRow + firstWord; }, wordsPerRow, numberOfRows, colours[layer]);
+        }
+    }
+
+    DrawCachedCells(ImGui::GetWindowDrawList());
+}
+
+bool Grid::IsCellCacheValid(int wordsPerRow, int numberOfRows, std::uint64_t cellsVersion)
+{
+    const CellCacheKey key { cellsVersion, wordsPerRow, numberOfRows, m_grid_steps, m_min_canvas_position, m_grid_scrolling, m_canvas_size.x, m_canvas_size.y, m_cell_colour_main };
+    if (m_is_cell_cache_valid && key == m_cell_cache_key)
+        return true;
+
+    m_cached_cell_vertices.clear();
+    m_cell_cache_key = key;
+    m_is_cell_cache_valid = true;
+    return false;
+}
+
+void Grid::AddPackedRows(const std::function<const std::uint64_t*(int, int, int)>& getRowWords, int wordsPerRow, int numberOfRows, ImU32 colour)
+{
+    const ImVec2 origin = ImVec2(m_min_canvas_position.x + m_grid_scrolling.x, m_min_canvas_position.y + m_grid_scrolling.y);
+    const float steps = static_cast<float>(m_grid_steps);
+    const ImVec2 uv = ImGui::GetFontTexUvWhitePixel();
+
+    const int firstRow = std::max(0, static_cast<int>(std::floor(-m_grid_scrolling.y / steps)));
+    const int lastRow = std::min(numberOfRows, static_cast<int>(std::ceil((m_canvas_size.y - m_grid_scrolling.y) / steps)));
+    const int firstWord = std::max(0, static_cast<int>(std::floor(-m_grid_scrolling.x / steps)) / 64);
+    const int lastWord = std::min(wordsPerRow, static_cast<int>(std::ceil((m_canvas_size.x - m_grid_scrolling.x) / steps)) / 64 + 1);
+    if (firstWord >= lastWord)
+        return;
+
+    for (int y = firstRow; y < lastRow; ++y) {
+        const std::uint64_t* rowWords = getRowWords(y, firstWord, lastWord);
+        if (rowWords == nullptr)
+            continue;
+
+        for (int word = firstWord; word < lastWord; ++word) {
+            std::uint64_t bits = rowWords[word - firstWord];
+            while (bits != 0) {
+                const int runStart = CountTrailingZeros(bits);
+                const std::uint64_t remainingBits = ~(bits >> runStart);
+                const int runLength = (remainingBits == 0) ? 64 - runStart : CountTrailingZeros(remainingBits);
+
+                const int x = word * 64 + runStart;
+                const ImVec2 cell_pos_i = ImVec2(origin.x + (x * steps), origin.y + (y * steps));
+                const ImVec2 cell_pos_f = ImVec2(cell_pos_i.x + (runLength * steps), cell_pos_i.y + steps);
+                m_cached_cell_vertices.push_back(ImDrawVert { cell_pos_i, uv, colour });
+                m_cached_cell_vertices.push_back(ImDrawVert { ImVec2(cell_pos_f.x, cell_pos_i.y), uv, colour });
+                m_cached_cell_vertices.push_back(ImDrawVert { cell_pos_f, uv, colour });
+                m_cached_cell_vertices.push_back(ImDrawVert { ImVec2(cell_pos_i.x, cell_pos_f.y), uv, colour });
+
+                bits = (runStart + runLength == 64) ? 0 : bits & (~std::uint64_t(0) << (runStart + runLength));
+            }
+        }
+    }
+}
+
+void Grid::DrawCachedCells(ImDrawList* draw_list) const
+{
+    const int numberOfRectangles = static_cast<int>(m_cached_cell_vertices.size() / 4);
+    for (int firstRectangle = 0; firstRectangle < numberOfRectangles; firstRectangle += cachedRectanglesPerBatch) {
+        const int batchRectangles = std::min(cachedRectanglesPerBatch, numberOfRectangles - firstRectangle);
+
+        // Reserving moves to a new vertex offset when the 16-bit indices would run out.
+        draw_list->PrimReserve(batchRectangles * 6, batchRectangles * 4);
+        std::copy_n(m_cached_cell_vertices.data() + static_cast<std::size_t>(firstRectangle) * 4, batchRectangles * 4, draw_list->_VtxWritePtr);
+
+        const unsigned int firstVertex = draw_list->_VtxCurrentIdx;
+        for (int rectangle = 0; rectangle < batchRectangles; ++rectangle) {
+            const auto vertex = static_cast<ImDrawIdx>(firstVertex + rectangle * 4);
+            ImDrawIdx* indices = draw_list->_IdxWritePtr + rectangle * 6;
+            indices[0] = vertex;
+            indices[1] = static_cast<ImDrawIdx>(vertex + 1);
+            indices[2] = static_cast<ImDrawIdx>(vertex + 2);
+            indices[3] = vertex;
+            indices[4] = static_cast<ImDrawIdx>(vertex + 2);
+            indices[5] = static_cast<ImDrawIdx>(vertex + 3);
+        }
+
+        draw_list->_VtxWritePtr += batchRectangles * 4;
+        draw_list->_IdxWritePtr += batchRectangles * 6;
+        draw_list->_VtxCurrentIdx += batchRectangles * 4;
+    }
+}
@@ -0,0 +1,1104 @@
+/*
+* Developed by Kareem Skinner - (https://github.com/KareemSkinner/The_Cellular_Automata)
+* This program generates elementary cellular automata and Conway's Game of Life.
+* Inspired by Stephen Wolfram's book - "A New Kind of Science"
+*/
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Application
+#include "CellEdits.h"
+#include "DiagramFileView.h"
+#include "Elementary.h"
+#include "GameOfLife.h"
+#include "ElementaryView.h"
+#include "GameOfLifeView.h"
+#include "Generations.h"
+#include "GenerationsView.h"
+#include "Grid.h"
+#include "LifeEnsemble.h"
+#include "Margolus.h"
+#include "MargolusView.h"
+#include "MemoryBudget.h"
+#include "PatternSearch.h"
+
+// (GLFW is a cross-platform general purpose library for handling windows, inputs, OpenGL/Vulkan/Metal graphics context creation, etc.)
+#include "imgui.h"
+#include "imgui_impl_glfw.h"
+#include "imgui_impl_opengl3.h"
+
+// About Desktop OpenGL function loaders:
+//  Modern desktop OpenGL doesn't have a standard portable header file to load OpenGL function pointers.
+//  Helper libraries are often used for this purpose! Here a few common ones (gl3w, glew, glad).
+//  Another loader may be used (glext, glLoadGen, etc.), or manually implemented.
+#if defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h> // Initialize with gl3wInit()
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GLEW)
+#include <GL/glew.h> // Initialize with glewInit()
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GLAD)
+#include <glad/glad.h> // Initialize with gladLoadGL()
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GLAD2)
+#include <glad/gl.h> // Initialize with gladLoadGL(...) or gladLoaderLoadGL()
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GLBINDING2)
+#define GLFW_INCLUDE_NONE // GLFW including OpenGL headers causes ambiguity or multiple definition errors.
+#include <glbinding/Binding.h> // Initialize with glbinding::Binding::initialize()
+#include <glbinding/gl/gl.h>
+using namespace gl;
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GLBINDING3)
+#define GLFW_INCLUDE_NONE // GLFW including OpenGL headers causes ambiguity or multiple definition errors.
+#include <glbinding/gl/gl.h>
+#include <glbinding/glbinding.h> // Initialize with glbinding::initialize()
+using namespace gl;
+#else
+#include IMGUI_IMPL_OPENGL_LOADER_CUSTOM
+#endif
+
+// Include glfw3.h after OpenGL definitions
+#include <GLFW/glfw3.h>
+
+static void glfw_error_callback(int error, const char* description)
+{
+    fprintf(stderr, "Glfw Error %d: %s\n", error, description);
+}
+
+int main(int, char**)
+{
+    // Setup window
+    glfwSetErrorCallback(glfw_error_callback);
+    if (!glfwInit())
+        return 1;
+
+    // GL 3.0 + GLSL 130
+    const char* glsl_version = "#version 130";
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+    //glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);  // 3.2+ only
+    //glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);            // 3.0+ only
+
+    // Create window with graphics context
+    GLFWwindow* window = glfwCreateWindow(1280, 720, "Dear ImGui GLFW+OpenGL3 example", NULL, NULL);
+    if (window == NULL)
+        return 1;
+
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(1); // Enable vsync
+
+    // Initialize OpenGL loader
+    bool err = glewInit() != GLEW_OK;
+
+    if (err) {
+        fprintf(stderr, "Failed to initialize OpenGL loader!\n");
+        return 1;
+    }
+
+    // Setup Dear ImGui context
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    //io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
+    //io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
+
+    // Setup Dear ImGui style
+    ImGui::StyleColorsDark();
+
+    // Setup Platform/Renderer bindings
+    ImGui_ImplGlfw_InitForOpenGL(window, true);
+    ImGui_ImplOpenGL3_Init(glsl_version);
+
+    // Window state
+    const ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
+
+    // Class Setup
+    Grid basicGrid;
+    GameOfLife ConwaysGameOfLife;
+    GameOfLifeView ConwaysGameOfLifeView(ConwaysGameOfLife);
+    Generations generationsAutomata;
+    GenerationsView generationsAutomataView(generationsAutomata);
+    Margolus margolusAutomata;
+    MargolusView margolusAutomataView(margolusAutomata);
+    Elementary elementaryAutomata;
+    ElementaryView elementaryAutomataView(elementaryAutomata);
+    DiagramFile elementaryDiagramFile;
+    DiagramFileView elementaryDiagramFileView(elementaryDiagramFile);
+
+    // Frames are only drawn while something is changing on its own or for a few frames after input, which ImGui needs to settle
+    // hovering and the like. Otherwise the loop sleeps until there's input, waking now and then to blink the text cursor.
+    constexpr int framesAfterInput = 3;
+    constexpr double idleWaitSeconds = 0.5;
+    int framesUntilIdle = framesAfterInput;
+    bool isAnimating = true;
+
+    while (!glfwWindowShouldClose(window)) {
+        // Poll and handle events (inputs, window resize, etc.)
+        // Read the io.WantCaptureMouse, io.WantCaptureKeyboard flags to tell if dear imgui wants to use your inputs.
+        // - When io.WantCaptureMouse is true, do not dispatch mouse input data to main application.
+        // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to main application.
+        // Generally may always pass all inputs to dear imgui, and hide them from the application based on those two flags.
+        if (isAnimating || framesUntilIdle > 0) {
+            glfwPollEvents();
+            framesUntilIdle = std::max(0, framesUntilIdle - 1);
+        } else {
+            // Waking before the timeout means there was input.
+            const double waitStart = glfwGetTime();
+            glfwWaitEventsTimeout(idleWaitSeconds);
+            if (glfwGetTime() - waitStart < idleWaitSeconds)
+                framesUntilIdle = framesAfterInput;
+        }
+        isAnimating = false;
+
+        // Feed inputs to imgui, starts a new frame.
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
+        ImGui::NewFrame();
+
+        // Settings to get the ImGui window to adapt to the OS window size.
+        ImGui::SetNextWindowPos(ImVec2(0, 0));
+        ImGui::SetNextWindowSize(io.DisplaySize);
+        ImGui::Begin("The Cellular Automata", 0, ImGuiWindowFlags_MenuBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoScrollWithMouse);
+
+        // Application Flags.
+        static bool show_demo_window = false;
+        static bool show_basic_drawing_grid = false;
+        static bool show_about_window = false;
+        static bool show_rules_window = false;
+
+        static bool time_functions = false;
+
+        {
+            {
+                ImGui::BeginMenuBar();
+
+                if (ImGui::BeginMenu("Menu")) {
+                    ImGui::MenuItem("Show ImGui Demo Window", nullptr, &show_demo_window);
+                    ImGui::MenuItem("Show Basic Drawing Grid", nullptr, &show_basic_drawing_grid);
+                    ImGui::EndMenu();
+                }
+
+                // Every universe and cache shares the memory budget. Requests that don't fit are refused, and caches shrink to make room.
+                auto& memoryBudget = MemoryBudget::GetGlobal();
+                constexpr double bytesPerMB = 1024.0 * 1024.0;
+                if (ImGui::BeginMenu("Memory")) {
+                    static int memoryBudgetMB = static_cast<int>(memoryBudget.GetLimit() / (1024 * 1024));
+                    ImGui::SetNextItemWidth(100);
+                    if (ImGui::InputInt("Budget (MB)", &memoryBudgetMB, 64, 1024, ImGuiInputTextFlags_EnterReturnsTrue)) {
+                        memoryBudgetMB = std::max(memoryBudgetMB, 1);
+                        memoryBudget.SetLimit(static_cast<std::size_t>(memoryBudgetMB) * 1024 * 1024);
+                    }
+
+                    ImGui::Separator();
+                    for (const auto& account : memoryBudget.GetAccountUsages()) {
+                        ImGui::Text("%s = %.2f MB (peak %.2f MB)%s", account.name.c_str(), account.usage / bytesPerMB, account.peakUsage / bytesPerMB,
+                            account.isShrinkable ? ", shrinks under pressure" : "");
+                    }
+
+                    ImGui::Separator();
+                    ImGui::Text("Total = %.2f MB (peak %.2f MB)", memoryBudget.GetUsage() / bytesPerMB, memoryBudget.GetPeakUsage() / bytesPerMB);
+                    const std::size_t residentMemory = MemoryBudget::GetProcessResidentMemory();
+                    if (residentMemory > 0)
+                        ImGui::Text("Process Resident = %.2f MB", residentMemory / bytesPerMB);
+                    if (memoryBudget.GetNumberOfRefusals() > 0) {
+                        const MemoryRefusal refusal = memoryBudget.GetLastRefusal();
+                        ImGui::Text("Last Refused: %s needed %.2f MB, %.2f MB available", refusal.accountName.c_str(), refusal.requestedUsage / bytesPerMB,
+                            refusal.availableUsage / bytesPerMB);
+                    }
+
+                    ImGui::EndMenu();
+                }
+
+                if (ImGui::BeginMenu("About")) {
+                    ImGui::MenuItem("Rules", nullptr, &show_rules_window);
+                    ImGui::MenuItem("About...", nullptr, &show_about_window);
+                    ImGui::EndMenu();
+                }
+
+                {
+                    // Metrics.
+                    ImGui::Separator();
+                    ImGui::Text("Dear ImGui Version: %s", ImGui::GetVersion());
+                    ImGui::SameLine();
+                    ImGui::Text("Framerate = %.1f FPS", io.Framerate);
+                    ImGui::SameLine();
+                    ImGui::Text("Memory = %.0f of %.0f MB", memoryBudget.GetUsage() / bytesPerMB, memoryBudget.GetLimit() / bytesPerMB);
+
+                    // A refusal stays up for a few seconds, long enough to read after typing the size that caused it.
+                    constexpr double refusalSeconds = 5.0;
+                    static std::uint64_t numberOfRefusalsSeen = 0;
+                    static double refusalTime = -refusalSeconds;
+                    if (memoryBudget.GetNumberOfRefusals() != numberOfRefusalsSeen) {
+                        numberOfRefusalsSeen = memoryBudget.GetNumberOfRefusals();
+                        refusalTime = glfwGetTime();
+                    }
+                    if (glfwGetTime() - refusalTime < refusalSeconds) {
+                        const MemoryRefusal refusal = memoryBudget.GetLastRefusal();
+                        ImGui::SameLine();
+                        ImGui::Text("Refused: %s needs %.2f MB, only %.2f MB available", refusal.accountName.c_str(), refusal.requestedUsage / bytesPerMB,
+                            refusal.availableUsage / bytesPerMB);
+                    }
+                }
+
+                if (show_demo_window) {
+                    ImGui::ShowDemoWindow(&show_demo_window);
+                }
+
+                if (show_rules_window) {
+                    ImGui::Begin("Rules", &show_rules_window, ImGuiWindowFlags_AlwaysAutoResize);
+
+                    ImGui::Text("John Conway's Game of Life:");
+                    const std::string gameOfLifeRules = "The universe of the Game of Life is an infinite, two-dimensional orthogonal grid of square cells, each of which is in one of two possible states, alive or dead.\n"
+                                                        "Every cell interacts with its eight neighbours, which are the cells that are horizontally, vertically, or diagonally adjacent.\n"
+                                                        "At each step in time, the following transitions occur:\n"
+                                                        "1. Any live cell with fewer than two live neighbours dies, as if by underpopulation.\n"
+                                                        "2. Any live cell with two or three live neighbours lives on to the next generation.\n"
+                                                        "3. Any live cell with more than three live neighbours dies, as if by overpopulation.\n"
+                                                        "4. Any dead cell with exactly three live neighbours becomes a live cell, as if by reproduction.\n";
+                    ImGui::Text(gameOfLifeRules.c_str());
+
+                    ImGui::Separator();
+
+                    ImGui::Text("Elementary Cellular Automata:");
+                    const std::string elementaryCellularAutomataRules = "The simplest class of aone-dimensional cellular automata.\n"
+                                                                        "Elementary cellular automata have two possible values for each cell (0 or 1), and rules that depend only on previous neighbor values.\n"
+                                                                        "As a result, the evolution of an elementary cellular automaton can completely be described by a table specifying the state a given cell will have in the next generation.\n"
+                                                                        "These states are based on the value of the cell itself, and the values of the cells to the left and right.\n"
+                                                                        "Since there are 2^3 = 8 possible binary states for the neighbour cells, there are a total of 2^8 = 256 elementary cellular automata, indexted by an 8-bit binary number.\n"
+                                                                        "One such example is the default example given in this program, known as rule 90: 01011010.\n"
+                                                                        "- Stephen Wolfram - Wolfram MathWorld (https://mathworld.wolfram.com/ElementaryCellularAutomaton.html)";
+                    ImGui::Text(elementaryCellularAutomataRules.c_str());
+
+                    ImGui::End();
+                }
+
+                if (show_about_window) {
+                    ImGui::Begin("About this program", &show_about_window, ImGuiWindowFlags_AlwaysAutoResize);
+
+                    const std::string aboutText = "Developed by Kareem Skinner - (https://github.com/KareemSkinner/The_Cellular_Automata).\n"
+                                                  "This program generates elementary cellular automata and Conway's Game of Life.\n"
+                                                  "Inspired by Stephen Wolfram's book - 'A New Kind of Science'.\n"
+                                                  "Please enjoy :)\n";
+
+                    ImGui::Text(aboutText.c_str());
+                    ImGui::End();
+                }
+
+                ImGui::EndMenuBar();
+            }
+
+            ImGui::BeginTabBar("Main Tab");
+
+            if (show_basic_drawing_grid) {
+                if (ImGui::Begin("Basic Grid", &show_basic_drawing_grid)) {
+                    static bool gridSwitch = true;
+                    ImGui::Checkbox("Enable Grid", &gridSwitch);
+                    basicGrid.EnableGrid(gridSwitch);
+
+                    static int gridSteps = 40;
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::SliderInt("Grid Step Size", &gridSteps, 1, 100);
+                    basicGrid.SetGridSteps(gridSteps);
+
+                    static int basic_rect_x = 0;
+                    static int basic_rect_y = 0;
+
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::InputInt("x-coordinate", &basic_rect_x);
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::InputInt("y-coordinate", &basic_rect_y);
+
+                    ImGui::SetNextItemWidth(300);
+                    static ImVec4 colour_picker = { 1.0f, 0.0f, 0.0f, 1.0f };
+                    ImGui::ColorEdit4("Cell Colour", &colour_picker.x);
+                    basicGrid.SetMainCellColour(static_cast<ImColor>(colour_picker));
+
+                    ImGui::Separator();
+
+                    {
+                        ImGui::BeginTabBar("Grid Tab");
+                        ImGui::BeginTabItem("Grid");
+                        if (basic_rect_x < 0)
+                            basic_rect_x = 0;
+                        if (basic_rect_y < 0)
+                            basic_rect_y = 0;
+
+                        basicGrid.DrawGrid();
+
+                        basicGrid.m_cells_to_draw = { ImVec2(static_cast<float>(basic_rect_x), static_cast<float>(basic_rect_y)) };
+                        basicGrid.DrawCells();
+                        ImGui::EndTabItem();
+                        ImGui::EndTabBar();
+                    }
+
+                    ImGui::End();
+                }
+            }
+
+            if (ImGui::BeginTabItem("Game of Life")) {
+                static bool GoLgridSwitch = false;
+                ImGui::Checkbox("Enable Grid", &GoLgridSwitch);
+                ConwaysGameOfLifeView.EnableGrid(GoLgridSwitch);
+
+                static int gameWidth = ConwaysGameOfLife.GetWidth();
+                static int gameHeight = ConwaysGameOfLife.GetHeight();
+
+                if (gameWidth < 0)
+                    gameWidth = 0;
+                if (gameHeight < 0)
+                    gameHeight = 0;
+
+                ImGui::SetNextItemWidth(100);
+                ImGui::InputInt("Game Width", &gameWidth, 1, 10);
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(100);
+                ImGui::InputInt("Game Height", &gameHeight, 1, 10);
+
+                // Sizes over the memory budget are refused, and the inputs go back to the size the universe is.
+                if (!ConwaysGameOfLife.SetGameDimensions(gameWidth, gameHeight)) {
+                    gameWidth = ConwaysGameOfLife.GetWidth();
+                    gameHeight = ConwaysGameOfLife.GetHeight();
+                }
+
+                static int radioButtonSwitch = 0;
+                ImGui::RadioButton("Conway's Game of Life", &radioButtonSwitch, 0);
+                ImGui::SameLine();
+                ImGui::RadioButton("R-Pentomino", &radioButtonSwitch, 1);
+                ImGui::SameLine();
+                ImGui::RadioButton("Glider Gun", &radioButtonSwitch, 2);
+                ImGui::SameLine();
+                ImGui::RadioButton("Infinite Growth", &radioButtonSwitch, 3);
+
+                if (ImGui::Button("Generate")) {
+                    switch (radioButtonSwitch) {
+                    case 0: {
+                        ConwaysGameOfLife.GenerateRandomCells();
+                        break;
+                    }
+                    case 1: {
+                        ConwaysGameOfLife.GeneratePattern(Pattern::R_Pentomino);
+                        break;
+                    }
+                    case 2: {
+                        ConwaysGameOfLife.GeneratePattern(Pattern::Glider_Gun);
+                        break;
+                    }
+                    case 3: {
+                        ConwaysGameOfLife.GeneratePattern(Pattern::Infinite_Growth);
+                        break;
+                    }
+                    }
+                }
+
+                static int gridSteps = 5;
+                ImGui::SetNextItemWidth(100);
+                ImGui::SliderInt("Zoom", &gridSteps, 1, 100);
+                ConwaysGameOfLifeView.SetGridSteps(gridSteps);
+
+                // Painting draws on the universe even while it runs, with the middle mouse button panning instead.
+                // Stamping puts the loaded pattern's top left corner where the left button is clicked.
+                static bool isPainting = false;
+                static int paintMode = 0;
+                static int brushRadius = 0;
+                static char stampPath[256] = "pattern.rle";
+                static PackedCells stampPattern = [] {
+                    PackedCells glider;
+                    ParseRlePattern("x = 3, y = 3\nbo$2bo$3o!", glider);
+                    return glider;
+                }();
+                static bool isStampLoaded = true;
+                ImGui::Checkbox("Paint", &isPainting);
+                ConwaysGameOfLifeView.EnablePainting(isPainting);
+                if (isPainting) {
+                    ImGui::SameLine();
+                    ImGui::RadioButton("Brush", &paintMode, 0);
+                    ImGui::SameLine();
+                    ImGui::RadioButton("Stamp", &paintMode, 1);
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::SliderInt("Brush Radius", &brushRadius, 0, 64);
+
+                    ImGui::SetNextItemWidth(200);
+                    ImGui::InputText("RLE Pattern", stampPath, sizeof(stampPath));
+                    ImGui::SameLine();
+                    if (ImGui::Button("Load Pattern")) {
+                        std::ifstream patternFile(stampPath);
+                        const std::string patternText((std::istreambuf_iterator<char>(patternFile)), std::istreambuf_iterator<char>());
+                        isStampLoaded = patternFile.is_open() && ParseRlePattern(patternText, stampPattern);
+                    }
+                    ImGui::SameLine();
+                    if (isStampLoaded)
+                        ImGui::Text("%d x %d", stampPattern.GetWidth(), stampPattern.GetHeight());
+                    else
+                        ImGui::Text("Couldn't load the pattern");
+                }
+
+                // Every generation is recorded, so the timeline can be scrubbed back to see how the universe developed.
+                static bool isPaused = ConwaysGameOfLife.IsPaused();
+                static bool isRecordingHistory = ConwaysGameOfLife.IsRecordingHistory();
+                static int historyBudgetMB = static_cast<int>(ConwaysGameOfLife.GetHistory().GetMemoryBudget() / (1024 * 1024));
+
+                ImGui::Checkbox("Pause", &isPaused);
+                ImGui::SameLine();
+                ImGui::Checkbox("Record History", &isRecordingHistory);
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(100);
+                ImGui::SliderInt("History Size (MB)", &historyBudgetMB, 1, 4096);
+                // Recording keeps two copies of the universe, which the memory budget may refuse.
+                if (!ConwaysGameOfLife.SetRecordingHistory(isRecordingHistory))
+                    isRecordingHistory = ConwaysGameOfLife.IsRecordingHistory();
+                ConwaysGameOfLife.SetHistoryMemoryBudget(static_cast<std::size_t>(historyBudgetMB) * 1024 * 1024);
+
+                const auto& history = ConwaysGameOfLife.GetHistory();
+                if (!history.IsEmpty()) {
+                    std::uint64_t timelineGeneration = ConwaysGameOfLife.GetGeneration();
+                    const std::uint64_t firstGeneration = history.GetFirstGeneration();
+                    const std::uint64_t lastGeneration = history.GetLastGeneration();
+
+                    ImGui::SetNextItemWidth(400);
+                    if (ImGui::SliderScalar("Timeline", ImGuiDataType_U64, &timelineGeneration, &firstGeneration, &lastGeneration)) {
+                        isPaused = true;
+                        ConwaysGameOfLife.SeekGeneration(timelineGeneration);
+                    }
+                    ImGui::SameLine();
+                    ImGui::Text("Generations %llu to %llu (%.2f MB)", static_cast<unsigned long long>(firstGeneration), static_cast<unsigned long long>(lastGeneration), history.GetMemoryUsage() / (1024.0f * 1024.0f));
+                }
+                ConwaysGameOfLife.SetPaused(isPaused);
+
+                // Any Life-like rule in B/S notation, applied when Enter is pressed.
+                static char lifeRule[32] = "B3/S23";
+                ImGui::SetNextItemWidth(100);
+                if (ImGui::InputText("Rule", lifeRule, sizeof(lifeRule), ImGuiInputTextFlags_EnterReturnsTrue)) {
+                    LifeRule rule {};
+                    if (LifeRule::Parse(lifeRule, rule))
+                        ConwaysGameOfLife.SetRule(rule);
+                }
+                ImGui::SameLine();
+                ImGui::Text("%s", ConwaysGameOfLife.GetRule().ToString().c_str());
+
+                // Larger than Life counts a whole square of neighbours around each cell, in Golly's notation.
+                static bool isLargerThanLife = ConwaysGameOfLife.IsLargerThanLife();
+                static char largerThanLifeRule[64] = "R5,C0,M1,S34..58,B34..45,NM";
+                ImGui::Checkbox("Larger than Life", &isLargerThanLife);
+                if (!ConwaysGameOfLife.SetLargerThanLife(isLargerThanLife))
+                    isLargerThanLife = ConwaysGameOfLife.IsLargerThanLife();
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(250);
+                if (ImGui::InputText("Large Radius Rule", largerThanLifeRule, sizeof(largerThanLifeRule), ImGuiInputTextFlags_EnterReturnsTrue)) {
+                    LargerThanLifeRule rule {};
+                    if (LargerThanLifeRule::Parse(largerThanLifeRule, rule))
+                        ConwaysGameOfLife.SetLargerThanLifeRule(rule);
+                }
+                ImGui::SameLine();
+                ImGui::Text("%s", ConwaysGameOfLife.GetLargerThanLifeRule().ToString().c_str());
+
+                // Stepping several generations per frame lets universes larger than the cache be temporally blocked.
+                static int generationsPerFrame = 1;
+                ImGui::SetNextItemWidth(100);
+                if (ImGui::InputInt("Generations Per Frame", &generationsPerFrame)) {
+                    generationsPerFrame = std::clamp(generationsPerFrame, 1, 1024);
+                    ConwaysGameOfLife.SetGenerationsPerFrame(generationsPerFrame);
+                }
+
+                // Every engine steps the same generations at a different speed, the fastest is picked by timing them on the universe.
+                auto& engineTuner = ConwaysGameOfLife.GetEngineTuner();
+                if (ImGui::CollapsingHeader("Step Engines")) {
+                    const int engineOverride = engineTuner.GetOverride();
+                    ImGui::SetNextItemWidth(200);
+                    if (ImGui::BeginCombo("Engine", (engineOverride < 0) ? "Fastest" : engineTuner.GetEngineName(engineOverride))) {
+                        if (ImGui::Selectable("Fastest", engineOverride < 0))
+                            engineTuner.SetOverride(-1);
+                        for (int engine = 0; engine < engineTuner.GetNumberOfEngines(); ++engine) {
+                            if (ImGui::Selectable(engineTuner.GetEngineName(engine), engineOverride == engine))
+                                engineTuner.SetOverride(engine);
+                        }
+                        ImGui::EndCombo();
+                    }
+                    ImGui::SameLine();
+                    if (ImGui::Button("Retune"))
+                        engineTuner.Retune();
+                    if (engineTuner.IsTuning()) {
+                        ImGui::SameLine();
+                        ImGui::Text("Tuning...");
+                    }
+
+                    // Engines that were far too slow on a corner of the universe were never timed on all of it.
+                    for (int engine = 0; engine < engineTuner.GetNumberOfEngines(); ++engine) {
+                        ImGui::Text("%s %s: %.1f million cells per second%s", (engine == engineTuner.GetSelectedEngine()) ? ">" : " ",
+                            engineTuner.GetEngineName(engine), engineTuner.GetThroughput(engine) / 1'000'000.0,
+                            engineTuner.IsMeasuredOnWholeUniverse(engine) ? "" : " (corner)");
+                    }
+                }
+
+                // Very large universes can be split across worker processes, each stepping its own slab of rows.
+                if (SlabWorkers::IsSupported()) {
+                    static int workerProcesses = 1;
+                    static bool pinWorkerProcesses = false;
+
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(100);
+                    bool isWorkerSetupChanged = ImGui::InputInt("Worker Processes", &workerProcesses);
+                    ImGui::SameLine();
+                    isWorkerSetupChanged |= ImGui::Checkbox("Pin To CPUs", &pinWorkerProcesses);
+
+                    workerProcesses = std::clamp(workerProcesses, 1, 64);
+                    if (isWorkerSetupChanged)
+                        ConwaysGameOfLife.SetNumberOfWorkerProcesses(workerProcesses, pinWorkerProcesses);
+                    // Back to one when the workers couldn't be started, or stopped after one couldn't be restarted.
+                    workerProcesses = ConwaysGameOfLife.GetNumberOfWorkerProcesses();
+
+                    ImGui::SameLine();
+                    ImGui::Text("Worker Restarts = %d", ConwaysGameOfLife.GetNumberOfWorkerRestarts());
+                }
+
+                // Monte-Carlo sweep of random soups, run in the background 64 soups at a time.
+                if (ImGui::CollapsingHeader("Soup Ensemble")) {
+                    static int soupWidth = 32;
+                    static int soupHeight = 32;
+                    static int numberOfSoups = 64 * 1000;
+                    static int maximumGeneration = 5000;
+                    static int soupDensity = 128;
+                    static std::uint64_t soupSeed = 1;
+                    static std::future<SoupSweepResult> soupSweep;
+                    static SoupSweepResult soupSweepResult {};
+                    static std::vector<float> lifetimeHistogram;
+
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::InputInt("Soup Width", &soupWidth);
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::InputInt("Soup Height", &soupHeight);
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::SliderInt("Density (/256)", &soupDensity, 0, 256);
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::InputInt("Number of Soups", &numberOfSoups, 64, 6400);
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::InputInt("Maximum Generation", &maximumGeneration);
+
+                    soupWidth = std::clamp(soupWidth, 1, 1024);
+                    soupHeight = std::clamp(soupHeight, 1, 1024);
+                    numberOfSoups = std::clamp(numberOfSoups, 1, 64 * 1'000'000);
+                    maximumGeneration = std::clamp(maximumGeneration, 1, 1'000'000);
+
+                    if (soupSweep.valid()) {
+                        if (soupSweep.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                            soupSweepResult = soupSweep.get();
+
+                            // Lifetimes binned into 50 bins up to the maximum generation, unstable soups are left out.
+                            // A sweep the memory budget refused leaves no histogram.
+                            lifetimeHistogram.assign(soupSweepResult.isRun ? 50 : 0, 0.0f);
+                            for (int stabilizationGeneration : soupSweepResult.stabilizationGenerations) {
+                                if (stabilizationGeneration >= 0)
+                                    ++lifetimeHistogram[std::min(49, static_cast<int>(static_cast<std::int64_t>(stabilizationGeneration) * 50 / maximumGeneration))];
+                            }
+                        } else {
+                            ImGui::Text("Running...");
+                            isAnimating = true;
+                        }
+                    } else if (ImGui::Button("Run Soups")) {
+                        soupSweep = std::async(std::launch::async, RunSoupSweep, soupWidth, soupHeight, numberOfSoups, maximumGeneration, soupSeed, soupDensity);
+                        soupSeed += (numberOfSoups + LifeEnsemble::numberOfLanes - 1) / LifeEnsemble::numberOfLanes;
+                    }
+
+                    if (!lifetimeHistogram.empty()) {
+                        ImGui::Text("%d soups in %.2f seconds (%.0f soups per hour), %d unstable by the maximum generation",
+                            soupSweepResult.numberOfSoups, soupSweepResult.seconds,
+                            soupSweepResult.numberOfSoups / std::max(soupSweepResult.seconds, 1e-9) * 3600.0, soupSweepResult.numberOfUnstableSoups);
+                        ImGui::PlotHistogram("Lifetimes", lifetimeHistogram.data(), static_cast<int>(lifetimeHistogram.size()), 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 80));
+                    }
+                }
+
+                // Edits that don't fit in the queue wait here for the next frame, in order.
+                static std::vector<CellEdit> unqueuedEdits;
+
+                if (ImGui::CollapsingHeader("Pattern Search")) {
+                    static PatternSearch patternSearch;
+                    static PatternSearchSettings searchSettings { 5, 5, true, 100'000'000, 1, 4, 0, LifeRule::Conway() };
+                    static std::vector<FoundPattern> foundPatterns;
+                    static int searchedKinds = 3;
+
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::SliderInt("Box Width", &searchSettings.boxWidth, 1, PatternSearchSettings::maximumBoxSize);
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::SliderInt("Box Height", &searchSettings.boxHeight, 1, PatternSearchSettings::maximumBoxSize);
+                    ImGui::SameLine();
+                    ImGui::Checkbox("Every Configuration", &searchSettings.isExhaustive);
+                    if (!searchSettings.isExhaustive) {
+                        ImGui::SetNextItemWidth(150);
+                        ImGui::InputScalar("Random Candidates", ImGuiDataType_U64, &searchSettings.numberOfRandomCandidates);
+                    }
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::SliderInt("Maximum Period", &searchSettings.maximumPeriod, 1, PatternSearchSettings::maximumPeriodLimit);
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::InputInt("Settle Generations", &searchSettings.settleGenerations);
+                    searchSettings.settleGenerations = std::clamp(searchSettings.settleGenerations, 0, PatternSearchSettings::maximumSettleGenerations);
+
+                    if (patternSearch.IsRunning()) {
+                        isAnimating = true;
+                        if (ImGui::Button("Stop Search"))
+                            patternSearch.Stop();
+                    } else if (ImGui::Button("Search")) {
+                        // Searched with the universe's rule, so any result behaves the same once loaded.
+                        searchSettings.rule = ConwaysGameOfLife.GetRule();
+                        if (patternSearch.Start(searchSettings))
+                            ++searchSettings.seed;
+                    }
+                    ImGui::SameLine();
+                    const double searchSeconds = patternSearch.GetSeconds();
+                    ImGui::Text("%llu of %llu candidates in %.1f seconds (%.2f billion per hour)", static_cast<unsigned long long>(patternSearch.GetNumberOfTestedCandidates()),
+                        static_cast<unsigned long long>(patternSearch.GetNumberOfCandidates()), searchSeconds,
+                        patternSearch.GetNumberOfTestedCandidates() / std::max(searchSeconds, 1e-9) * 3600.0 / 1e9);
+
+                    if (foundPatterns.size() != patternSearch.GetNumberOfResults())
+                        foundPatterns = patternSearch.GetResults();
+
+                    ImGui::RadioButton("All", &searchedKinds, 3);
+                    ImGui::SameLine();
+                    ImGui::RadioButton("Still Lifes", &searchedKinds, static_cast<int>(PatternKind::stillLife));
+                    ImGui::SameLine();
+                    ImGui::RadioButton("Oscillators", &searchedKinds, static_cast<int>(PatternKind::oscillator));
+                    ImGui::SameLine();
+                    ImGui::RadioButton("Spaceships", &searchedKinds, static_cast<int>(PatternKind::spaceship));
+
+                    // Loading a pattern puts it in the middle of an empty universe.
+                    ImGui::BeginChild("Found Patterns", ImVec2(0, 150), true);
+                    static const char* kindNames[] = { "Still life", "Oscillator", "Spaceship" };
+                    constexpr int maximumListedPatterns = 1000;
+                    int numberOfListedPatterns = 0;
+                    for (std::size_t result = 0; result < foundPatterns.size(); ++result) {
+                        const FoundPattern& found = foundPatterns[result];
+                        if (searchedKinds != 3 && searchedKinds != static_cast<int>(found.kind))
+                            continue;
+                        if (++numberOfListedPatterns > maximumListedPatterns) {
+                            ImGui::Text("Only the first %d are listed", maximumListedPatterns);
+                            break;
+                        }
+
+                        ImGui::PushID(static_cast<int>(result));
+                        if (ImGui::Button("Load")) {
+                            // Edits still waiting were meant for the cells that were just emptied. The pattern's edits are queued
+                            // with painted ones below, so a pattern larger than the queue is loaded over several frames.
+                            ConwaysGameOfLife.GenerateEmptyCells();
+                            unqueuedEdits.clear();
+                            AddStampEdits(found.cells, (ConwaysGameOfLife.GetWidth() - found.cells.GetWidth()) / 2, (ConwaysGameOfLife.GetHeight() - found.cells.GetHeight()) / 2, unqueuedEdits);
+                        }
+                        ImGui::SameLine();
+                        ImGui::Text("%s, period %d, moves (%d, %d), %d cells, %d x %d, found %llu times", kindNames[static_cast<int>(found.kind)], found.period, found.dx, found.dy,
+                            found.population, found.cells.GetWidth(), found.cells.GetHeight(), static_cast<unsigned long long>(found.numberOfOccurrences));
+                        ImGui::PopID();
+                    }
+                    ImGui::EndChild();
+                }
+
+                isAnimating |= !ConwaysGameOfLife.IsPaused();
+                isAnimating |= !unqueuedEdits.empty();
+
+                const auto GenerateGameOfLife = [&]() {
+                    ConwaysGameOfLifeView.DrawGrid();
+
+                    CellCoordinates strokeFrom {};
+                    CellCoordinates strokeTo {};
+                    bool isErasing = false;
+                    bool isStrokeStart = false;
+                    if (ConwaysGameOfLifeView.GetPaintStroke(strokeFrom, strokeTo, isErasing, isStrokeStart)) {
+                        if (paintMode == 1 && !isErasing) {
+                            if (isStrokeStart)
+                                AddStampEdits(stampPattern, strokeTo.x, strokeTo.y, unqueuedEdits);
+                        } else {
+                            AddBrushEdits(strokeFrom, strokeTo, brushRadius, isErasing ? CellState::inactive : CellState::active, unqueuedEdits);
+                        }
+                    }
+
+                    const std::size_t numberOfQueuedEdits = ConwaysGameOfLife.GetEditQueue().Push(unqueuedEdits.data(), unqueuedEdits.size());
+                    unqueuedEdits.erase(unqueuedEdits.begin(), unqueuedEdits.begin() + static_cast<std::ptrdiff_t>(numberOfQueuedEdits));
+
+                    if (!ConwaysGameOfLife.IsPaused())
+                        ConwaysGameOfLife.SetAllCellStates();
+                    else
+                        ConwaysGameOfLife.ApplyQueuedEdits();
+                    ConwaysGameOfLifeView.DrawCells();
+                };
+
+                if (time_functions) {
+                    // Timing to check the effectiveness of multithreading.
+                    auto timerStart = std::chrono::high_resolution_clock::now();
+
+                    GenerateGameOfLife();
+
+                    auto timerStop = std::chrono::high_resolution_clock::now();
+                    auto timerDuration = timerStop - timerStart;
+                    std::cout << "Game of Life Timing = " << timerDuration.count() / (1'000'000'000.0f) << " seconds" << std::endl;
+                } else {
+                    GenerateGameOfLife();
+                }
+
+                ImGui::EndTabItem();
+            }
+
+            if (ImGui::BeginTabItem("Generations")) {
+                static bool generationsGridSwitch = false;
+                ImGui::Checkbox("Enable Grid", &generationsGridSwitch);
+                generationsAutomataView.EnableGrid(generationsGridSwitch);
+
+                static int generationsWidth = generationsAutomata.GetWidth();
+                static int generationsHeight = generationsAutomata.GetHeight();
+                ImGui::SetNextItemWidth(100);
+                ImGui::InputInt("Width", &generationsWidth, 1, 10);
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(100);
+                ImGui::InputInt("Height", &generationsHeight, 1, 10);
+                if (!generationsAutomata.SetDimensions(generationsWidth, generationsHeight)) {
+                    generationsWidth = generationsAutomata.GetWidth();
+                    generationsHeight = generationsAutomata.GetHeight();
+                }
+
+                // Any Generations rule in B/S/C notation, applied when Enter is pressed.
+                static char generationsRule[32] = "B2/S/C3";
+                ImGui::SetNextItemWidth(100);
+                if (ImGui::InputText("Rule", generationsRule, sizeof(generationsRule), ImGuiInputTextFlags_EnterReturnsTrue)) {
+                    GenerationsRule rule {};
+                    if (GenerationsRule::Parse(generationsRule, rule))
+                        generationsAutomata.SetRule(rule);
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("Brian's Brain"))
+                    generationsAutomata.SetRule(GenerationsRule::BriansBrain());
+                ImGui::SameLine();
+                if (ImGui::Button("Star Wars"))
+                    generationsAutomata.SetRule(GenerationsRule::StarWars());
+                ImGui::SameLine();
+                ImGui::Text("%s", generationsAutomata.GetRule().ToString().c_str());
+
+                if (ImGui::Button("Generate"))
+                    generationsAutomata.GenerateRandomCells();
+                ImGui::SameLine();
+                if (ImGui::Button("Clear"))
+                    generationsAutomata.GenerateEmptyCells();
+
+                static bool isGenerationsPaused = false;
+                ImGui::Checkbox("Pause", &isGenerationsPaused);
+                ImGui::SameLine();
+                ImGui::Text("Generation %llu", static_cast<unsigned long long>(generationsAutomata.GetGeneration()));
+
+                static int generationsGridSteps = 5;
+                ImGui::SetNextItemWidth(100);
+                ImGui::SliderInt("Zoom", &generationsGridSteps, 1, 100);
+                generationsAutomataView.SetGridSteps(generationsGridSteps);
+
+                // Live cells are drawn in this colour, decaying ones in darker shades of it.
+                static ImVec4 generationsColour = { 1.0f, 1.0f, 1.0f, 1.0f };
+                ImGui::SetNextItemWidth(200);
+                ImGui::ColorEdit3("Cell Colour", &generationsColour.x);
+                generationsAutomataView.SetMainCellColour(static_cast<ImColor>(generationsColour));
+
+                isAnimating |= !isGenerationsPaused;
+                if (!isGenerationsPaused)
+                    generationsAutomata.Step();
+
+                generationsAutomataView.DrawGrid();
+                generationsAutomataView.DrawCells();
+
+                ImGui::EndTabItem();
+            }
+
+            if (ImGui::BeginTabItem("Margolus")) {
+                static bool margolusGridSwitch = false;
+                ImGui::Checkbox("Enable Grid", &margolusGridSwitch);
+                margolusAutomataView.EnableGrid(margolusGridSwitch);
+
+                // Rounded down to even dimensions by the universe.
+                static int margolusWidth = margolusAutomata.GetWidth();
+                static int margolusHeight = margolusAutomata.GetHeight();
+                ImGui::SetNextItemWidth(100);
+                ImGui::InputInt("Width", &margolusWidth, 2, 10);
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(100);
+                ImGui::InputInt("Height", &margolusHeight, 2, 10);
+                if (!margolusAutomata.SetDimensions(margolusWidth, margolusHeight)) {
+                    margolusWidth = margolusAutomata.GetWidth();
+                    margolusHeight = margolusAutomata.GetHeight();
+                }
+
+                // Any block rule in MCell's notation, applied when Enter is pressed.
+                static char margolusRule[64] = "MS,D0;8;4;3;2;5;9;7;1;6;10;11;12;13;14;15";
+                ImGui::SetNextItemWidth(300);
+                if (ImGui::InputText("Rule", margolusRule, sizeof(margolusRule), ImGuiInputTextFlags_EnterReturnsTrue)) {
+                    MargolusRule rule {};
+                    if (MargolusRule::Parse(margolusRule, rule))
+                        margolusAutomata.SetRule(rule);
+                }
+                ImGui::SameLine();
+                if (ImGui::Button("Billiard Ball"))
+                    margolusAutomata.SetRule(MargolusRule::BilliardBall());
+                ImGui::SameLine();
+                if (ImGui::Button("Critters"))
+                    margolusAutomata.SetRule(MargolusRule::Critters());
+                ImGui::SameLine();
+                if (ImGui::Button("Tron"))
+                    margolusAutomata.SetRule(MargolusRule::Tron());
+                ImGui::Text("%s (%s)", margolusAutomata.GetRule().ToString().c_str(), margolusAutomata.IsReversible() ? "reversible" : "irreversible");
+
+                if (ImGui::Button("Generate"))
+                    margolusAutomata.GenerateRandomCells();
+                ImGui::SameLine();
+                if (ImGui::Button("Clear"))
+                    margolusAutomata.GenerateEmptyCells();
+
+                // Running backwards steps back a generation every frame, which only reversible rules can.
+                static bool isMargolusPaused = false;
+                static bool isMargolusReversed = false;
+                ImGui::Checkbox("Pause", &isMargolusPaused);
+                ImGui::SameLine();
+                ImGui::Checkbox("Reverse", &isMargolusReversed);
+                ImGui::SameLine();
+                if (ImGui::Button("Step Back"))
+                    margolusAutomata.StepBack();
+                ImGui::SameLine();
+                if (ImGui::Button("Step"))
+                    margolusAutomata.Step();
+                ImGui::SameLine();
+                ImGui::Text("Generation %lld", static_cast<long long>(margolusAutomata.GetGeneration()));
+
+                static int margolusGridSteps = 5;
+                ImGui::SetNextItemWidth(100);
+                ImGui::SliderInt("Zoom", &margolusGridSteps, 1, 100);
+                margolusAutomataView.SetGridSteps(margolusGridSteps);
+
+                static ImVec4 margolusColour = { 1.0f, 1.0f, 1.0f, 1.0f };
+                ImGui::SetNextItemWidth(200);
+                ImGui::ColorEdit3("Cell Colour", &margolusColour.x);
+                margolusAutomataView.SetMainCellColour(static_cast<ImColor>(margolusColour));
+
+                const bool isMargolusRunning = !isMargolusPaused && (!isMargolusReversed || margolusAutomata.IsReversible());
+                isAnimating |= isMargolusRunning;
+                if (isMargolusRunning) {
+                    if (isMargolusReversed)
+                        margolusAutomata.StepBack();
+                    else
+                        margolusAutomata.Step();
+                }
+
+                margolusAutomataView.DrawGrid();
+                margolusAutomataView.DrawCells();
+
+                ImGui::EndTabItem();
+            }
+
+            if (ImGui::BeginTabItem("Elementary Cellular Automata")) {
+                auto& ElementaryCellularAutomataRuleset = elementaryAutomata.SetRuleset();
+
+                static int nCellsPerGeneration = elementaryAutomata.GetNumberOfCellsPerGeneration();
+                static int nGenerations = elementaryAutomata.GetNumberOfGenerations();
+
+                if (nCellsPerGeneration < 0)
+                    nCellsPerGeneration = 0;
+                if (nGenerations < 0)
+                    nGenerations = 0;
+
+                ImGui::SetNextItemWidth(100);
+                ImGui::InputInt("Cells Per Generation", &nCellsPerGeneration);
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(100);
+                ImGui::InputInt("Number of Generations", &nGenerations);
+
+                if (!elementaryAutomata.SetNumberOfCellsPerGeneration(nCellsPerGeneration))
+                    nCellsPerGeneration = elementaryAutomata.GetNumberOfCellsPerGeneration();
+                if (!elementaryAutomata.SetNumberOfGenerations(nGenerations))
+                    nGenerations = elementaryAutomata.GetNumberOfGenerations();
+
+                // Can't pass individual bits by reference, therefore the following repeated code is a necessary evil,
+                // unless a workaround is implemented to make a vector<bool> act like a regular STL container.
+                // Note vector<bool> is not individually addressable because of its special implementation. (https://en.cppreference.com/w/cpp/container/vector_bool)
+                // Not worth the trouble in my opinion...
+                static bool rulesetPosition_0 = ElementaryCellularAutomataRuleset[0];
+                static bool rulesetPosition_1 = ElementaryCellularAutomataRuleset[1];
+                static bool rulesetPosition_2 = ElementaryCellularAutomataRuleset[2];
+                static bool rulesetPosition_3 = ElementaryCellularAutomataRuleset[3];
+                static bool rulesetPosition_4 = ElementaryCellularAutomataRuleset[4];
+                static bool rulesetPosition_5 = ElementaryCellularAutomataRuleset[5];
+                static bool rulesetPosition_6 = ElementaryCellularAutomataRuleset[6];
+                static bool rulesetPosition_7 = ElementaryCellularAutomataRuleset[7];
+
+                ImGui::Checkbox("##0", &rulesetPosition_0);
+                ImGui::SameLine();
+                ImGui::Checkbox("##1", &rulesetPosition_1);
+                ImGui::SameLine();
+                ImGui::Checkbox("##2", &rulesetPosition_2);
+                ImGui::SameLine();
+                ImGui::Checkbox("##3", &rulesetPosition_3);
+                ImGui::SameLine();
+                ImGui::Checkbox("##4", &rulesetPosition_4);
+                ImGui::SameLine();
+                ImGui::Checkbox("##5", &rulesetPosition_5);
+                ImGui::SameLine();
+                ImGui::Checkbox("##6", &rulesetPosition_6);
+                ImGui::SameLine();
+                ImGui::Checkbox("##7", &rulesetPosition_7);
+
+                ElementaryCellularAutomataRuleset[0] = rulesetPosition_0;
+                ElementaryCellularAutomataRuleset[1] = rulesetPosition_1;
+                ElementaryCellularAutomataRuleset[2] = rulesetPosition_2;
+                ElementaryCellularAutomataRuleset[3] = rulesetPosition_3;
+                ElementaryCellularAutomataRuleset[4] = rulesetPosition_4;
+                ElementaryCellularAutomataRuleset[5] = rulesetPosition_5;
+                ElementaryCellularAutomataRuleset[6] = rulesetPosition_6;
+                ElementaryCellularAutomataRuleset[7] = rulesetPosition_7;
+
+                // Bitset is read in reverse order.
+                std::string rulesetReversedString = ElementaryCellularAutomataRuleset.to_string();
+                std::reverse(rulesetReversedString.begin(), rulesetReversedString.end());
+
+                const std::string rulesetText = "Current Ruleset = " + rulesetReversedString;
+
+                ImGui::Text(rulesetText.c_str());
+
+                // Additive rules can jump straight to any generation, so the diagram can start much later than generation 0.
+                static ImU64 startingGeneration = elementaryAutomata.GetStartingGeneration();
+                if (elementaryAutomata.IsAdditiveRule()) {
+                    const ImU64 minimumStartingGeneration = 0;
+                    const ImU64 maximumStartingGeneration = Elementary::maximumStartingGeneration;
+
+                    ImGui::SetNextItemWidth(200);
+                    ImGui::InputScalar("Starting Generation", ImGuiDataType_U64, &startingGeneration);
+                    startingGeneration = std::clamp(startingGeneration, minimumStartingGeneration, maximumStartingGeneration);
+                    elementaryAutomata.SetStartingGeneration(startingGeneration);
+                } else {
+                    ImGui::Text("Rule %d is not additive, so the diagram starts at generation 0.", elementaryAutomata.GetRuleNumber());
+                }
+
+                // The diagram follows every edit to the rule or size, and is computed in the background.
+                elementaryAutomata.UpdatePreview();
+                if (elementaryAutomata.IsPreviewRunning()) {
+                    isAnimating = true;
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::ProgressBar(elementaryAutomata.GetPreviewProgress(), ImVec2(100, 0));
+                } else {
+                    ImGui::Text("Up to date");
+                }
+
+                // Previously generated diagrams are kept so switching back to them is instant.
+                auto& diagramCache = elementaryAutomata.GetDiagramCache();
+                static int diagramCacheCapMB = static_cast<int>(diagramCache.GetMemoryCap() / (1024 * 1024));
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(100);
+                ImGui::SliderInt("Cache Size (MB)", &diagramCacheCapMB, 1, 1024);
+                diagramCache.SetMemoryCap(static_cast<std::size_t>(diagramCacheCapMB) * 1024 * 1024);
+                ImGui::SameLine();
+                ImGui::Text("Cached Diagrams = %d (%.2f MB)", static_cast<int>(diagramCache.GetNumberOfDiagrams()), diagramCache.GetMemoryUsage() / (1024.0f * 1024.0f));
+
+                // Diagrams too large for memory are generated into a file, and only the part on screen is read back from it.
+                static bool showDiagramFile = false;
+                if (DiagramFile::IsSupported() && ImGui::CollapsingHeader("Diagram File")) {
+                    static char diagramFilePath[256] = "elementary-diagram.eca";
+                    static int fileCellsPerGeneration = 1'000'000;
+                    static ImU64 fileGenerations = 1'000'000;
+                    static bool isFileCompressed = false;
+
+                    ImGui::SetNextItemWidth(300);
+                    ImGui::InputText("Path", diagramFilePath, sizeof(diagramFilePath));
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::InputInt("Cells Per Generation", &fileCellsPerGeneration, 1000, 100000);
+                    fileCellsPerGeneration = std::max(fileCellsPerGeneration, 1);
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(100);
+                    ImGui::InputScalar("File Generations", ImGuiDataType_U64, &fileGenerations);
+                    fileGenerations = std::max<ImU64>(fileGenerations, 1);
+                    ImGui::SameLine();
+                    ImGui::Checkbox("Compressed", &isFileCompressed);
+
+                    if (ImGui::Button("Generate To File")) {
+                        showDiagramFile = elementaryAutomata.CreateDiagramFile(elementaryDiagramFile, diagramFilePath, fileCellsPerGeneration, fileGenerations, isFileCompressed)
+                            && elementaryDiagramFile.StartGenerating();
+                    }
+                    ImGui::SameLine();
+                    if (ImGui::Button("Open File"))
+                        showDiagramFile = elementaryDiagramFile.Open(diagramFilePath);
+
+                    if (elementaryDiagramFile.IsOpen()) {
+                        const std::uint64_t completedGenerations = elementaryDiagramFile.GetNumberOfCompletedGenerations();
+                        const std::uint64_t numberOfGenerations = elementaryDiagramFile.GetNumberOfGenerations();
+
+                        ImGui::SameLine();
+                        if (elementaryDiagramFile.IsGenerating()) {
+                            isAnimating = true;
+                            if (ImGui::Button("Stop"))
+                                elementaryDiagramFile.StopGenerating();
+                        } else if (completedGenerations < numberOfGenerations) {
+                            if (ImGui::Button("Resume"))
+                                elementaryDiagramFile.StartGenerating();
+                        }
+
+                        ImGui::SetNextItemWidth(100);
+                        ImGui::ProgressBar(static_cast<float>(completedGenerations) / numberOfGenerations, ImVec2(100, 0));
+                        ImGui::SameLine();
+                        ImGui::Text("Rule %d, %d cells by %llu generations, %.2f GB on disk, %.0f MB/s", elementaryDiagramFile.GetRuleNumber(),
+                            elementaryDiagramFile.GetNumberOfCellsPerGeneration(), static_cast<unsigned long long>(numberOfGenerations),
+                            elementaryDiagramFile.GetFileSize() / (1024.0 * 1024.0 * 1024.0), elementaryDiagramFile.GetGenerationRate() / (1024.0 * 1024.0));
+
+                        ImGui::Checkbox("Show Diagram File", &showDiagramFile);
+                        ImGui::SameLine();
+                        static int diagramFileZoom = 1;
+                        ImGui::SetNextItemWidth(100);
+                        ImGui::SliderInt("File Zoom", &diagramFileZoom, 1, 100);
+                        elementaryDiagramFileView.SetGridSteps(diagramFileZoom);
+
+                        static int goToPosition = 0;
+                        static int goToGeneration = 0;
+                        ImGui::SetNextItemWidth(100);
+                        ImGui::InputInt("Position", &goToPosition, 1000, 100000);
+                        ImGui::SameLine();
+                        ImGui::SetNextItemWidth(100);
+                        ImGui::InputInt("Generation", &goToGeneration, 1000, 100000);
+                        ImGui::SameLine();
+                        if (ImGui::Button("Go To"))
+                            elementaryDiagramFileView.ScrollTo(goToPosition, goToGeneration);
+                    }
+                }
+
+                if (showDiagramFile && elementaryDiagramFile.IsOpen()) {
+                    elementaryDiagramFileView.DrawGrid();
+                    elementaryDiagramFileView.DrawCells();
+                } else {
+                    elementaryAutomataView.DrawGrid();
+                    elementaryAutomataView.DrawCells();
+                }
+
+                ImGui::EndTabItem();
+            }
+
+            ImGui::EndTabBar();
+            ImGui::End();
+        }
+
+        // Rendering.
+        ImGui::Render();
+        int display_w, display_h;
+        glfwGetFramebufferSize(window, &display_w, &display_h);
+        glViewport(0, 0, display_w, display_h);
+        glClearColor(clear_color.x, clear_color.y, clear_color.z, clear_color.w);
+        glClear(GL_COLOR_BUFFER_BIT);
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+        glfwSwapBuffers(window);
+    }
+
+    // Cleanup.
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui_ImplGlfw_Shutdown();
+    ImGui::DestroyContext();
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+
+    return 0;
+}
\ No newline at end of file
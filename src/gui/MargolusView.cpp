@@ -0,0 +1,21 @@
+#include "MargolusView.h"
+
+MargolusView::MargolusView(const Margolus& margolus)
+    : m_margolus(margolus)
+{
+}
+
+void MargolusView::DrawCells()
+{
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+
+    const ImVec2 origin = ImVec2(m_min_canvas_position.x + m_grid_scrolling.x, m_min_canvas_position.y + m_grid_scrolling.y);
+
+    draw_list->PushClipRect(m_min_canvas_position, m_max_canvas_position, true);
+    draw_list->AddRect(origin, ImVec2(origin.x + (m_margolus.GetWidth() * m_grid_steps), origin.y + (m_margolus.GetHeight() * m_grid_steps)), IM_COL32(200, 200, 200, 255));
+
+    const PackedCells& cells = m_margolus.GetCells();
+    DrawPackedLayers({ cells.GetWords().data() }, { m_cell_colour_main }, cells.GetWordsPerRow(), m_margolus.GetHeight(), m_margolus.GetCellsVersion());
+
+    draw_list->PopClipRect();
+}
@@ -0,0 +1,39 @@
+/*
+* Serves a Game of Life universe on a Unix domain socket, see SimulationService for the protocol.
+* Usage: cellular-automata-service <socket path>
+*/
+
+#include <csignal>
+#include <cstdio>
+
+#include "SimulationService.h"
+
+// Lets Ctrl+C and service managers stop the service cleanly, which removes its socket.
+static SimulationService* servedSimulation = nullptr;
+
+static void stop_service_signal_handler(int)
+{
+    if (servedSimulation != nullptr)
+        servedSimulation->Stop();
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || !SimulationService::IsSupported()) {
+        fprintf(stderr, "Usage: %s <socket path>, only supported on Linux\n", argv[0]);
+        return 1;
+    }
+
+    SimulationService simulationService;
+    servedSimulation = &simulationService;
+    std::signal(SIGINT, stop_service_signal_handler);
+    std::signal(SIGTERM, stop_service_signal_handler);
+
+    const bool isServed = simulationService.Run(argv[1]);
+    servedSimulation = nullptr;
+    if (!isServed) {
+        fprintf(stderr, "Couldn't listen on %s\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*
+* Checks that jumping ahead to a generation of an additive elementary rule, which applies one step per set bit of the generation,
+* gives the same cells as stepping there one generation at a time.
+* Usage: elementary-test, returns 0 if every generation matches.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "Elementary.h"
+
+// Every width up to a little past half a word, so that both the mirrored and the one-sided edges are checked for odd and even widths.
+static constexpr int maximumNumberOfCellsPerGeneration = 37;
+static constexpr std::uint64_t maximumGeneration = 300;
+
+// One generation of a Wolfram rule, cells outside the generation are inactive.
+static std::vector<CellState> step_generation(const std::vector<CellState>& generation, int ruleNumber)
+{
+    const int width = static_cast<int>(generation.size());
+    const auto isActive = [&](int position) {
+        return position >= 0 && position < width && generation[position] == CellState::active;
+    };
+
+    std::vector<CellState> nextGeneration(width);
+    for (int position = 0; position < width; ++position) {
+        const int neighbourhood = (isActive(position - 1) << 2) | (isActive(position) << 1) | isActive(position + 1);
+        nextGeneration[position] = static_cast<CellState>((ruleNumber >> neighbourhood) & 1);
+    }
+
+    return nextGeneration;
+}
+
+int main()
+{
+    Elementary elementary;
+    int numberOfAdditiveRules = 0;
+    int numberOfMismatches = 0;
+
+    for (int ruleNumber = 0; ruleNumber < 256; ++ruleNumber) {
+        for (int neighbourhood = 0; neighbourhood < 8; ++neighbourhood) {
+            elementary.SetRuleset().set(7 - neighbourhood, (ruleNumber >> neighbourhood) & 1);
+        }
+
+        // Other rules are stepped one generation at a time anyway.
+        if (!elementary.IsAdditiveRule())
+            continue;
+
+        ++numberOfAdditiveRules;
+        for (int width = 1; width <= maximumNumberOfCellsPerGeneration; ++width) {
+            elementary.SetNumberOfCellsPerGeneration(width);
+
+            std::vector<CellState> generation(width, CellState::inactive);
+            generation[width / 2] = CellState::active;
+
+            for (std::uint64_t generationNumber = 0; generationNumber <= maximumGeneration; ++generationNumber) {
+                if (elementary.ComputeGeneration(generationNumber) != generation) {
+                    if (numberOfMismatches == 0)
+                        fprintf(stderr, "Rule %d with %d cells differs at generation %llu\n", ruleNumber, width, static_cast<unsigned long long>(generationNumber));
+                    ++numberOfMismatches;
+                }
+
+                generation = step_generation(generation, ruleNumber);
+            }
+        }
+    }
+
+    // 16 rules are additive: every combination of the left, centre and right cells, and their complements.
+    if (numberOfAdditiveRules != 16) {
+        fprintf(stderr, "Found %d additive rules instead of 16\n", numberOfAdditiveRules);
+        return 1;
+    }
+
+    if (numberOfMismatches > 0) {
+        fprintf(stderr, "%d generations differ\n", numberOfMismatches);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,158 @@
+/*
+* Checks that every Game of Life engine, and temporally blocked stepping with and without a worker pool, give the same cells
+* as counting each cell's neighbours one at a time, for random soups whose widths and heights don't fill whole words or tiles.
+* Usage: life-engines-test, returns 0 if every engine matches.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "LifeEngines.h"
+
+// Widths around word boundaries, and heights around the tile heights of small caches.
+static constexpr int widths[] = { 1, 63, 65, 130, 257 };
+static constexpr int heights[] = { 1, 3, 67, 129, 201 };
+static constexpr const char* rules[] = { "B3/S23", "B36/S23", "B2/S", "B3678/S34678" };
+// More than the deepest ghost zones, so that temporal blocking steps more than one block.
+static constexpr int numberOfGenerations = 70;
+// Too big to count neighbours one cell at a time, but two tiles across and several tiles down for caches up to 2 MB,
+// so the engines that tile or band the universe are checked against the bit-parallel engine here.
+static constexpr int largeWidth = 1089;
+static constexpr int largeHeight = 8191;
+
+// One generation of a life-like rule, cells outside the universe are inactive.
+static PackedCells step_generation(const PackedCells& cells, const LifeRule& rule)
+{
+    const int width = cells.GetWidth();
+    const int height = cells.GetHeight();
+    const auto isActive = [&](int x, int y) {
+        return x >= 0 && x < width && y >= 0 && y < height && cells.GetCellState(x, y) == CellState::active;
+    };
+
+    PackedCells nextCells(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int numberOfNeighbours = 0;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    numberOfNeighbours += (dx != 0 || dy != 0) && isActive(x + dx, y + dy);
+                }
+            }
+
+            const std::uint16_t neighbourCounts = isActive(x, y) ? rule.survival : rule.birth;
+            if ((neighbourCounts >> numberOfNeighbours) & 1)
+                nextCells.SetCellState(x, y, CellState::active);
+        }
+    }
+
+    return nextCells;
+}
+
+static PackedCells make_soup(int width, int height, std::mt19937& randomNumbers)
+{
+    PackedCells soup(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (randomNumbers() & 1)
+                soup.SetCellState(x, y, CellState::active);
+        }
+    }
+
+    return soup;
+}
+
+static bool is_equal(const PackedCells& cells, const PackedCells& expectedCells)
+{
+    for (int y = 0; y < cells.GetHeight(); ++y) {
+        for (int x = 0; x < cells.GetWidth(); ++x) {
+            if (cells.GetCellState(x, y) != expectedCells.GetCellState(x, y))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+int main()
+{
+    std::vector<std::unique_ptr<LifeEngine>> engines = CreateLifeEngines();
+    // More threads than tiles or bands in the smaller universes, to check that the pool copes with chunks left idle.
+    WorkerPool workerPool(4);
+    std::mt19937 randomNumbers(2024);
+    int numberOfMismatches = 0;
+
+    const auto check = [&](const char* name, const PackedCells& cells, const PackedCells& expectedCells, const char* ruleString) {
+        if (is_equal(cells, expectedCells))
+            return;
+
+        if (numberOfMismatches == 0)
+            fprintf(stderr, "%s differs with %d by %d cells and rule %s\n", name, cells.GetWidth(), cells.GetHeight(), ruleString);
+        ++numberOfMismatches;
+    };
+
+    for (const char* ruleString : rules) {
+        LifeRule rule;
+        if (!LifeRule::Parse(ruleString, rule)) {
+            fprintf(stderr, "Couldn't parse rule %s\n", ruleString);
+            return 1;
+        }
+
+        for (int width : widths) {
+            for (int height : heights) {
+                const PackedCells soup = make_soup(width, height, randomNumbers);
+                PackedCells expectedCells = soup;
+                for (int generation = 0; generation < numberOfGenerations; ++generation) {
+                    expectedCells = step_generation(expectedCells, rule);
+                }
+
+                for (const auto& engine : engines) {
+                    PackedCells cells = soup;
+                    PackedCells scratch(width, height);
+                    engine->Step(cells, scratch, numberOfGenerations, rule);
+                    check(engine->GetName(), cells, expectedCells, ruleString);
+                }
+
+                PackedCells cells = soup;
+                PackedCells scratch(width, height);
+                StepLifeGenerationsBlocked(cells, scratch, numberOfGenerations, rule);
+                check("Blocked stepping without a pool", cells, expectedCells, ruleString);
+
+                cells = soup;
+                StepLifeGenerationsBlocked(cells, scratch, numberOfGenerations, rule, &workerPool);
+                check("Blocked stepping with a pool", cells, expectedCells, ruleString);
+            }
+        }
+
+        const PackedCells soup = make_soup(largeWidth, largeHeight, randomNumbers);
+        PackedCells expectedCells = soup;
+        PackedCells scratch(largeWidth, largeHeight);
+        for (int generation = 0; generation < numberOfGenerations; ++generation) {
+            StepLifeRows(expectedCells.GetWords().data(), scratch.GetWords().data(), expectedCells.GetWordsPerRow(), largeHeight,
+                expectedCells.GetLastWordMask(), 0, largeHeight, rule);
+            std::swap(expectedCells, scratch);
+        }
+
+        for (const auto& engine : engines) {
+            if (std::strcmp(engine->GetName(), "Threaded Bit-Parallel") != 0 && std::strcmp(engine->GetName(), "Temporally Blocked") != 0)
+                continue;
+
+            PackedCells cells = soup;
+            engine->Step(cells, scratch, numberOfGenerations, rule);
+            check(engine->GetName(), cells, expectedCells, ruleString);
+        }
+
+        PackedCells cells = soup;
+        StepLifeGenerationsBlocked(cells, scratch, numberOfGenerations, rule);
+        check("Blocked stepping without a pool", cells, expectedCells, ruleString);
+    }
+
+    if (numberOfMismatches > 0) {
+        fprintf(stderr, "%d engines differ\n", numberOfMismatches);
+        return 1;
+    }
+
+    return 0;
+}